@@ -0,0 +1,169 @@
+#include "FramePipeline.h"
+
+#include <chrono>
+#include <thread>
+
+namespace
+{
+	//--------------------------------------------------------------
+	double getSeconds(std::chrono::steady_clock::time_point start)
+	{
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+}
+
+//--------------------------------------------------------------
+void FramePipeline::FrameQueue::push(Frame * frame)
+{
+	{
+		std::unique_lock<std::mutex> lock(this->mutex);
+		this->frames.push_back(frame);
+	}
+	this->condition.notify_one();
+}
+
+//--------------------------------------------------------------
+bool FramePipeline::FrameQueue::pop(Frame *& frame)
+{
+	std::unique_lock<std::mutex> lock(this->mutex);
+	this->condition.wait(lock, [this]
+	{
+		return (!this->frames.empty() || this->closed);
+	});
+	if (this->frames.empty()) return false;
+
+	frame = this->frames.front();
+	this->frames.pop_front();
+	return true;
+}
+
+//--------------------------------------------------------------
+void FramePipeline::FrameQueue::close()
+{
+	{
+		std::unique_lock<std::mutex> lock(this->mutex);
+		this->closed = true;
+	}
+	this->condition.notify_all();
+}
+
+//--------------------------------------------------------------
+void FramePipeline::FrameQueue::reset()
+{
+	std::unique_lock<std::mutex> lock(this->mutex);
+	this->frames.clear();
+	this->closed = false;
+}
+
+//--------------------------------------------------------------
+FramePipeline::FramePipeline(size_t numBuffers)
+{
+	for (size_t i = 0; i < std::max(numBuffers, (size_t)1); ++i)
+	{
+		this->buffers.push_back(std::make_unique<Frame>());
+	}
+}
+
+//--------------------------------------------------------------
+bool FramePipeline::run(const std::vector<std::string> & inputPaths, const std::vector<std::string> & outputPaths, const std::vector<std::shared_ptr<ofxWarp::WarpBase>> & warps, size_t width, size_t height)
+{
+	this->stats = Stats();
+	this->stats.numFrames = inputPaths.size();
+
+	this->freeQueue.reset();
+	this->warpQueue.reset();
+	this->writeQueue.reset();
+	for (auto & buffer : this->buffers)
+	{
+		this->freeQueue.push(buffer.get());
+	}
+
+	auto start = std::chrono::steady_clock::now();
+
+	// Read into free buffers, waiting while all of them are further down the pipeline.
+	std::thread reader([&]
+	{
+		for (size_t i = 0; i < inputPaths.size(); ++i)
+		{
+			Frame * frame;
+			if (!this->freeQueue.pop(frame)) break;
+
+			auto readStart = std::chrono::steady_clock::now();
+			frame->index = i;
+			frame->valid = ofLoadImage(frame->content, inputPaths[i]);
+			if (!frame->valid)
+			{
+				ofLogError("FramePipeline::run") << "Could not read " << inputPaths[i];
+			}
+			else if (frame->content.getNumChannels() != 3 && frame->content.getNumChannels() != 4)
+			{
+				frame->content.setImageType(OF_IMAGE_COLOR);
+			}
+			this->stats.readTime += getSeconds(readStart);
+
+			this->warpQueue.push(frame);
+		}
+		this->warpQueue.close();
+	});
+
+	// Write finished frames and hand their buffers back to the reader.
+	std::thread writer([&]
+	{
+		Frame * frame;
+		while (this->writeQueue.pop(frame))
+		{
+			auto writeStart = std::chrono::steady_clock::now();
+			if (frame->valid)
+			{
+				frame->encoded = frame->output;
+				frame->valid = ofSaveImage(frame->encoded, outputPaths[frame->index]);
+				if (!frame->valid)
+				{
+					ofLogError("FramePipeline::run") << "Could not write " << outputPaths[frame->index];
+				}
+			}
+			if (!frame->valid)
+			{
+				++this->stats.numFailed;
+			}
+			this->stats.writeTime += getSeconds(writeStart);
+
+			this->freeQueue.push(frame);
+		}
+	});
+
+	// Warp on this thread, the renderer spreads each frame over the shared thread pool.
+	Frame * frame;
+	while (this->warpQueue.pop(frame))
+	{
+		auto warpStart = std::chrono::steady_clock::now();
+		if (frame->valid)
+		{
+			if (frame->output.getWidth() != width || frame->output.getHeight() != height)
+			{
+				frame->output.allocate(width, height, OF_PIXELS_RGB);
+			}
+
+			// Projectors show black where no warp draws.
+			frame->output.set(0.0f);
+			frame->valid = this->renderer.draw(warps, frame->content, frame->output);
+		}
+		this->stats.warpTime += getSeconds(warpStart);
+
+		this->writeQueue.push(frame);
+	}
+	this->writeQueue.close();
+
+	reader.join();
+	writer.join();
+
+	this->stats.totalTime = getSeconds(start);
+
+	return (this->stats.numFailed == 0);
+}
+
+//--------------------------------------------------------------
+const FramePipeline::Stats & FramePipeline::getStats() const
+{
+	return this->stats;
+}
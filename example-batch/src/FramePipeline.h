@@ -0,0 +1,72 @@
+#pragma once
+
+#include "ofMain.h"
+#include "ofxWarp.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+//! Warps a sequence of images on the CPU as three stages running on their own threads: read, warp and write.
+//! Frames travel between the stages through a fixed pool of buffers, so at most that many frames are in memory,
+//! and a stage that runs ahead waits for a free buffer instead of allocating one.
+class FramePipeline
+{
+public:
+	struct Stats
+	{
+		size_t numFrames = 0;
+		size_t numFailed = 0;
+		//! time each stage spent working, in seconds
+		double readTime = 0.0;
+		double warpTime = 0.0;
+		double writeTime = 0.0;
+		//! time from the first read to the last write, in seconds
+		double totalTime = 0.0;
+	};
+
+	//! use the specified number of frame buffers, at least one per stage is needed for the stages to overlap
+	FramePipeline(size_t numBuffers);
+
+	//! read each input image, draw the warps over black into an output of width * height pixels, and write it
+	//! to the matching output path, return false if any frame failed
+	bool run(const std::vector<std::string> & inputPaths, const std::vector<std::string> & outputPaths, const std::vector<std::shared_ptr<ofxWarp::WarpBase>> & warps, size_t width, size_t height);
+
+	const Stats & getStats() const;
+
+protected:
+	struct Frame
+	{
+		size_t index = 0;
+		bool valid = false;
+		ofFloatPixels content;
+		ofFloatPixels output;
+		ofPixels encoded;
+	};
+
+	//! Blocking queue of frames handed from one stage to the next.
+	class FrameQueue
+	{
+	public:
+		void push(Frame * frame);
+		//! wait for a frame, return false once the queue is closed and empty
+		bool pop(Frame *& frame);
+		//! wake up the consumer once the remaining frames are taken
+		void close();
+		void reset();
+
+	protected:
+		std::deque<Frame *> frames;
+		std::mutex mutex;
+		std::condition_variable condition;
+		bool closed = false;
+	};
+
+	std::vector<std::unique_ptr<Frame>> buffers;
+	FrameQueue freeQueue;
+	FrameQueue warpQueue;
+	FrameQueue writeQueue;
+
+	ofxWarp::SoftwareRenderer renderer;
+	Stats stats;
+};
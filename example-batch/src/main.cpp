@@ -0,0 +1,38 @@
+#include "ofMain.h"
+#include "ofAppNoWindow.h"
+#include "ofApp.h"
+
+//========================================================================
+int main(int argc, char * argv[])
+{
+	// A width needs a height, and sizes that don't parse come back as 0.
+	auto app = std::make_unique<ofApp>();
+	if (argc > 5)
+	{
+		app->width = ofToInt(argv[4]);
+		app->height = ofToInt(argv[5]);
+	}
+	if (argc > 6)
+	{
+		app->numBuffers = ofToInt(argv[6]);
+	}
+	if (argc < 4 || argc == 5 || app->width <= 0 || app->height <= 0 || app->numBuffers <= 0)
+	{
+		std::cout << "usage: example-batch settings input-folder output-folder [width height] [buffers] [extension]" << std::endl;
+		return 1;
+	}
+
+	app->settingsPath = argv[1];
+	app->inputPath = argv[2];
+	app->outputPath = argv[3];
+	if (argc > 7)
+	{
+		app->extension = argv[7];
+	}
+
+	// Run headless, the frames are warped on the CPU.
+	auto window = std::make_shared<ofAppNoWindow>();
+	ofSetupOpenGL(window, app->width, app->height, OF_WINDOW);
+
+	ofRunApp(app.release());
+}
@@ -0,0 +1,60 @@
+#include "ofApp.h"
+
+//--------------------------------------------------------------
+void ofApp::setup()
+{
+	ofSetLogLevel(OF_LOG_NOTICE);
+
+	if (!this->warpController.loadSettings(this->settingsPath))
+	{
+		ofLogError("ofApp::setup") << "Could not load warp settings from " << this->settingsPath;
+		ofExit(1);
+		return;
+	}
+
+	// The control points are normalized, so the warps fit any output size.
+	auto & warps = this->warpController.getWarps();
+	for (auto & warp : warps)
+	{
+		warp->handleWindowResize(this->width, this->height);
+	}
+
+	// Frames are warped in file name order.
+	ofDirectory input(this->inputPath);
+	input.allowExt("png");
+	input.allowExt("jpg");
+	input.allowExt("jpeg");
+	input.allowExt("tif");
+	input.allowExt("tiff");
+	input.allowExt("bmp");
+	input.allowExt("exr");
+	input.listDir();
+	input.sort();
+	if (input.size() == 0)
+	{
+		ofLogError("ofApp::setup") << "No images found in " << this->inputPath;
+		ofExit(1);
+		return;
+	}
+
+	ofDirectory::createDirectory(this->outputPath, true, true);
+
+	std::vector<std::string> inputPaths;
+	std::vector<std::string> outputPaths;
+	for (size_t i = 0; i < input.size(); ++i)
+	{
+		inputPaths.push_back(input.getPath(i));
+		outputPaths.push_back(ofFilePath::join(this->outputPath, ofFilePath::getBaseName(input.getName(i)) + "." + this->extension));
+	}
+
+	FramePipeline pipeline(this->numBuffers);
+	auto success = pipeline.run(inputPaths, outputPaths, warps, this->width, this->height);
+
+	// A run can finish faster than the clock resolution.
+	const auto & stats = pipeline.getStats();
+	auto framesPerSecond = (stats.totalTime > 0.0) ? (stats.numFrames / stats.totalTime) : 0.0;
+	ofLogNotice("ofApp::setup") << "Warped " << (stats.numFrames - stats.numFailed) << " of " << stats.numFrames << " frames in " << stats.totalTime << " s ("
+		<< framesPerSecond << " fps), read " << stats.readTime << " s, warp " << stats.warpTime << " s, write " << stats.writeTime << " s";
+
+	ofExit(success ? 0 : 1);
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "ofMain.h"
+#include "ofxWarp.h"
+
+#include "FramePipeline.h"
+
+class ofApp
+	: public ofBaseApp
+{
+public:
+	void setup();
+
+	std::string settingsPath;
+	std::string inputPath;
+	std::string outputPath;
+	int width = 1920;
+	int height = 1080;
+	int numBuffers = 4;
+	std::string extension = "png";
+
+	ofxWarp::Controller warpController;
+};
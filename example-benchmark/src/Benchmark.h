@@ -0,0 +1,72 @@
+#pragma once
+
+#include "ofMain.h"
+
+#include <chrono>
+
+//! Minimal timing harness that collects results as machine-readable json.
+class Benchmark
+{
+public:
+	Benchmark()
+	{
+		this->results["benchmarks"] = nlohmann::json::array();
+	}
+
+	//! run the function once to warm up, then time it over the specified number of iterations
+	template<typename Function>
+	void run(const std::string & name, const nlohmann::json & params, size_t iterations, Function function)
+	{
+		function();
+
+		std::vector<double> samples;
+		samples.reserve(iterations);
+		for (size_t i = 0; i < iterations; ++i)
+		{
+			auto start = std::chrono::high_resolution_clock::now();
+			function();
+			auto stop = std::chrono::high_resolution_clock::now();
+			samples.push_back(std::chrono::duration<double, std::micro>(stop - start).count());
+		}
+
+		std::sort(samples.begin(), samples.end());
+		auto total = std::accumulate(samples.begin(), samples.end(), 0.0);
+
+		nlohmann::json result;
+		result["name"] = name;
+		result["params"] = params;
+		result["iterations"] = iterations;
+		result["mean_us"] = total / samples.size();
+		result["median_us"] = samples[samples.size() / 2];
+		result["min_us"] = samples.front();
+		result["max_us"] = samples.back();
+		this->results["benchmarks"].push_back(result);
+
+		ofLogNotice("Benchmark") << name << " " << params.dump() << ": " << result["mean_us"].get<double>() << " us";
+	}
+
+	//! return all results collected so far
+	nlohmann::json & getResults()
+	{
+		return this->results;
+	}
+
+	//! write the results to a json file
+	bool save(const std::string & filePath) const
+	{
+		ofFilePath::createEnclosingDirectory(filePath);
+
+		auto file = ofFile(filePath, ofFile::WriteOnly);
+		if (!file.is_open())
+		{
+			ofLogError("Benchmark::save") << "Could not write to " << filePath;
+			return false;
+		}
+		file << this->results.dump(4);
+
+		return true;
+	}
+
+protected:
+	nlohmann::json results;
+};
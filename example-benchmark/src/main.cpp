@@ -0,0 +1,18 @@
+#include "ofMain.h"
+#include "ofAppNoWindow.h"
+#include "ofApp.h"
+
+//========================================================================
+int main(int argc, char * argv[])
+{
+	// Run headless, the benchmarks do not need a window or GL context.
+	auto window = std::make_shared<ofAppNoWindow>();
+	ofSetupOpenGL(window, 1920, 1080, OF_WINDOW);
+
+	auto app = new ofApp();
+	if (argc > 1)
+	{
+		app->outputPath = argv[1];
+	}
+	ofRunApp(app);
+}
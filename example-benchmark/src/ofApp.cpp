@@ -0,0 +1,462 @@
+#include "ofApp.h"
+
+namespace
+{
+	// Expose the protected mesh evaluation so it can be timed without a GL context.
+	class BenchmarkWarpBilinear
+		: public ofxWarp::WarpBilinear
+	{
+	public:
+		void setMeshResolution(int resolutionX, int resolutionY)
+		{
+			ofxWarp::GridMesh::getSamples(this->numControlsX, resolutionX, this->meshSamplesU);
+			ofxWarp::GridMesh::getSamples(this->numControlsY, resolutionY, this->meshSamplesV);
+			this->resolutionX = resolutionX;
+			this->resolutionY = resolutionY;
+		}
+
+		void setAdaptiveMesh()
+		{
+			this->getMeshSamples(this->meshSamplesU, this->meshSamplesV);
+			this->resolutionX = this->meshSamplesU.size();
+			this->resolutionY = this->meshSamplesV.size();
+		}
+
+		using ofxWarp::WarpBilinear::getMeshSamples;
+
+		void evaluate(std::vector<glm::vec4> & positions) const
+		{
+			positions.resize(this->resolutionX * this->resolutionY);
+			this->evaluateMesh(positions.data());
+		}
+	};
+
+	// Expose the protected homography solver.
+	class BenchmarkWarpPerspective
+		: public ofxWarp::WarpPerspective
+	{
+	public:
+		using ofxWarp::WarpPerspective::getPerspectiveTransform;
+	};
+
+	//--------------------------------------------------------------
+	void setupGrid(std::shared_ptr<ofxWarp::WarpBilinear> warp, int numControlsX, int numControlsY, bool linear)
+	{
+		warp->setLinear(linear);
+		warp->setNumControlsX(numControlsX);
+		warp->setNumControlsY(numControlsY);
+
+		// Jitter the control points so that the mesh is actually curved.
+		for (size_t i = 0; i < warp->getNumControlPoints(); ++i)
+		{
+			warp->moveControlPoint(i, glm::vec2(ofRandom(-0.01f, 0.01f), ofRandom(-0.01f, 0.01f)));
+		}
+	}
+
+	//--------------------------------------------------------------
+	void setupLargeSettings(ofxWarp::Controller & controller, int numWarps, int numControls)
+	{
+		for (auto i = 0; i < numWarps; ++i)
+		{
+			std::shared_ptr<ofxWarp::WarpBilinear> warp;
+			if (i % 2)
+			{
+				warp = controller.buildWarp<ofxWarp::WarpPerspectiveBilinear>();
+			}
+			else
+			{
+				warp = controller.buildWarp<ofxWarp::WarpBilinear>();
+			}
+			warp->setSize(1920, 1080);
+			warp->setEdges(glm::vec4(ofRandom(0.2f), ofRandom(0.2f), ofRandom(0.2f), ofRandom(0.2f)));
+			setupGrid(warp, numControls, numControls, false);
+		}
+	}
+}
+
+//--------------------------------------------------------------
+void ofApp::setup()
+{
+	ofSetLogLevel(OF_LOG_NOTICE);
+	ofSeedRandom(1234);
+
+	this->benchmark.getResults()["window"] = { ofGetWidth(), ofGetHeight() };
+
+	this->benchmarkMeshEvaluation();
+	this->benchmarkResampling();
+	this->benchmarkPerspectiveTransform();
+	this->benchmarkClosestControlPoint();
+	this->benchmarkSerialization();
+	this->benchmarkSettingsLoad();
+	this->benchmarkParameterChannel();
+	this->benchmarkBatchControlPoints();
+	this->benchmarkContentCoords();
+
+	this->benchmark.save(this->outputPath);
+	std::cout << this->benchmark.getResults().dump(4) << std::endl;
+
+	ofExit();
+}
+
+//--------------------------------------------------------------
+void ofApp::benchmarkMeshEvaluation()
+{
+	std::vector<glm::vec4> positions;
+
+	for (auto linear : { true, false })
+	{
+		for (auto numControls : { 2, 4, 8, 16, 32 })
+		{
+			auto warp = std::make_shared<BenchmarkWarpBilinear>();
+			setupGrid(warp, numControls, numControls, linear);
+
+			// Resolution is the size of a mesh quad in pixels, lower is finer.
+			for (auto resolution : { 16, 8, 4 })
+			{
+				warp->setMeshResolution(ofGetWidth() / resolution + 1, ofGetHeight() / resolution + 1);
+
+				auto params = nlohmann::json{ { "linear", linear }, { "controls", numControls }, { "resolution", resolution } };
+				this->benchmark.run("WarpBilinear::evaluateMesh", params, 20, [&]
+				{
+					warp->evaluate(positions);
+				});
+			}
+
+			// The adaptive mesh only refines where the jittered grid actually curves.
+			warp->setAdaptive(true);
+			warp->setAdaptiveMesh();
+			warp->evaluate(positions);
+
+			auto params = nlohmann::json{ { "linear", linear }, { "controls", numControls }, { "adaptive", true }, { "vertices", positions.size() } };
+			std::vector<float> samplesU;
+			std::vector<float> samplesV;
+			this->benchmark.run("WarpBilinear::getMeshSamples", params, 20, [&]
+			{
+				warp->getMeshSamples(samplesU, samplesV);
+			});
+			this->benchmark.run("WarpBilinear::evaluateMesh", params, 20, [&]
+			{
+				warp->evaluate(positions);
+			});
+		}
+	}
+}
+
+//--------------------------------------------------------------
+void ofApp::benchmarkResampling()
+{
+	for (auto linear : { true, false })
+	{
+		for (auto numControls : { 4, 8, 16 })
+		{
+			auto warp = std::make_shared<ofxWarp::WarpBilinear>();
+			setupGrid(warp, numControls, numControls, linear);
+
+			// Time a round trip, so that every iteration starts from the same grid size.
+			auto params = nlohmann::json{ { "linear", linear }, { "controls", numControls } };
+			this->benchmark.run("WarpBilinear::setNumControlsX", params, 20, [&]
+			{
+				warp->setNumControlsX(numControls * 2 - 1);
+				warp->setNumControlsX(numControls);
+			});
+			this->benchmark.run("WarpBilinear::setNumControlsY", params, 20, [&]
+			{
+				warp->setNumControlsY(numControls * 2 - 1);
+				warp->setNumControlsY(numControls);
+			});
+		}
+	}
+}
+
+//--------------------------------------------------------------
+void ofApp::benchmarkPerspectiveTransform()
+{
+	static const auto numTransforms = 1000;
+
+	BenchmarkWarpPerspective warp;
+
+	std::vector<glm::vec2> corners(numTransforms * 4);
+	for (auto i = 0; i < numTransforms; ++i)
+	{
+		corners[i * 4 + 0] = glm::vec2(ofRandom(0, 200), ofRandom(0, 200));
+		corners[i * 4 + 1] = glm::vec2(ofRandom(1720, 1920), ofRandom(0, 200));
+		corners[i * 4 + 2] = glm::vec2(ofRandom(1720, 1920), ofRandom(880, 1080));
+		corners[i * 4 + 3] = glm::vec2(ofRandom(0, 200), ofRandom(880, 1080));
+	}
+
+	const glm::vec2 src[4] = { { 0.0f, 0.0f }, { 1920.0f, 0.0f }, { 1920.0f, 1080.0f }, { 0.0f, 1080.0f } };
+	auto sum = glm::mat4(0.0f);
+
+	auto params = nlohmann::json{ { "transforms", numTransforms } };
+	this->benchmark.run("WarpPerspective::getPerspectiveTransform", params, 20, [&]
+	{
+		for (auto i = 0; i < numTransforms; ++i)
+		{
+			sum += warp.getPerspectiveTransform(src, &corners[i * 4]);
+		}
+	});
+
+	// Use the result so the loop can't be optimized away.
+	ofLogVerbose("ofApp::benchmarkPerspectiveTransform") << sum[0][0];
+}
+
+//--------------------------------------------------------------
+void ofApp::benchmarkClosestControlPoint()
+{
+	static const auto numQueries = 100;
+
+	// The last two cases are dense fulldome-style grids of 100k points.
+	for (auto numWarpsControls : { glm::ivec2(1, 32), glm::ivec2(10, 32), glm::ivec2(40, 32), glm::ivec2(1, 317), glm::ivec2(4, 317) })
+	{
+		auto numWarps = numWarpsControls.x;
+		auto numControls = numWarpsControls.y;
+
+		std::vector<std::shared_ptr<ofxWarp::WarpBilinear>> warps;
+		for (auto i = 0; i < numWarps; ++i)
+		{
+			auto warp = std::make_shared<ofxWarp::WarpBilinear>();
+			setupGrid(warp, numControls, numControls, true);
+			warps.push_back(warp);
+		}
+
+		std::vector<glm::vec2> queries(numQueries);
+		for (auto & query : queries)
+		{
+			query = glm::vec2(ofRandomWidth(), ofRandomHeight());
+		}
+
+		size_t found = 0;
+
+		auto params = nlohmann::json{ { "warps", numWarps }, { "controls", numControls * numControls }, { "queries", numQueries } };
+		this->benchmark.run("WarpBase::findClosestControlPoint", params, 20, [&]
+		{
+			for (auto & query : queries)
+			{
+				// Same search as Controller::findClosestControlPoint().
+				auto distance = std::numeric_limits<float>::max();
+				for (auto & warp : warps)
+				{
+					float candidate;
+					auto idx = warp->findClosestControlPoint(query, &candidate);
+					if (candidate < distance)
+					{
+						distance = candidate;
+						found = idx;
+					}
+				}
+			}
+		});
+
+		ofLogVerbose("ofApp::benchmarkClosestControlPoint") << found;
+	}
+}
+
+//--------------------------------------------------------------
+void ofApp::benchmarkSerialization()
+{
+	static const auto numWarps = 40;
+	static const auto numControls = 32;
+
+	ofxWarp::Controller controller;
+	setupLargeSettings(controller, numWarps, numControls);
+
+	auto params = nlohmann::json{ { "warps", numWarps }, { "controls", numControls * numControls } };
+
+	std::string dump;
+	this->benchmark.run("Controller::serialize", params, 10, [&]
+	{
+		nlohmann::json json;
+		controller.serialize(json);
+		dump = json.dump(4);
+	});
+	params["bytes"] = dump.size();
+
+	this->benchmark.run("Controller::deserialize", params, 10, [&]
+	{
+		ofxWarp::Controller other;
+		other.deserialize(nlohmann::json::parse(dump));
+	});
+
+	auto filePath = ofToDataPath("benchmark_settings.json", true);
+	ofFilePath::createEnclosingDirectory(filePath, false);
+
+	this->benchmark.run("Controller::saveSettings", params, 10, [&]
+	{
+		controller.saveSettings(filePath);
+	});
+
+	this->benchmark.run("Controller::loadSettings", params, 10, [&]
+	{
+		ofxWarp::Controller other;
+		other.loadSettings(filePath);
+	});
+
+	// Only the snapshot is taken on the calling thread, this is the cost seen by the render loop.
+	this->benchmark.run("Controller::saveSettingsAsync", params, 10, [&]
+	{
+		controller.saveSettingsAsync(filePath);
+	});
+	controller.waitForSaveSettings();
+
+	auto binaryPath = ofToDataPath("benchmark_settings.bin", true);
+	
+	auto binaryParams = params;
+	binaryParams["format"] = "binary";
+
+	this->benchmark.run("Controller::saveSettings", binaryParams, 10, [&]
+	{
+		controller.saveSettings(binaryPath, ofxWarp::Controller::FORMAT_BINARY);
+	});
+	binaryParams["bytes"] = ofFile(binaryPath).getSize();
+
+	this->benchmark.run("Controller::loadSettings", binaryParams, 10, [&]
+	{
+		ofxWarp::Controller other;
+		other.loadSettings(binaryPath);
+	});
+
+	ofFile::removeFile(filePath, false);
+	ofFile::removeFile(binaryPath, false);
+}
+
+//--------------------------------------------------------------
+void ofApp::benchmarkSettingsLoad()
+{
+	static const auto numWarps = 40;
+	static const auto numControls = 64;
+
+	ofxWarp::Controller controller;
+	setupLargeSettings(controller, numWarps, numControls);
+
+	std::vector<ofxWarp::WarpData> data;
+	controller.serialize(data);
+
+	// Write the same settings with every json schema, to compare string and numeric parsing.
+	for (auto version : { 1, 2 })
+	{
+		nlohmann::json json;
+		json["version"] = version;
+		for (auto & warpData : data)
+		{
+			nlohmann::json jsonWarp;
+			warpData.serialize(jsonWarp, version);
+			json["warps"].push_back(jsonWarp);
+		}
+
+		auto filePath = ofToDataPath("benchmark_settings_v" + ofToString(version) + ".json", true);
+		ofFilePath::createEnclosingDirectory(filePath, false);
+		{
+			auto file = ofFile(filePath, ofFile::WriteOnly);
+			file << json.dump(4);
+		}
+
+		auto params = nlohmann::json{ { "warps", numWarps }, { "controls", numControls * numControls }, { "version", version }, { "bytes", ofFile(filePath).getSize() } };
+		this->benchmark.run("Controller::loadSettings", params, 5, [&]
+		{
+			ofxWarp::Controller other;
+			other.loadSettings(filePath);
+		});
+
+		ofFile::removeFile(filePath, false);
+	}
+}
+
+//--------------------------------------------------------------
+void ofApp::benchmarkParameterChannel()
+{
+	for (auto numControls : { 4, 32 })
+	{
+		auto warp = std::make_shared<ofxWarp::WarpBilinear>();
+		setupGrid(warp, numControls, numControls, false);
+
+		ofxWarp::WarpParameters parameters;
+		warp->getParameters(parameters);
+
+		// Publish and apply from the same thread, this measures the copies and not any contention.
+		auto params = nlohmann::json{ { "controls", numControls * numControls } };
+		this->benchmark.run("WarpBase::publishParameters", params, 100, [&]
+		{
+			parameters.controlPoints[0].x += 0.001f;
+			warp->publishParameters(parameters);
+			warp->applyParameterUpdates();
+		});
+	}
+}
+
+//--------------------------------------------------------------
+void ofApp::benchmarkBatchControlPoints()
+{
+	static const auto numControls = 32;
+
+	auto warp = std::make_shared<ofxWarp::WarpPerspectiveBilinear>();
+	setupGrid(warp, numControls, numControls, false);
+
+	std::vector<glm::vec2> points(warp->getNumControlPoints());
+	warp->getControlPoints(points.data(), points.size());
+
+	auto params = nlohmann::json{ { "controls", numControls * numControls } };
+	this->benchmark.run("WarpPerspectiveBilinear::setControlPoint", params, 20, [&]
+	{
+		for (size_t i = 0; i < points.size(); ++i)
+		{
+			warp->setControlPoint(i, points[i]);
+		}
+	});
+
+	this->benchmark.run("WarpPerspectiveBilinear::setControlPoints", params, 20, [&]
+	{
+		warp->setControlPoints(points);
+	});
+
+	this->benchmark.run("WarpPerspectiveBilinear::getControlPoints", params, 20, [&]
+	{
+		warp->getControlPoints(points.data(), points.size());
+	});
+
+	std::vector<size_t> indices(points.size());
+	std::iota(indices.begin(), indices.end(), 0);
+	auto transform = glm::mat3(1.0f);
+	this->benchmark.run("WarpPerspectiveBilinear::transformControlPoints", params, 20, [&]
+	{
+		warp->transformControlPoints(indices.data(), indices.size(), transform);
+	});
+}
+
+//--------------------------------------------------------------
+void ofApp::benchmarkContentCoords()
+{
+	static const auto numQueries = 10000;
+
+	std::vector<glm::vec2> queries(numQueries);
+	for (auto & query : queries)
+	{
+		query = glm::vec2(ofRandomWidth(), ofRandomHeight());
+	}
+	std::vector<glm::vec2> coords(numQueries);
+
+	for (auto numControls : { 2, 8, 32 })
+	{
+		auto warp = std::make_shared<ofxWarp::WarpBilinear>();
+		setupGrid(warp, numControls, numControls, false);
+
+		// The first query builds the triangle grid, the rest reuse it.
+		glm::vec2 coord;
+		warp->getContentCoord(queries.front(), coord);
+
+		size_t found = 0;
+		auto params = nlohmann::json{ { "controls", numControls * numControls }, { "queries", numQueries } };
+		this->benchmark.run("WarpBase::getContentCoord", params, 20, [&]
+		{
+			for (auto & query : queries)
+			{
+				found += warp->getContentCoord(query, coord);
+			}
+		});
+		this->benchmark.run("WarpBase::getContentCoords", params, 20, [&]
+		{
+			found += warp->getContentCoords(queries.data(), queries.size(), coords.data());
+		});
+
+		ofLogVerbose("ofApp::benchmarkContentCoords") << found;
+	}
+}
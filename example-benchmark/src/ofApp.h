@@ -0,0 +1,26 @@
+#pragma once
+
+#include "ofMain.h"
+#include "ofxWarp.h"
+
+#include "Benchmark.h"
+
+class ofApp
+	: public ofBaseApp
+{
+public:
+	void setup();
+
+	void benchmarkMeshEvaluation();
+	void benchmarkResampling();
+	void benchmarkPerspectiveTransform();
+	void benchmarkClosestControlPoint();
+	void benchmarkSerialization();
+	void benchmarkSettingsLoad();
+	void benchmarkParameterChannel();
+	void benchmarkBatchControlPoints();
+	void benchmarkContentCoords();
+
+	std::string outputPath = "benchmark.json";
+	Benchmark benchmark;
+};
@@ -9,6 +9,7 @@ void main(void)
 {
 	vec2 uv = vTexCoord * 2.0 - 1.0;
 	float d = dot(uv, uv);
+	if (d > 1.0) discard;
 	float rim = smoothstep(0.7, 0.8, d);
 	rim += smoothstep(0.3, 0.4, d) - smoothstep(0.5, 0.6, d);
 	rim += smoothstep(0.1, 0.0, d);
@@ -0,0 +1,41 @@
+#version 150
+
+uniform sampler2D uTexture;
+uniform sampler2D uMap;
+uniform sampler2D uBlendMap;
+uniform bool uFlipMap;
+uniform bool uHasBlendMap;
+uniform vec3 uLuminance;
+uniform vec3 uGamma;
+uniform vec4 uEdges;
+uniform vec4 uCorners;
+uniform float uExponent;
+
+in vec2 vTexCoord;
+in vec4 vColor;
+
+out vec4 fragColor;
+
+void main(void)
+{
+	// Look up the normalized content coordinates, pixels without content are negative or not a number.
+	vec2 mapCoord = texture(uMap, uFlipMap ? vec2(vTexCoord.x, 1.0 - vTexCoord.y) : vTexCoord).xy;
+	if (!(mapCoord.x >= 0.0 && mapCoord.y >= 0.0)) discard;
+
+	vec4 texColor = texture(uTexture, mix(uCorners.xy, uCorners.zw, mapCoord));
+
+	float a = 1.0;
+	if (uEdges.x > 0.0) a *= clamp(mapCoord.x / uEdges.x, 0.0, 1.0);
+	if (uEdges.y > 0.0) a *= clamp(mapCoord.y / uEdges.y, 0.0, 1.0);
+	if (uEdges.z > 0.0) a *= clamp((1.0 - mapCoord.x) / uEdges.z, 0.0, 1.0);
+	if (uEdges.w > 0.0) a *= clamp((1.0 - mapCoord.y) / uEdges.w, 0.0, 1.0);
+
+	const vec3 one = vec3(1.0);
+	vec3 blend = (a < 0.5) ? (uLuminance * pow(2.0 * a, uExponent)) : one - (one - uLuminance) * pow(2.0 * (1.0 - a), uExponent);
+
+	texColor.rgb *= pow(blend, one / uGamma);
+
+	if (uHasBlendMap) texColor.rgb *= texture(uBlendMap, vTexCoord).rgb;
+
+	fragColor = texColor * vColor;
+}
@@ -70,22 +70,22 @@ void ofApp::draw()
 
 	if (this->texture.isAllocated())
 	{
-		for (auto i = 0; i < this->warpController.getNumWarps(); ++i)
+		// The controller skips warps that are off screen, dark or hidden under other warps.
+		if (this->useBeginEnd)
 		{
-			auto warp = this->warpController.getWarp(i);
-			if (this->useBeginEnd)
+			this->warpController.draw([this](size_t i, ofxWarpBase & warp)
 			{
-				warp->begin();
+				warp.begin();
 				{
-					auto bounds = warp->getBounds();
+					auto bounds = warp.getBounds();
 					this->texture.drawSubsection(bounds.x, bounds.y, bounds.width, bounds.height, this->srcAreas[i].x, this->srcAreas[i].y, this->srcAreas[i].width, this->srcAreas[i].height);
 				}
-				warp->end();
-			}
-			else
-			{
-				warp->draw(this->texture, this->srcAreas[i]);
-			}
+				warp.end();
+			});
+		}
+		else
+		{
+			this->warpController.draw(this->texture, this->srcAreas);
 		}
 	}
 
@@ -1,13 +1,37 @@
 #pragma once
 
+#include "ofxWarp/Geometry/Clip.h"
+#include "ofxWarp/Geometry/ControlGrid.h"
+#include "ofxWarp/Geometry/DomeProjection.h"
+#include "ofxWarp/Geometry/EdgeBlend.h"
+#include "ofxWarp/Geometry/GridMesh.h"
+#include "ofxWarp/Geometry/Homography.h"
+#include "ofxWarp/Geometry/LensModel.h"
+#include "ofxWarp/Geometry/PointGrid.h"
+#include "ofxWarp/Geometry/Sampling.h"
+#include "ofxWarp/Geometry/TriangleGrid.h"
+#include "ofxWarp/Geometry/WarpMesh.h"
+#include "ofxWarp/Geometry/WarpStage.h"
+
 #include "ofxWarp/Controller.h"
+#include "ofxWarp/MpcdiPackage.h"
+#include "ofxWarp/PfmFile.h"
+#include "ofxWarp/SoftwareRenderer.h"
 #include "ofxWarp/WarpBase.h"
 #include "ofxWarp/WarpBilinear.h"
+#include "ofxWarp/WarpChain.h"
+#include "ofxWarp/WarpDome.h"
+#include "ofxWarp/WarpLens.h"
+#include "ofxWarp/WarpMap.h"
 #include "ofxWarp/WarpPerspective.h"
 #include "ofxWarp/WarpPerspectiveBilinear.h"
 
 typedef ofxWarp::Controller ofxWarpController;
 typedef ofxWarp::WarpBase ofxWarpBase;
 typedef ofxWarp::WarpBilinear ofxWarpBilinear;
+typedef ofxWarp::WarpChain ofxWarpChain;
+typedef ofxWarp::WarpDome ofxWarpDome;
+typedef ofxWarp::WarpLens ofxWarpLens;
+typedef ofxWarp::WarpMap ofxWarpMap;
 typedef ofxWarp::WarpPerspective ofxWarpPerspective;
 typedef ofxWarp::WarpPerspectiveBilinear ofxWarpPerspectiveBilinear;
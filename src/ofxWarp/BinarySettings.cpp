@@ -0,0 +1,244 @@
+#include "BinarySettings.h"
+
+#include "ofLog.h"
+
+namespace ofxWarp
+{
+	namespace
+	{
+		const char MAGIC[4] = { 'O', 'F', 'X', 'W' };
+
+		//--------------------------------------------------------------
+		template<typename Type>
+		void append(std::vector<char> & buffer, const Type * values, size_t count)
+		{
+			if (count == 0) return;
+
+			auto offset = buffer.size();
+			buffer.resize(offset + sizeof(Type) * count);
+			memcpy(buffer.data() + offset, values, sizeof(Type) * count);
+		}
+	}
+
+	//--------------------------------------------------------------
+	bool BinarySettings::isBinary(const char * data, size_t size)
+	{
+		return (size >= sizeof(FileHeader) && memcmp(data, MAGIC, sizeof(MAGIC)) == 0);
+	}
+
+	//--------------------------------------------------------------
+	void BinarySettings::write(const std::vector<WarpData> & warps, std::vector<char> & buffer)
+	{
+		FileHeader header;
+		memcpy(header.magic, MAGIC, sizeof(MAGIC));
+		header.version = VERSION;
+		header.numWarps = warps.size();
+		header.reserved = 0;
+
+		buffer.clear();
+		append(buffer, &header, 1);
+
+		// Reserve the offset table, it is filled in once the blocks are written.
+		auto tableOffset = buffer.size();
+		std::vector<uint64_t> offsets(warps.size());
+		append(buffer, offsets.data(), offsets.size());
+
+		for (size_t i = 0; i < warps.size(); ++i)
+		{
+			offsets[i] = buffer.size();
+			writeWarp(warps[i], buffer);
+		}
+
+		if (!offsets.empty())
+		{
+			memcpy(buffer.data() + tableOffset, offsets.data(), sizeof(uint64_t) * offsets.size());
+		}
+	}
+
+	//--------------------------------------------------------------
+	void BinarySettings::writeWarp(const WarpData & warp, std::vector<char> & buffer)
+	{
+		WarpHeader header;
+		header.type = warp.type;
+		header.brightness = warp.brightness;
+		header.numControlsX = warp.numControlsX;
+		header.numControlsY = warp.numControlsY;
+		header.exponent = warp.exponent;
+		memcpy(header.edges, &warp.edges[0], sizeof(header.edges));
+		memcpy(header.gamma, &warp.gamma[0], sizeof(header.gamma));
+		memcpy(header.luminance, &warp.luminance[0], sizeof(header.luminance));
+		header.resolution = warp.resolution;
+		header.flags = (warp.hasMesh ? FLAG_HAS_MESH : 0) | (warp.linear ? FLAG_LINEAR : 0) | (warp.adaptive ? FLAG_ADAPTIVE : 0);
+		header.numControlPoints = warp.controlPoints.size();
+		header.numCorners = warp.corners.size();
+		header.numParameters = warp.parameters.size();
+
+		append(buffer, &header, 1);
+		append(buffer, warp.controlPoints.data(), warp.controlPoints.size());
+		append(buffer, warp.corners.data(), warp.corners.size());
+		append(buffer, warp.parameters.data(), warp.parameters.size());
+
+		uint32_t mapPathLength = warp.mapPath.size();
+		append(buffer, &mapPathLength, 1);
+		append(buffer, warp.mapPath.data(), warp.mapPath.size());
+	}
+
+	//--------------------------------------------------------------
+	void BinarySettings::writeBlocks(const std::vector<std::vector<char>> & blocks, std::vector<char> & buffer)
+	{
+		FileHeader header;
+		memcpy(header.magic, MAGIC, sizeof(MAGIC));
+		header.version = VERSION;
+		header.numWarps = blocks.size();
+		header.reserved = 0;
+
+		// The block sizes are known, so the offset table can be written up front.
+		std::vector<uint64_t> offsets(blocks.size());
+		auto offset = sizeof(FileHeader) + sizeof(uint64_t) * blocks.size();
+		for (size_t i = 0; i < blocks.size(); ++i)
+		{
+			offsets[i] = offset;
+			offset += blocks[i].size();
+		}
+
+		buffer.clear();
+		buffer.reserve(offset);
+		append(buffer, &header, 1);
+		append(buffer, offsets.data(), offsets.size());
+		for (auto & block : blocks)
+		{
+			append(buffer, block.data(), block.size());
+		}
+	}
+
+	//--------------------------------------------------------------
+	size_t BinarySettings::getNumWarps(const char * data, size_t size)
+	{
+		FileHeader header;
+		if (!readHeader(data, size, header)) return 0;
+
+		return header.numWarps;
+	}
+
+	//--------------------------------------------------------------
+	bool BinarySettings::readWarp(const char * data, size_t size, size_t index, WarpData & warp)
+	{
+		FileHeader header;
+		if (!readHeader(data, size, header) || index >= header.numWarps) return false;
+
+		uint64_t offset;
+		memcpy(&offset, data + sizeof(FileHeader) + sizeof(uint64_t) * index, sizeof(uint64_t));
+		if (offset >= size) return false;
+
+		return readWarp(data + offset, size - offset, header.version, warp);
+	}
+
+	//--------------------------------------------------------------
+	bool BinarySettings::read(const char * data, size_t size, std::vector<WarpData> & warps)
+	{
+		// An invalid header must not be mistaken for an empty file, that would delete every warp.
+		FileHeader header;
+		if (!readHeader(data, size, header)) return false;
+
+		std::vector<WarpData> decoded(header.numWarps);
+		for (size_t i = 0; i < decoded.size(); ++i)
+		{
+			if (!readWarp(data, size, i, decoded[i]))
+			{
+				ofLogWarning("BinarySettings::read") << "Could not read warp " << i;
+				return false;
+			}
+		}
+
+		warps = std::move(decoded);
+		return true;
+	}
+
+	//--------------------------------------------------------------
+	bool BinarySettings::readHeader(const char * data, size_t size, FileHeader & header)
+	{
+		if (!isBinary(data, size)) return false;
+
+		memcpy(&header, data, sizeof(FileHeader));
+		if (header.version > VERSION)
+		{
+			ofLogWarning("BinarySettings::readHeader") << "Unsupported version " << header.version;
+			return false;
+		}
+		if (header.numWarps > (size - sizeof(FileHeader)) / sizeof(uint64_t))
+		{
+			ofLogWarning("BinarySettings::readHeader") << "Offset table is truncated";
+			return false;
+		}
+
+		return true;
+	}
+
+	//--------------------------------------------------------------
+	bool BinarySettings::readWarp(const char * data, size_t size, uint32_t version, WarpData & warp)
+	{
+		if (size < sizeof(WarpHeader)) return false;
+
+		WarpHeader header;
+		memcpy(&header, data, sizeof(WarpHeader));
+
+		auto pointsSize = sizeof(glm::vec2) * (size_t(header.numControlPoints) + header.numCorners);
+		auto parametersSize = sizeof(float) * header.numParameters;
+		if (sizeof(WarpHeader) + pointsSize + parametersSize > size) return false;
+
+		if (header.numControlPoints != size_t(header.numControlsX) * header.numControlsY)
+		{
+			ofLogWarning("BinarySettings::readWarp") << "Expected " << (size_t(header.numControlsX) * header.numControlsY) << " control points for a " << header.numControlsX << "x" << header.numControlsY << " grid but got " << header.numControlPoints;
+			return false;
+		}
+
+		warp.type = header.type;
+		warp.brightness = header.brightness;
+		warp.numControlsX = header.numControlsX;
+		warp.numControlsY = header.numControlsY;
+		warp.exponent = header.exponent;
+		memcpy(&warp.edges[0], header.edges, sizeof(header.edges));
+		memcpy(&warp.gamma[0], header.gamma, sizeof(header.gamma));
+		memcpy(&warp.luminance[0], header.luminance, sizeof(header.luminance));
+		warp.resolution = header.resolution;
+		warp.hasMesh = (header.flags & FLAG_HAS_MESH) != 0;
+		warp.linear = (header.flags & FLAG_LINEAR) != 0;
+		warp.adaptive = (header.flags & FLAG_ADAPTIVE) != 0;
+
+		// Copy the raw arrays straight into place.
+		auto ptr = data + sizeof(WarpHeader);
+		warp.controlPoints.resize(header.numControlPoints);
+		if (header.numControlPoints)
+		{
+			memcpy(warp.controlPoints.data(), ptr, sizeof(glm::vec2) * header.numControlPoints);
+			ptr += sizeof(glm::vec2) * header.numControlPoints;
+		}
+		warp.corners.resize(header.numCorners);
+		if (header.numCorners)
+		{
+			memcpy(warp.corners.data(), ptr, sizeof(glm::vec2) * header.numCorners);
+			ptr += sizeof(glm::vec2) * header.numCorners;
+		}
+		warp.parameters.resize(header.numParameters);
+		if (header.numParameters)
+		{
+			memcpy(warp.parameters.data(), ptr, parametersSize);
+			ptr += parametersSize;
+		}
+
+		warp.mapPath.clear();
+		if (version >= 2)
+		{
+			auto end = data + size;
+			uint32_t mapPathLength;
+			if (end - ptr < (ptrdiff_t)sizeof(mapPathLength)) return false;
+			memcpy(&mapPathLength, ptr, sizeof(mapPathLength));
+			ptr += sizeof(mapPathLength);
+
+			if (end - ptr < (ptrdiff_t)mapPathLength) return false;
+			warp.mapPath.assign(ptr, mapPathLength);
+		}
+
+		return true;
+	}
+}
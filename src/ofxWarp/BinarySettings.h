@@ -0,0 +1,72 @@
+#pragma once
+
+#include "WarpData.h"
+
+namespace ofxWarp
+{
+	//! Compact binary settings format.
+	//! The file starts with a versioned header and a table with the offset of each warp, followed by
+	//! one block per warp holding a fixed size record and the raw float arrays for its points.
+	//! Values are stored in native (little-endian) byte order so the arrays can be copied straight out of a mapped file.
+	//! Version 2 appends the length and characters of the map path to each warp block.
+	class BinarySettings
+	{
+	public:
+		static const uint32_t VERSION = 2;
+
+		//! return whether the data starts with a binary settings header
+		static bool isBinary(const char * data, size_t size);
+
+		//! encode the warps into a binary settings buffer
+		static void write(const std::vector<WarpData> & warps, std::vector<char> & buffer);
+		//! encode a single warp block, without any file header
+		static void writeWarp(const WarpData & warp, std::vector<char> & buffer);
+		//! assemble a binary settings buffer from warp blocks encoded with writeWarp()
+		static void writeBlocks(const std::vector<std::vector<char>> & blocks, std::vector<char> & buffer);
+
+		//! return the number of warps in a binary settings buffer, or 0 if it is invalid
+		static size_t getNumWarps(const char * data, size_t size);
+		//! decode the warp at the specified index of a binary settings buffer
+		static bool readWarp(const char * data, size_t size, size_t index, WarpData & warp);
+		//! decode all the warps of a binary settings buffer, returns false and leaves warps unchanged if the header or any warp is invalid
+		static bool read(const char * data, size_t size, std::vector<WarpData> & warps);
+
+	protected:
+		typedef struct
+		{
+			char magic[4];
+			uint32_t version;
+			uint32_t numWarps;
+			uint32_t reserved;
+		} FileHeader;
+
+		typedef struct
+		{
+			int32_t type;
+			float brightness;
+			uint32_t numControlsX;
+			uint32_t numControlsY;
+			float exponent;
+			float edges[4];
+			float gamma[3];
+			float luminance[3];
+			int32_t resolution;
+			uint32_t flags;
+			uint32_t numControlPoints;
+			uint32_t numCorners;
+			uint32_t numParameters;
+		} WarpHeader;
+
+		typedef enum
+		{
+			FLAG_HAS_MESH = 1 << 0,
+			FLAG_LINEAR = 1 << 1,
+			FLAG_ADAPTIVE = 1 << 2
+		} Flag;
+
+		//! copy the file header, returns false if the version is unsupported or the offset table doesn't fit in size bytes
+		static bool readHeader(const char * data, size_t size, FileHeader & header);
+		//! decode a single warp block written with the specified version, returns false if it doesn't fit in size bytes
+		static bool readWarp(const char * data, size_t size, uint32_t version, WarpData & warp);
+	};
+}
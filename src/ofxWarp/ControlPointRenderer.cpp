@@ -0,0 +1,110 @@
+#include "ControlPointRenderer.h"
+
+#include "WarpBase.h"
+
+namespace ofxWarp
+{
+	//--------------------------------------------------------------
+	ControlPointRenderer & ControlPointRenderer::getShared()
+	{
+		static ControlPointRenderer renderer;
+		return renderer;
+	}
+
+	//--------------------------------------------------------------
+	ControlPointRenderer::ControlPointRenderer()
+		: instanceCapacity(0)
+	{
+		ofAddListener(ofEvents().draw, this, &ControlPointRenderer::onDraw, OF_EVENT_ORDER_AFTER_APP);
+	}
+
+	//--------------------------------------------------------------
+	ControlPointRenderer::~ControlPointRenderer()
+	{
+		ofRemoveListener(ofEvents().draw, this, &ControlPointRenderer::onDraw, OF_EVENT_ORDER_AFTER_APP);
+	}
+
+	//--------------------------------------------------------------
+	void ControlPointRenderer::queue(const glm::vec2 & pos, const ofFloatColor & color, float scale)
+	{
+		this->instances.emplace_back(pos, color, scale);
+	}
+
+	//--------------------------------------------------------------
+	size_t ControlPointRenderer::getNumQueued() const
+	{
+		return this->instances.size();
+	}
+
+	//--------------------------------------------------------------
+	void ControlPointRenderer::setup()
+	{
+		if (!this->vbo.getIsAllocated())
+		{
+			// Set up the quad, the circle is cut out in the fragment shader.
+			const glm::vec3 positions[4] =
+			{
+				{ -RADIUS, -RADIUS, 0.0f },
+				{ RADIUS, -RADIUS, 0.0f },
+				{ -RADIUS, RADIUS, 0.0f },
+				{ RADIUS, RADIUS, 0.0f }
+			};
+			const glm::vec2 texCoords[4] =
+			{
+				{ 0.0f, 0.0f },
+				{ 1.0f, 0.0f },
+				{ 0.0f, 1.0f },
+				{ 1.0f, 1.0f }
+			};
+			this->vbo.setVertexData(positions, 4, GL_STATIC_DRAW);
+			this->vbo.setTexCoordData(texCoords, 4, GL_STATIC_DRAW);
+		}
+
+		// Grow the instance buffer as needed, it is never shrunk.
+		if (this->instances.size() > this->instanceCapacity)
+		{
+			this->instanceCapacity = MAX(this->instances.size(), this->instanceCapacity * 2);
+			this->instanceBuffer.allocate(this->instanceCapacity * sizeof(Instance), GL_STREAM_DRAW);
+
+			this->vbo.setAttributeBuffer(INSTANCE_POS_SCALE_ATTRIBUTE, this->instanceBuffer, 4, sizeof(Instance), offsetof(Instance, pos));
+			this->vbo.setAttributeDivisor(INSTANCE_POS_SCALE_ATTRIBUTE, 1);
+			this->vbo.setAttributeBuffer(INSTANCE_COLOR_ATTRIBUTE, this->instanceBuffer, 4, sizeof(Instance), offsetof(Instance, color));
+			this->vbo.setAttributeDivisor(INSTANCE_COLOR_ATTRIBUTE, 1);
+		}
+
+		if (!this->shader.isLoaded())
+		{
+			// Load the shader.
+			this->shader.setupShaderFromFile(GL_VERTEX_SHADER, WarpBase::getShaderPath() / "ControlPoint.vert");
+			this->shader.setupShaderFromFile(GL_FRAGMENT_SHADER, WarpBase::getShaderPath() / "ControlPoint.frag");
+			this->shader.bindAttribute(INSTANCE_POS_SCALE_ATTRIBUTE, "iPositionScale");
+			this->shader.bindAttribute(INSTANCE_COLOR_ATTRIBUTE, "iColor");
+			this->shader.bindDefaults();
+			this->shader.linkProgram();
+		}
+	}
+
+	//--------------------------------------------------------------
+	void ControlPointRenderer::flush()
+	{
+		if (this->instances.empty()) return;
+
+		this->setup();
+
+		this->instanceBuffer.updateData(0, this->instances.size() * sizeof(Instance), this->instances.data());
+
+		this->shader.begin();
+		{
+			this->vbo.drawInstanced(GL_TRIANGLE_STRIP, 0, 4, this->instances.size());
+		}
+		this->shader.end();
+
+		this->instances.clear();
+	}
+
+	//--------------------------------------------------------------
+	void ControlPointRenderer::onDraw(ofEventArgs & args)
+	{
+		this->flush();
+	}
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "ofBufferObject.h"
+#include "ofColor.h"
+#include "ofEvents.h"
+#include "ofShader.h"
+#include "ofVbo.h"
+#include "ofVectorMath.h"
+
+namespace ofxWarp
+{
+	//! Draws the control points of all warps in a single instanced call.
+	//! Warps queue their points while they draw, and the queue is flushed once per frame after the app has drawn,
+	//! so the overlay always ends up on top. Each point is a 4 vertex quad shaded as a circle in the fragment shader.
+	class ControlPointRenderer
+	{
+	public:
+		//! radius of a control point in pixels, at a scale of 1
+		static constexpr float RADIUS = 15.0f;
+
+		//! return the renderer shared by all warps
+		static ControlPointRenderer & getShared();
+
+		ControlPointRenderer();
+		~ControlPointRenderer();
+
+		ControlPointRenderer(const ControlPointRenderer &) = delete;
+		ControlPointRenderer & operator=(const ControlPointRenderer &) = delete;
+
+		//! queue a control point at the specified position in pixels
+		void queue(const glm::vec2 & pos, const ofFloatColor & color, float scale = 1.0f);
+
+		//! draw all queued control points and clear the queue
+		//! this is called automatically after the app draws, only call it to draw the overlay somewhere else
+		void flush();
+
+		//! return the number of control points waiting to be drawn
+		size_t getNumQueued() const;
+
+	protected:
+		//! set up the quad, instance buffer and shader
+		void setup();
+
+		void onDraw(ofEventArgs & args);
+
+	protected:
+		typedef enum
+		{
+			INSTANCE_POS_SCALE_ATTRIBUTE = 5,
+			INSTANCE_COLOR_ATTRIBUTE = 6
+		} Attribute;
+
+		//! interleaved per-instance data, uploaded with a single call per frame
+		typedef struct Instance
+		{
+			glm::vec2 pos;
+			float scale;
+			float dummy;
+			ofFloatColor color;
+
+			Instance()
+			{}
+
+			Instance(const glm::vec2 & pos, const ofFloatColor & color, float scale)
+				: pos(pos)
+				, scale(scale)
+				, dummy(0.0f)
+				, color(color)
+			{}
+		} Instance;
+
+		std::vector<Instance> instances;
+
+		ofVbo vbo;
+		ofBufferObject instanceBuffer;
+		size_t instanceCapacity;
+		ofShader shader;
+	};
+}
@@ -1,6 +1,14 @@
 #include "Controller.h"
 
+#include "BinarySettings.h"
+#include "MappedFile.h"
+#include "MpcdiPackage.h"
+#include "SettingsWriter.h"
 #include "WarpBilinear.h"
+#include "WarpChain.h"
+#include "WarpDome.h"
+#include "WarpLens.h"
+#include "WarpMap.h"
 #include "WarpPerspective.h"
 #include "WarpPerspectiveBilinear.h"
 
@@ -8,10 +16,62 @@
 
 namespace ofxWarp
 {
+	namespace
+	{
+		//--------------------------------------------------------------
+		void resolveMapPaths(const std::string & filePath, std::vector<WarpData> & data)
+		{
+			auto directory = std::filesystem::path(ofToDataPath(filePath, true)).parent_path();
+			for (auto & warpData : data)
+			{
+				if (!warpData.mapPath.empty() && std::filesystem::path(warpData.mapPath).is_relative())
+				{
+					warpData.mapPath = (directory / warpData.mapPath).string();
+				}
+			}
+		}
+
+		//--------------------------------------------------------------
+		bool isSupportedVersion(const nlohmann::json & json, int & version)
+		{
+			// Files written before the schema was versioned don't have one, newer schemas may mean something else.
+			auto it = json.find("version");
+			if (it == json.end())
+			{
+				version = 1;
+				return true;
+			}
+			version = it->is_number_integer() ? it->get<int>() : -1;
+			return (version >= 1 && version <= WarpData::JSON_VERSION);
+		}
+
+		//--------------------------------------------------------------
+		void makeMapPathRelative(const std::string & filePath, WarpData & data)
+		{
+			// Maps next to the settings file are referred to by name, so the folder can be moved as a whole.
+			auto mapPath = std::filesystem::path(data.mapPath);
+			if (!data.mapPath.empty() && mapPath.parent_path() == std::filesystem::path(ofToDataPath(filePath, true)).parent_path())
+			{
+				data.mapPath = mapPath.filename().string();
+			}
+		}
+	}
+
 	//--------------------------------------------------------------
 	Controller::Controller()
 		: focusedIndex(-1)
+		, savedFormat(FORMAT_JSON)
+		, hasQueuedDrag(false)
+		, queuedShift(0.0f)
+		, queuedInputTime(0)
+		, watchInterval(0.5f)
+		, watchTime(0.0f)
 	{
+		this->resetInputStats();
+		this->resetDrawStats();
+
+		ofAddListener(ofEvents().update, this, &Controller::onUpdate);
+
 		ofAddListener(ofEvents().mouseMoved, this, &Controller::onMouseMoved);
 		ofAddListener(ofEvents().mousePressed, this, &Controller::onMousePressed);
 		ofAddListener(ofEvents().mouseDragged, this, &Controller::onMouseDragged);
@@ -26,6 +86,7 @@ namespace ofxWarp
 	//--------------------------------------------------------------
 	Controller::~Controller()
 	{
+		ofRemoveListener(ofEvents().update, this, &Controller::onUpdate);
 		ofRemoveListener(ofEvents().mouseMoved, this, &Controller::onMouseMoved);
 		ofRemoveListener(ofEvents().mousePressed, this, &Controller::onMousePressed);
 		ofRemoveListener(ofEvents().mouseDragged, this, &Controller::onMouseDragged);
@@ -40,35 +101,341 @@ namespace ofxWarp
 	}
 
 	//--------------------------------------------------------------
-	bool Controller::saveSettings(const std::string & filePath)
+	bool Controller::saveSettings(const std::string & filePath, Format format)
 	{
-		nlohmann::json json;
-		this->serialize(json);
+		// Don't race a pending asynchronous save to the same file.
+		this->waitForSaveSettings();
 
-		auto file = ofFile(filePath, ofFile::WriteOnly);
-		file << json.dump(4);
+		this->saveMaps(filePath);
 
-		return true;
+		std::vector<WarpData> data;
+		this->serialize(data);
+
+		// Don't pick up our own changes as an external edit.
+		if (ofToDataPath(filePath, true) == this->watchPath)
+		{
+			this->watchData = data;
+		}
+
+		for (auto & warpData : data)
+		{
+			makeMapPathRelative(filePath, warpData);
+		}
+		return writeSettings(filePath, data, format);
+	}
+
+	//--------------------------------------------------------------
+	void Controller::saveSettingsAsync(const std::string & filePath, Format format)
+	{
+		if (!this->settingsWriter)
+		{
+			this->settingsWriter = std::make_unique<SettingsWriter>();
+		}
+
+		this->saveMaps(filePath);
+
+		auto absPath = ofToDataPath(filePath, true);
+		if (absPath == this->watchPath)
+		{
+			this->serialize(this->watchData);
+		}
+
+		// The writer keeps the encoding of every warp, which depends on the format and the folder map paths are relative to.
+		if (absPath != this->savedPath || format != this->savedFormat)
+		{
+			this->savedWarps.clear();
+			this->savedPath = absPath;
+			this->savedFormat = format;
+		}
+
+		// Only warps that changed since the last save are copied on this thread, encoding and writing is left to the writer.
+		SettingsWriter::ChangedWarps changedWarps;
+		this->savedWarps.resize(this->warps.size());
+		for (size_t i = 0; i < this->warps.size(); ++i)
+		{
+			const auto & warp = this->warps[i];
+			auto & saved = this->savedWarps[i];
+			if (saved.warp.lock() == warp
+				&& saved.revision == warp->getRevision()
+				&& saved.brightness == warp->getBrightness()
+				&& saved.exponent == warp->getExponent()
+				&& saved.edges == warp->getEdges()
+				&& saved.gamma == warp->getGamma()
+				&& saved.luminance == warp->getLuminance())
+			{
+				continue;
+			}
+
+			saved.warp = warp;
+			saved.revision = warp->getRevision();
+			saved.brightness = warp->getBrightness();
+			saved.exponent = warp->getExponent();
+			saved.edges = warp->getEdges();
+			saved.gamma = warp->getGamma();
+			saved.luminance = warp->getLuminance();
+
+			changedWarps.emplace_back(i, WarpData());
+			warp->serialize(changedWarps.back().second);
+			makeMapPathRelative(filePath, changedWarps.back().second);
+		}
+
+		this->settingsWriter->save(absPath, this->warps.size(), std::move(changedWarps), format);
+	}
+
+	//--------------------------------------------------------------
+	bool Controller::isSavingSettings() const
+	{
+		return (this->settingsWriter && this->settingsWriter->isSaving());
+	}
+
+	//--------------------------------------------------------------
+	void Controller::waitForSaveSettings()
+	{
+		if (this->settingsWriter)
+		{
+			this->settingsWriter->waitForSave();
+		}
 	}
 
 	//--------------------------------------------------------------
 	bool Controller::loadSettings(const std::string & filePath)
 	{
-		auto file = ofFile(filePath, ofFile::ReadOnly);
-		if (!file.exists())
+		std::vector<WarpData> data;
+		if (!readSettings(filePath, data))
+		{
+			return false;
+		}
+
+		this->deserialize(data);
+
+		if (ofToDataPath(filePath, true) == this->watchPath)
+		{
+			this->watchData = std::move(data);
+		}
+
+		return true;
+	}
+
+	//--------------------------------------------------------------
+	bool Controller::reloadSettings(const std::string & filePath)
+	{
+		std::vector<WarpData> data;
+		if (!readSettings(filePath, data))
+		{
+			return false;
+		}
+
+		this->applySettings(data);
+
+		return true;
+	}
+
+	//--------------------------------------------------------------
+	void Controller::applySettings(const std::vector<WarpData> & data)
+	{
+		for (size_t i = 0; i < data.size(); ++i)
+		{
+			if (i < this->warps.size() && this->warps[i]->getType() == data[i].type)
+			{
+				// Same warp, only update what changed.
+				this->warps[i]->deserialize(data[i]);
+				continue;
+			}
+
+			auto warp = createWarp((WarpBase::Type)data[i].type);
+			if (!warp)
+			{
+				continue;
+			}
+			warp->deserialize(data[i]);
+
+			if (i < this->warps.size())
+			{
+				this->warps[i] = warp;
+			}
+			else
+			{
+				this->warps.push_back(warp);
+			}
+		}
+
+		if (this->warps.size() > data.size())
+		{
+			this->warps.resize(data.size());
+		}
+	}
+
+	//--------------------------------------------------------------
+	void Controller::watchSettings(const std::string & filePath, float interval)
+	{
+		this->watchPath = ofToDataPath(filePath, true);
+		this->watchInterval = interval;
+		this->watchTime = ofGetElapsedTimef();
+		this->serialize(this->watchData);
+
+		std::error_code error;
+		this->watchWriteTime = std::filesystem::last_write_time(this->watchPath, error);
+	}
+
+	//--------------------------------------------------------------
+	void Controller::unwatchSettings()
+	{
+		this->watchPath.clear();
+		this->watchData.clear();
+	}
+
+	//--------------------------------------------------------------
+	bool Controller::isWatchingSettings() const
+	{
+		return !this->watchPath.empty();
+	}
+
+	//--------------------------------------------------------------
+	bool Controller::convertSettings(const std::string & srcPath, const std::string & dstPath, Format format)
+	{
+		std::vector<WarpData> data;
+		if (!readSettings(srcPath, data))
+		{
+			return false;
+		}
+
+		return writeSettings(dstPath, data, format);
+	}
+
+	//--------------------------------------------------------------
+	bool Controller::importMpcdi(const std::string & directoryPath)
+	{
+		std::vector<std::shared_ptr<WarpBase>> warps;
+		if (!MpcdiPackage::load(directoryPath, warps))
+		{
+			return false;
+		}
+
+		this->warps = warps;
+		return true;
+	}
+
+	//--------------------------------------------------------------
+	bool Controller::exportMpcdi(const std::string & directoryPath, size_t width, size_t height)
+	{
+		return MpcdiPackage::save(directoryPath, this->warps, width, height);
+	}
+
+	//--------------------------------------------------------------
+	bool Controller::readSettings(const std::string & filePath, std::vector<WarpData> & data)
+	{
+		MappedFile file;
+		if (!file.open(ofToDataPath(filePath, true)))
 		{
 			ofLogWarning("Warp::loadSettings") << "File not found at path " << filePath;
 			return false;
 		}
 
-		nlohmann::json json;
-		file >> json;
+		if (BinarySettings::isBinary(file.getData(), file.getSize()))
+		{
+			// Binary settings are decoded straight from the mapped file.
+			if (!BinarySettings::read(file.getData(), file.getSize(), data))
+			{
+				ofLogWarning("Warp::loadSettings") << "Invalid binary settings at path " << filePath;
+				return false;
+			}
+			resolveMapPaths(filePath, data);
+			return true;
+		}
+
+		auto json = nlohmann::json::parse(file.getData(), file.getData() + file.getSize(), nullptr, false);
+		auto jsonWarps = json.is_object() ? json.find("warps") : json.end();
+		if (json.is_discarded() || jsonWarps == json.end() || !jsonWarps->is_array())
+		{
+			ofLogWarning("Warp::loadSettings") << "Invalid json settings at path " << filePath;
+			return false;
+		}
 
-		this->deserialize(json);
+		int version;
+		if (!isSupportedVersion(json, version))
+		{
+			ofLogWarning("Warp::loadSettings") << "Unsupported settings version " << version << " at path " << filePath;
+			return false;
+		}
+
+		data.clear();
+		for (size_t i = 0; i < jsonWarps->size(); ++i)
+		{
+			data.emplace_back();
+			if (!data.back().deserialize((*jsonWarps)[i]))
+			{
+				ofLogWarning("Warp::loadSettings") << "Skipping malformed warp " << i << " at path " << filePath;
+				data.pop_back();
+			}
+		}
+		if (data.empty() && !jsonWarps->empty())
+		{
+			ofLogWarning("Warp::loadSettings") << "No readable warps at path " << filePath;
+			return false;
+		}
+		resolveMapPaths(filePath, data);
 
 		return true;
 	}
 
+	//--------------------------------------------------------------
+	bool Controller::writeSettings(const std::string & filePath, const std::vector<WarpData> & data, Format format)
+	{
+		if (format == FORMAT_BINARY)
+		{
+			std::vector<char> buffer;
+			BinarySettings::write(data, buffer);
+
+			std::ofstream file(ofToDataPath(filePath, true), std::ios::binary | std::ios::trunc);
+			file.write(buffer.data(), buffer.size());
+
+			return file.good();
+		}
+
+		nlohmann::json json;
+		std::vector<nlohmann::json> jsonWarps;
+		for (auto & warpData : data)
+		{
+			nlohmann::json jsonWarp;
+			warpData.serialize(jsonWarp);
+			jsonWarps.push_back(jsonWarp);
+		}
+		json["version"] = WarpData::JSON_VERSION;
+		json["warps"] = jsonWarps;
+
+		auto file = ofFile(filePath, ofFile::WriteOnly);
+		file << json.dump(4);
+
+		return file.good();
+	}
+
+	//--------------------------------------------------------------
+	void Controller::saveMaps(const std::string & filePath)
+	{
+		auto settingsPath = std::filesystem::path(ofToDataPath(filePath, true));
+		auto directory = settingsPath.parent_path();
+		auto stem = settingsPath.stem().string();
+
+		for (size_t i = 0; i < this->warps.size(); ++i)
+		{
+			auto warpMap = std::dynamic_pointer_cast<WarpMap>(this->warps[i]);
+			if (!warpMap || warpMap->getMapWidth() == 0 || !warpMap->getMapPath().empty()) continue;
+
+			// Never overwrite an existing file, another warp may still have it mapped.
+			std::filesystem::path mapPath;
+			for (auto n = 0; n == 0 || std::filesystem::exists(mapPath); ++n)
+			{
+				mapPath = directory / (stem + "-map" + ofToString(i) + ((n > 0) ? "-" + ofToString(n) : "") + ".pfm");
+			}
+
+			// Read the map back from the file, so later saves refer to it instead of writing it again.
+			if (!warpMap->saveMap(mapPath.string()) || !warpMap->loadMap(mapPath.string()))
+			{
+				ofLogWarning("Controller::saveSettings") << "Could not write the map of warp " << i << " to " << mapPath.string();
+			}
+		}
+	}
+
 	//--------------------------------------------------------------
 	void Controller::serialize(nlohmann::json & json)
 	{
@@ -79,45 +446,103 @@ namespace ofxWarp
 			warp->serialize(jsonWarp);
 			jsonWarps.push_back(jsonWarp);
 		}
+		json["version"] = WarpData::JSON_VERSION;
 		json["warps"] = jsonWarps;
 	}
 	
 	//--------------------------------------------------------------
 	void Controller::deserialize(const nlohmann::json & json)
 	{
-		this->warps.clear();
-		for (auto & jsonWarp : json["warps"])
+		auto jsonWarps = json.is_object() ? json.find("warps") : json.end();
+		if (jsonWarps == json.end() || !jsonWarps->is_array())
 		{
-			std::shared_ptr<WarpBase> warp;
-
-			int typeAsInt = jsonWarp["type"];
-			WarpBase::Type type = (WarpBase::Type)typeAsInt;
-			switch (type)
-			{
-			case WarpBase::TYPE_BILINEAR:
-				warp = std::make_shared<WarpBilinear>();
-				break;
+			ofLogWarning("Controller::deserialize") << "Missing warps list";
+			return;
+		}
 
-			case WarpBase::TYPE_PERSPECTIVE:
-				warp = std::make_shared<WarpPerspective>();
-				break;
+		int version;
+		if (!isSupportedVersion(json, version))
+		{
+			ofLogWarning("Controller::deserialize") << "Unsupported settings version " << version;
+			return;
+		}
 
-			case WarpBase::TYPE_PERSPECTIVE_BILINEAR:
-				warp = std::make_shared<WarpPerspectiveBilinear>();
-				break;
+		this->warps.clear();
+		for (size_t i = 0; i < jsonWarps->size(); ++i)
+		{
+			WarpData data;
+			if (!data.deserialize((*jsonWarps)[i]))
+			{
+				ofLogWarning("Controller::deserialize") << "Skipping malformed warp " << i;
+				continue;
+			}
 
-			default:
-				ofLogWarning("Warp::loadSettings") << "Unrecognized Warp type " << type;
+			auto warp = createWarp((WarpBase::Type)data.type);
+			if (warp)
+			{
+				warp->deserialize(data);
+				this->warps.push_back(warp);
 			}
+		}
+	}
+
+	//--------------------------------------------------------------
+	void Controller::serialize(std::vector<WarpData> & data)
+	{
+		data.resize(this->warps.size());
+		for (size_t i = 0; i < this->warps.size(); ++i)
+		{
+			this->warps[i]->serialize(data[i]);
+		}
+	}
 
+	//--------------------------------------------------------------
+	void Controller::deserialize(const std::vector<WarpData> & data)
+	{
+		this->warps.clear();
+		for (auto & warpData : data)
+		{
+			auto warp = createWarp((WarpBase::Type)warpData.type);
 			if (warp)
 			{
-				warp->deserialize(jsonWarp);
+				warp->deserialize(warpData);
 				this->warps.push_back(warp);
 			}
 		}
 	}
 
+	//--------------------------------------------------------------
+	std::shared_ptr<WarpBase> Controller::createWarp(WarpBase::Type type)
+	{
+		switch (type)
+		{
+		case WarpBase::TYPE_BILINEAR:
+			return std::make_shared<WarpBilinear>();
+
+		case WarpBase::TYPE_PERSPECTIVE:
+			return std::make_shared<WarpPerspective>();
+
+		case WarpBase::TYPE_PERSPECTIVE_BILINEAR:
+			return std::make_shared<WarpPerspectiveBilinear>();
+
+		case WarpBase::TYPE_CHAIN:
+			return std::make_shared<WarpChain>();
+
+		case WarpBase::TYPE_LENS:
+			return std::make_shared<WarpLens>();
+
+		case WarpBase::TYPE_DOME:
+			return std::make_shared<WarpDome>();
+
+		case WarpBase::TYPE_MAP:
+			return std::make_shared<WarpMap>();
+
+		default:
+			ofLogWarning("Warp::loadSettings") << "Unrecognized Warp type " << type;
+			return nullptr;
+		}
+	}
+
 	//--------------------------------------------------------------
 	bool Controller::addWarp(std::shared_ptr<WarpBase> warp)
 	{
@@ -166,6 +591,127 @@ namespace ofxWarp
 		return this->warps.size();
 	}
 
+#pragma mark DRAWING
+
+	//--------------------------------------------------------------
+	void Controller::draw(const ofTexture & texture)
+	{
+		this->draw(texture, std::vector<ofRectangle>());
+	}
+
+	//--------------------------------------------------------------
+	void Controller::draw(const ofTexture & texture, const std::vector<ofRectangle> & srcAreas)
+	{
+		this->draw([&](size_t index, WarpBase & warp)
+		{
+			if (index < srcAreas.size())
+			{
+				warp.draw(texture, srcAreas[index]);
+			}
+			else
+			{
+				warp.draw(texture);
+			}
+		});
+	}
+
+	//--------------------------------------------------------------
+	void Controller::draw(const std::function<void(size_t index, WarpBase & warp)> & drawWarp)
+	{
+		this->updateVisibility();
+
+		for (size_t i = 0; i < this->warps.size(); ++i)
+		{
+			if (this->visibility[i] == VISIBILITY_VISIBLE)
+			{
+				drawWarp(i, *this->warps[i]);
+			}
+		}
+	}
+
+	//--------------------------------------------------------------
+	void Controller::updateVisibility()
+	{
+		auto viewport = ofRectangle(0.0f, 0.0f, ofGetViewportWidth(), ofGetViewportHeight());
+
+		this->visibility.resize(this->warps.size());
+
+		// Go through the warps from the top down, so each warp is checked against the occluders drawn after it.
+		std::vector<std::shared_ptr<WarpBase>> occluders;
+		for (auto i = (int)this->warps.size() - 1; i >= 0; --i)
+		{
+			const auto & warp = this->warps[i];
+			auto bounds = warp->getScreenBounds();
+
+			if (!bounds.intersects(viewport))
+			{
+				this->visibility[i] = VISIBILITY_OFFSCREEN;
+				++this->drawStats.numOffscreen;
+				continue;
+			}
+
+			if (!warp->isEditing())
+			{
+				if (warp->getBrightness() <= 0.0f)
+				{
+					this->visibility[i] = VISIBILITY_DARK;
+					++this->drawStats.numDark;
+					continue;
+				}
+
+				// Only the part inside the viewport has to be covered.
+				auto visibleBounds = bounds.getIntersection(viewport);
+				auto occluded = std::any_of(occluders.begin(), occluders.end(), [&](const std::shared_ptr<WarpBase> & occluder)
+				{
+					return occluder->covers(visibleBounds);
+				});
+				if (occluded)
+				{
+					this->visibility[i] = VISIBILITY_OCCLUDED;
+					++this->drawStats.numOccluded;
+					continue;
+				}
+			}
+
+			this->visibility[i] = VISIBILITY_VISIBLE;
+			++this->drawStats.numDrawn;
+
+			// Edge blended warps let the warps under them show through.
+			if (warp->isOpaque() && warp->getEdges() == glm::vec4(0.0f))
+			{
+				occluders.push_back(warp);
+			}
+		}
+
+		++this->drawStats.numPasses;
+	}
+
+	//--------------------------------------------------------------
+	Controller::Visibility Controller::getVisibility(size_t index) const
+	{
+		if (index < this->visibility.size())
+		{
+			return this->visibility[index];
+		}
+		return VISIBILITY_VISIBLE;
+	}
+
+	//--------------------------------------------------------------
+	const Controller::DrawStats & Controller::getDrawStats() const
+	{
+		return this->drawStats;
+	}
+
+	//--------------------------------------------------------------
+	void Controller::resetDrawStats()
+	{
+		this->drawStats.numPasses = 0;
+		this->drawStats.numDrawn = 0;
+		this->drawStats.numOffscreen = 0;
+		this->drawStats.numDark = 0;
+		this->drawStats.numOccluded = 0;
+	}
+
 #pragma mark CONTROL POINTS AND WARPS
     
     //--------------------------------------------------------------
@@ -278,6 +824,8 @@ namespace ofxWarp
         //interctions modes (i.e. GUIs) overlayed ontop of the mouse interaction
         if(ignoreMouseInteractions) return;
         
+        // Apply queued input first, so that it lands on the warp it was meant for.
+        this->applyQueuedInput();
         
         if(ofGetKeyPressed(OF_KEY_LEFT_ALT) && editingMode)
         {
@@ -337,10 +885,10 @@ namespace ofxWarp
             case FocusStates::ACTIVE_CONTROL_POINT:
             {
                 
-                if (this->focusedIndex < this->warps.size())
-                {
-                    this->warps[this->focusedIndex]->handleCursorDrag(args);
-                }
+                // Only the latest position matters, it is applied once per frame in onUpdate().
+                this->queueInput();
+                this->queuedDragPos = args;
+                this->hasQueuedDrag = true;
                 break;
             }
             default: break;
@@ -356,6 +904,9 @@ namespace ofxWarp
         //interctions modes (i.e. GUIs) overlayed ontop of the mouse interaction
         if(ignoreMouseInteractions) return;
         
+        // Land the final drag position before releasing.
+        this->applyQueuedInput();
+        
         //Make sure the warps are in edit mode
         if(!areWarpsInEditMode()) return;
         
@@ -387,6 +938,14 @@ namespace ofxWarp
 	//--------------------------------------------------------------
 	void Controller::onKeyPressed(ofKeyEventArgs & args)
 	{
+		// Can't use OF_KEY_XX, see https://github.com/openframeworks/openFrameworks/issues/5948
+		auto isMoveKey = (args.keycode == GLFW_KEY_UP || args.keycode == GLFW_KEY_DOWN || args.keycode == GLFW_KEY_LEFT || args.keycode == GLFW_KEY_RIGHT);
+		if (!isMoveKey)
+		{
+			// Any other key may change the selection, so apply queued moves first.
+			this->applyQueuedInput();
+		}
+
 		if (args.key == 'w')
 		{
             toggleEditing();
@@ -438,9 +997,7 @@ namespace ofxWarp
 				}
 				warp->selectControlPoint(nextIndex);
 			}
-			//else if (args.key == OF_KEY_UP || args.key == OF_KEY_DOWN || args.key == OF_KEY_LEFT || args.key == OF_KEY_RIGHT)
-			// Can't use OF_KEY_XX, see https://github.com/openframeworks/openFrameworks/issues/5948
-			else if (args.keycode == GLFW_KEY_UP || args.keycode == GLFW_KEY_DOWN || args.keycode == GLFW_KEY_LEFT || args.keycode == GLFW_KEY_RIGHT)
+			else if (isMoveKey)
 			{
 				auto step = ofGetKeyPressed(OF_KEY_SHIFT) ? 10.0f : 0.5f;
 				auto shift = glm::vec2(0.0f);
@@ -460,7 +1017,10 @@ namespace ofxWarp
 				{
 					shift.x = step / (float)ofGetWidth();
 				}
-				warp->moveControlPoint(warp->getSelectedControlPoint(), shift);
+
+				// Key repeat can fire several times per frame, the moves are summed and applied once in onUpdate().
+				this->queueInput();
+				this->queuedShift += shift;
 			}
 			else if (args.key == OF_KEY_F9)
 			{
@@ -478,7 +1038,7 @@ namespace ofxWarp
 			{
 				warp->flipVertical();
 			}
-			else if (warp->getType() == WarpBase::TYPE_BILINEAR || warp->getType() == WarpBase::TYPE_PERSPECTIVE_BILINEAR)
+			else if (warp->getType() == WarpBase::TYPE_BILINEAR || warp->getType() == WarpBase::TYPE_PERSPECTIVE_BILINEAR || warp->getType() == WarpBase::TYPE_CHAIN || warp->getType() == WarpBase::TYPE_LENS || warp->getType() == WarpBase::TYPE_DOME)
 			{
 				// The rest of the controls only apply to Bilinear warps.
 				auto warpBilinear = std::dynamic_pointer_cast<WarpBilinear>(warp);
@@ -562,6 +1122,108 @@ namespace ofxWarp
     
     }
 
+	//--------------------------------------------------------------
+	void Controller::onUpdate(ofEventArgs & args)
+	{
+		// Pick up parameters published from other threads before anything is drawn this frame.
+		for (auto warp : this->warps)
+		{
+			warp->applyParameterUpdates();
+		}
+
+		// Apply input after the published parameters, so the operator's edit is what gets drawn.
+		this->applyQueuedInput();
+
+		this->updateWatchedSettings();
+	}
+
+	//--------------------------------------------------------------
+	void Controller::queueInput()
+	{
+		if (!this->hasQueuedDrag && this->queuedShift == glm::vec2(0.0f))
+		{
+			this->queuedInputTime = ofGetElapsedTimeMicros();
+		}
+		++this->inputStats.numEvents;
+	}
+
+	//--------------------------------------------------------------
+	void Controller::applyQueuedInput()
+	{
+		if (!this->hasQueuedDrag && this->queuedShift == glm::vec2(0.0f)) return;
+
+		if (this->focusedIndex < this->warps.size())
+		{
+			auto warp = this->warps[this->focusedIndex];
+			if (this->hasQueuedDrag)
+			{
+				warp->handleCursorDrag(this->queuedDragPos);
+			}
+			if (this->queuedShift != glm::vec2(0.0f))
+			{
+				warp->moveControlPoint(warp->getSelectedControlPoint(), this->queuedShift);
+			}
+		}
+
+		this->hasQueuedDrag = false;
+		this->queuedShift = glm::vec2(0.0f);
+
+		auto latency = (ofGetElapsedTimeMicros() - this->queuedInputTime) / 1000.0f;
+		++this->inputStats.numUpdates;
+		this->inputStats.lastLatency = latency;
+		this->inputStats.maxLatency = MAX(this->inputStats.maxLatency, latency);
+		this->inputStats.totalLatency += latency;
+	}
+
+	//--------------------------------------------------------------
+	const Controller::InputStats & Controller::getInputStats() const
+	{
+		return this->inputStats;
+	}
+
+	//--------------------------------------------------------------
+	void Controller::resetInputStats()
+	{
+		this->inputStats.numEvents = 0;
+		this->inputStats.numUpdates = 0;
+		this->inputStats.lastLatency = 0.0f;
+		this->inputStats.maxLatency = 0.0f;
+		this->inputStats.totalLatency = 0.0f;
+	}
+
+	//--------------------------------------------------------------
+	void Controller::updateWatchedSettings()
+	{
+		if (this->watchPath.empty()) return;
+
+		auto now = ofGetElapsedTimef();
+		if (now - this->watchTime < this->watchInterval) return;
+		this->watchTime = now;
+
+		std::error_code error;
+		auto writeTime = std::filesystem::last_write_time(this->watchPath, error);
+		if (error || writeTime == this->watchWriteTime) return;
+		this->watchWriteTime = writeTime;
+
+		// The file may still be in the middle of being written, it will be picked up again on its next change.
+		// An empty result only comes from a file that lists no warps, a broken one fails to read instead.
+		try
+		{
+			std::vector<WarpData> data;
+			if (!readSettings(this->watchPath, data)) return;
+
+			// Ignore the file if it is what we last loaded or saved ourselves.
+			if (data == this->watchData) return;
+
+			this->applySettings(data);
+			this->watchData = std::move(data);
+		}
+		catch (const std::exception & e)
+		{
+			ofLogWarning("Controller::updateWatchedSettings") << "Could not reload " << this->watchPath << ": " << e.what();
+		}
+	}
+
 	//--------------------------------------------------------------
 	void Controller::onWindowResized(ofResizeEventArgs & args)
 	{
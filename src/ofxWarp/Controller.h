@@ -3,24 +3,114 @@
 #include "ofEvents.h"
 #include "WarpBase.h"
 
+#include <functional>
+
 namespace ofxWarp
 {
+	class SettingsWriter;
+
 	class Controller
 	{
 	public:
+		typedef enum
+		{
+			FORMAT_JSON,
+			FORMAT_BINARY
+		} Format;
+
+		//! Latency between receiving input and applying it to the warps.
+		typedef struct
+		{
+			//! number of drag and key move events received
+			size_t numEvents;
+			//! number of times queued input was applied, at most once per frame
+			size_t numUpdates;
+			//! latency of the last update, measured from the oldest event it applied, in milliseconds
+			float lastLatency;
+			//! highest latency since the stats were reset, in milliseconds
+			float maxLatency;
+			//! sum of all latencies, divide by numUpdates for the average
+			float totalLatency;
+		} InputStats;
+
+		//! Result of the visibility pass, for each warp.
+		typedef enum
+		{
+			VISIBILITY_VISIBLE,
+			//! the warp's screen bounds miss the viewport
+			VISIBILITY_OFFSCREEN,
+			//! the warp's brightness is zero
+			VISIBILITY_DARK,
+			//! the warp is hidden under opaque warps drawn after it
+			VISIBILITY_OCCLUDED
+		} Visibility;
+
+		//! Warps drawn and skipped by the visibility pass, summed over all passes since the last reset.
+		typedef struct
+		{
+			//! number of visibility passes, one per call to draw()
+			size_t numPasses;
+			//! number of warps drawn
+			size_t numDrawn;
+			//! number of warps skipped because they are off screen
+			size_t numOffscreen;
+			//! number of warps skipped because their brightness is zero
+			size_t numDark;
+			//! number of warps skipped because they are hidden under opaque warps
+			size_t numOccluded;
+		} DrawStats;
+
 		Controller();
 		~Controller();
 
-		//! write a settings json file
-		bool saveSettings(const std::string & filePath);
-		//! read a settings json file
+		//! write a settings file in the specified format
+		bool saveSettings(const std::string & filePath, Format format = FORMAT_JSON);
+		//! read a settings file, the format is detected automatically
 		bool loadSettings(const std::string & filePath);
+
+		//! snapshot the warps and write them to a settings file on a background thread
+		//! only warps that changed since the previous asynchronous save are serialized again
+		void saveSettingsAsync(const std::string & filePath, Format format = FORMAT_JSON);
+		//! return whether an asynchronous save is queued or in progress
+		bool isSavingSettings() const;
+		//! block until all asynchronous saves are written
+		void waitForSaveSettings();
+
+		//! read a settings file and apply it onto the existing warps, see applySettings()
+		bool reloadSettings(const std::string & filePath);
+		//! update the warps from plain data records, keeping existing warps of matching type and index
+		//! only settings that actually changed mark a warp dirty, so its GL resources are kept
+		void applySettings(const std::vector<WarpData> & data);
+
+		//! reload the settings file whenever it changes on disk, checking every interval seconds
+		void watchSettings(const std::string & filePath, float interval = 0.5f);
+		//! stop watching the settings file
+		void unwatchSettings();
+		//! return whether a settings file is being watched
+		bool isWatchingSettings() const;
+
+		//! convert a settings file to the specified format, without creating any warps
+		static bool convertSettings(const std::string & srcPath, const std::string & dstPath, Format format);
+
+		//! replace the warps with the regions of an MPCDI package extracted to a directory, see MpcdiPackage::load()
+		bool importMpcdi(const std::string & directoryPath);
+		//! write the warps to an MPCDI package directory, with warp and alpha maps of width * height pixels
+		bool exportMpcdi(const std::string & directoryPath, size_t width, size_t height);
 		
 		//! serialize the list of warps to a json file
 		void serialize(nlohmann::json & json);
-		//! deserialize the list of warps from a json file
+		//! deserialize the list of warps from a json file, malformed warps are skipped
+		//! json written with a newer schema version than WarpData::JSON_VERSION is rejected and the warps are kept
 		void deserialize(const nlohmann::json & json);
 
+		//! copy the settings of all warps to plain data records
+		void serialize(std::vector<WarpData> & data);
+		//! rebuild the list of warps from plain data records
+		void deserialize(const std::vector<WarpData> & data);
+
+		//! build a new warp of the specified type, returns nullptr if the type is unknown
+		static std::shared_ptr<WarpBase> createWarp(WarpBase::Type type);
+
 		//! build and add a new warp of the specified type
 		template<class Type>
 		inline std::shared_ptr<Type> buildWarp()
@@ -43,6 +133,25 @@ namespace ofxWarp
 		//! return the number of warps
 		size_t getNumWarps() const;
 
+		//! draw the texture on every visible warp, in order
+		void draw(const ofTexture & texture);
+		//! draw an area of the texture on every visible warp, in order, with one area per warp
+		//! warps without an area get the full texture
+		void draw(const ofTexture & texture, const std::vector<ofRectangle> & srcAreas);
+		//! call drawWarp for every visible warp, in order, e.g. to draw their contents between begin() and end()
+		void draw(const std::function<void(size_t index, WarpBase & warp)> & drawWarp);
+
+		//! work out which warps are visible in the current viewport, this is done by draw()
+		//! warps that are being edited are only skipped when off screen, so their controls stay usable
+		void updateVisibility();
+		//! return the visibility of the warp at the specified index, as of the last visibility pass
+		Visibility getVisibility(size_t index) const;
+
+		//! return the visibility pass counters
+		const DrawStats & getDrawStats() const;
+		//! reset the visibility pass counters
+		void resetDrawStats();
+
 		//! handle mouseMoved events for multiple warps
 		void onMouseMoved(ofMouseEventArgs & args);
 		//! handle mousePressed events for multiple warps
@@ -57,15 +166,40 @@ namespace ofxWarp
 		//! handle keyReleased events for multiple warps
 		void onKeyReleased(ofKeyEventArgs & args);
 
+		//! apply published warp parameters and check the watched settings file for changes
+		void onUpdate(ofEventArgs & args);
+
 		//! handle windowResized events for multiple warps
 		void onWindowResized(ofResizeEventArgs & args);
 
+		//! return the input latency stats
+		const InputStats & getInputStats() const;
+		//! reset the input latency stats
+		void resetInputStats();
+
         //! check to see if warps are in editing mode
         bool areWarpsInEditMode();
         
         //! set ignoreMouseInteractions for special case scenarios instances
         void setIgnoreMouseInteractions(bool _ignoreMouseInteractions_ignoreMouseInteractions);
         
+	protected:
+		//! read a settings file into plain data records, fails if the file lists warps but none of them can be read
+		static bool readSettings(const std::string & filePath, std::vector<WarpData> & data);
+		//! write plain data records to a settings file
+		static bool writeSettings(const std::string & filePath, const std::vector<WarpData> & data, Format format);
+
+		//! write the maps that were set in memory to pfm files next to the settings file, so the settings can refer to them
+		void saveMaps(const std::string & filePath);
+
+		//! reload the watched settings file if it changed
+		void updateWatchedSettings();
+
+		//! start the latency clock if this is the first event queued since the last update
+		void queueInput();
+		//! apply the queued drag and key moves to the focused warp
+		void applyQueuedInput();
+
 	protected:
         //! check all warps and returns the index of the closest control point
         //! without actually selecting or delecting any control points
@@ -84,6 +218,41 @@ namespace ofxWarp
         
 	protected:
 		std::vector<std::shared_ptr<WarpBase>> warps;
+		std::unique_ptr<SettingsWriter> settingsWriter;
+
+		//! state of each warp when it was last handed to the settings writer, so that unchanged warps aren't copied again
+		struct SavedWarp
+		{
+			std::weak_ptr<WarpBase> warp;
+			uint64_t revision;
+			float brightness;
+			float exponent;
+			glm::vec4 edges;
+			glm::vec3 gamma;
+			glm::vec3 luminance;
+		};
+		std::vector<SavedWarp> savedWarps;
+		std::string savedPath;
+		Format savedFormat;
+
+		//! drag and key move input, coalesced until the next update
+		bool hasQueuedDrag;
+		glm::vec2 queuedDragPos;
+		glm::vec2 queuedShift;
+		uint64_t queuedInputTime;
+		InputStats inputStats;
+
+		//! result of the last visibility pass, one entry per warp
+		std::vector<Visibility> visibility;
+		DrawStats drawStats;
+
+		//! watched settings file, with the state it was last loaded or saved with
+		std::string watchPath;
+		float watchInterval;
+		float watchTime;
+		std::filesystem::file_time_type watchWriteTime;
+		std::vector<WarpData> watchData;
+
 		size_t focusedIndex;
         size_t focusedIndexControlPoint;
         
@@ -0,0 +1,117 @@
+#include "Clip.h"
+
+namespace ofxWarp
+{
+	//--------------------------------------------------------------
+	bool clipBounds(glm::vec4 & srcBounds, glm::vec4 & dstBounds, const glm::vec2 & size)
+	{
+		bool clipped = false;
+
+		// Convert to (minX, minY, maxX, maxY).
+		auto srcWidth = srcBounds.z;
+		auto srcHeight = srcBounds.w;
+		glm::vec4 srcVec = glm::vec4(srcBounds.x, srcBounds.y, srcBounds.x + srcBounds.z, srcBounds.y + srcBounds.w);
+		glm::vec4 dstVec = glm::vec4(dstBounds.x, dstBounds.y, dstBounds.x + dstBounds.z, dstBounds.y + dstBounds.w);
+
+		float x1 = dstVec.x / size.x;
+		float x2 = dstVec.z / size.x;
+		float y1 = dstVec.y / size.y;
+		float y2 = dstVec.w / size.y;
+
+		if (x1 < 0.0f)
+		{
+			dstVec.x = 0.0f;
+			srcVec.x -= (x1 * srcWidth);
+			clipped = true;
+		}
+		else if (x1 > 1.0f)
+		{
+			dstVec.x = size.x;
+			srcVec.x -= ((1.0f / x1) * srcWidth);
+			clipped = true;
+		}
+
+		if (x2 < 0.0f)
+		{
+			dstVec.z = 0.0f;
+			srcVec.z -= (x2 * srcWidth);
+			clipped = true;
+		}
+		else if (x2 > 1.0f)
+		{
+			dstVec.z = size.x;
+			srcVec.z -= ((1.0f / x2) * srcWidth);
+			clipped = true;
+		}
+
+		if (y1 < 0.0f)
+		{
+			dstVec.y = 0.0f;
+			srcVec.y -= (y1 * srcHeight);
+			clipped = true;
+		}
+		else if (y1 > 1.0f)
+		{
+			dstVec.y = size.y;
+			srcVec.y -= ((1.0f / y1) * srcHeight);
+			clipped = true;
+		}
+
+		if (y2 < 0.0f)
+		{
+			dstVec.w = 0.0f;
+			srcVec.w -= (y2 * srcHeight);
+			clipped = true;
+		}
+		else if (y2 > 1.0f)
+		{
+			dstVec.w = size.y;
+			srcVec.w -= ((1.0f / y2) * srcHeight);
+			clipped = true;
+		}
+
+		// Convert back to (x, y, width, height).
+		srcBounds = glm::vec4(srcVec.x, srcVec.y, srcVec.z - srcVec.x, srcVec.w - srcVec.y);
+		dstBounds = glm::vec4(dstVec.x, dstVec.y, dstVec.z - dstVec.x, dstVec.w - dstVec.y);
+
+		return clipped;
+	}
+
+	//--------------------------------------------------------------
+	bool quadContainsRect(const glm::vec2 quad[4], const glm::vec4 & rect)
+	{
+		auto cross = [](const glm::vec2 & a, const glm::vec2 & b)
+		{
+			return (a.x * b.y - a.y * b.x);
+		};
+
+		// The quad is convex if all corners turn the same way.
+		auto orientation = 0.0f;
+		for (auto i = 0; i < 4; ++i)
+		{
+			auto turn = cross(quad[(i + 1) % 4] - quad[i], quad[(i + 2) % 4] - quad[(i + 1) % 4]);
+			if (turn == 0.0f || (orientation != 0.0f && (turn > 0.0f) != (orientation > 0.0f))) return false;
+
+			orientation = turn;
+		}
+
+		// A convex quad contains the rectangle if it contains its 4 corners.
+		const glm::vec2 corners[4] =
+		{
+			{ rect.x, rect.y },
+			{ rect.x + rect.z, rect.y },
+			{ rect.x + rect.z, rect.y + rect.w },
+			{ rect.x, rect.y + rect.w }
+		};
+		for (const auto & corner : corners)
+		{
+			for (auto i = 0; i < 4; ++i)
+			{
+				auto side = cross(quad[(i + 1) % 4] - quad[i], corner - quad[i]);
+				if ((orientation > 0.0f) ? (side < 0.0f) : (side > 0.0f)) return false;
+			}
+		}
+
+		return true;
+	}
+}
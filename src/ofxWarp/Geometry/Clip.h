@@ -0,0 +1,15 @@
+#pragma once
+
+#include "glm/vec2.hpp"
+#include "glm/vec4.hpp"
+
+namespace ofxWarp
+{
+	//! adjust both the source and destination rectangles (x, y, width, height) so that they are clipped against content of the specified size
+	//! return whether any clipping occurred
+	bool clipBounds(glm::vec4 & srcBounds, glm::vec4 & dstBounds, const glm::vec2 & size);
+
+	//! return whether the rectangle (x, y, width, height) lies entirely inside the quad, whose corners have to be in perimeter order
+	//! returns false for concave, self-intersecting or degenerate quads
+	bool quadContainsRect(const glm::vec2 quad[4], const glm::vec4 & rect);
+}
@@ -0,0 +1,408 @@
+#include "ControlGrid.h"
+
+#include "glm/common.hpp"
+#include "glm/geometric.hpp"
+
+#include <algorithm>
+
+namespace ofxWarp
+{
+	//--------------------------------------------------------------
+	ControlGrid::ControlGrid(const glm::vec2 * points, size_t numControlsX, size_t numControlsY)
+		: points(points)
+		, numControlsX(numControlsX)
+		, numControlsY(numControlsY)
+	{}
+
+	//--------------------------------------------------------------
+	ControlGrid::ControlGrid(const std::vector<glm::vec2> & points, size_t numControlsX, size_t numControlsY)
+		: ControlGrid(points.data(), numControlsX, numControlsY)
+	{}
+
+	//--------------------------------------------------------------
+	size_t ControlGrid::getNumControlsX() const
+	{
+		return this->numControlsX;
+	}
+
+	//--------------------------------------------------------------
+	size_t ControlGrid::getNumControlsY() const
+	{
+		return this->numControlsY;
+	}
+
+	//--------------------------------------------------------------
+	size_t ControlGrid::getNumControlPoints() const
+	{
+		return this->numControlsX * this->numControlsY;
+	}
+
+	//--------------------------------------------------------------
+	glm::vec2 ControlGrid::getPoint(int col, int row) const
+	{
+		auto maxCol = (int)this->numControlsX - 1;
+		auto maxRow = (int)this->numControlsY - 1;
+
+		// Here's the magic: extrapolate points beyond the edges.
+		if (col < 0)
+		{
+			return (2.0f * getPoint(0, row) - getPoint(0 - col, row));
+		}
+		if (row < 0)
+		{
+			return (2.0f * getPoint(col, 0) - getPoint(col, 0 - row));
+		}
+		if (col > maxCol)
+		{
+			return (2.0f * getPoint(maxCol, row) - getPoint(2 * maxCol - col, row));
+		}
+		if (row > maxRow)
+		{
+			return (2.0f * getPoint(col, maxRow) - getPoint(col, 2 * maxRow - row));
+		}
+
+		// Points on the edges or within the mesh can simply be looked up.
+		auto idx = (col * this->numControlsY) + row;
+		return this->points[idx];
+	}
+
+	//--------------------------------------------------------------
+	glm::vec2 ControlGrid::evaluate(float u, float v, bool linear) const
+	{
+		// Determine col and row.
+		auto col = (int)u;
+		auto row = (int)v;
+
+		// Normalize coordinates to [0..1]
+		u -= col;
+		v -= row;
+
+		if (linear)
+		{
+			// Perform linear interpolation.
+			auto p1 = (1.0f - u) * this->getPoint(col, row) + u * this->getPoint(col + 1, row);
+			auto p2 = (1.0f - u) * this->getPoint(col, row + 1) + u * this->getPoint(col + 1, row + 1);
+			return ((1.0f - v) * p1 + v * p2);
+		}
+
+		// Perform bicubic interpolation.
+		glm::vec2 rows[4];
+		glm::vec2 cols[4];
+		for (int i = -1; i < 3; ++i)
+		{
+			for (int j = -1; j < 3; ++j)
+			{
+				cols[j + 1] = this->getPoint(col + i, row + j);
+			}
+			rows[i + 1] = cubicInterpolate(cols, v);
+		}
+		return cubicInterpolate(rows, u);
+	}
+
+	//--------------------------------------------------------------
+	void ControlGrid::evaluate(int resolutionX, int resolutionY, bool linear, const glm::vec2 & scale, glm::vec3 * positions, int beginX, int endX) const
+	{
+		if (endX < 0 || endX > resolutionX)
+		{
+			endX = resolutionX;
+		}
+
+		auto stepU = (this->numControlsX - 1) / (float)(resolutionX - 1);
+		auto stepV = (this->numControlsY - 1) / (float)(resolutionY - 1);
+
+		for (auto x = beginX; x < endX; ++x)
+		{
+			auto column = positions + (x * resolutionY);
+			for (auto y = 0; y < resolutionY; ++y)
+			{
+				// Transform coordinates to [0..numControls]
+				auto pt = this->evaluate(x * stepU, y * stepV, linear) * scale;
+				column[y] = glm::vec3(pt.x, pt.y, 0.0f);
+			}
+		}
+	}
+
+	//--------------------------------------------------------------
+	void ControlGrid::evaluate(const std::vector<float> & samplesU, const std::vector<float> & samplesV, bool linear, const glm::vec2 & scale, glm::vec4 * positions, int beginX, int endX) const
+	{
+		auto resolutionX = (int)samplesU.size();
+		auto resolutionY = (int)samplesV.size();
+		if (endX < 0 || endX > resolutionX)
+		{
+			endX = resolutionX;
+		}
+
+		for (auto x = beginX; x < endX; ++x)
+		{
+			auto column = positions + (x * resolutionY);
+			for (auto y = 0; y < resolutionY; ++y)
+			{
+				auto pt = this->evaluate(samplesU[x], samplesV[y], linear) * scale;
+				column[y] = glm::vec4(pt.x, pt.y, 0.0f, 1.0f);
+			}
+		}
+	}
+
+	//--------------------------------------------------------------
+	void ControlGrid::getAdaptiveSamples(bool linear, const glm::vec2 & scale, float maxError, int maxSubdivisions, std::vector<float> & samplesU, std::vector<float> & samplesV) const
+	{
+		auto numPatchesX = (int)this->numControlsX - 1;
+		auto numPatchesY = (int)this->numControlsY - 1;
+		maxError = std::max(maxError, 1.0e-4f);
+		maxSubdivisions = std::max(maxSubdivisions, 1);
+
+		// Number of steps each column and row of patches is split into.
+		std::vector<int> stepsU(numPatchesX, 1);
+		std::vector<int> stepsV(numPatchesY, 1);
+
+		glm::vec2 knots[4];
+		glm::vec2 column[4];
+		for (auto col = 0; col < numPatchesX; ++col)
+		{
+			for (auto row = 0; row < numPatchesY; ++row)
+			{
+				// Linear interpolation of a segment with step h deviates at most h^2 / 8 times the second derivative.
+				// The curvature along each direction is taken at the patch edges and center line.
+				auto curvatureU = 0.0f;
+				auto curvatureV = 0.0f;
+				if (!linear)
+				{
+					for (auto t : { 0.0f, 0.5f, 1.0f })
+					{
+						for (auto i = 0; i < 4; ++i)
+						{
+							for (auto j = 0; j < 4; ++j)
+							{
+								column[j] = this->getPoint(col - 1 + i, row - 1 + j);
+							}
+							knots[i] = cubicInterpolate(column, t) * scale;
+						}
+						curvatureU = std::max(curvatureU, getMaxCurvature(knots));
+
+						for (auto j = 0; j < 4; ++j)
+						{
+							for (auto i = 0; i < 4; ++i)
+							{
+								column[i] = this->getPoint(col - 1 + i, row - 1 + j);
+							}
+							knots[j] = cubicInterpolate(column, t) * scale;
+						}
+						curvatureV = std::max(curvatureV, getMaxCurvature(knots));
+					}
+				}
+
+				// Splitting a patch along the diagonal misses its center by a quarter of its twist.
+				auto twist = glm::length((this->getPoint(col, row) - this->getPoint(col + 1, row) - this->getPoint(col, row + 1) + this->getPoint(col + 1, row + 1)) * scale);
+
+				// Split the direction contributing the most error, until the estimate is within bounds.
+				auto n = 1;
+				auto m = 1;
+				while (n < maxSubdivisions || m < maxSubdivisions)
+				{
+					auto errorU = curvatureU / (8.0f * n * n);
+					auto errorV = curvatureV / (8.0f * m * m);
+					auto errorTwist = twist / (4.0f * n * m);
+					if (errorU + errorV + errorTwist <= maxError) break;
+
+					auto splitU = (errorU > errorV || (errorU == errorV && n <= m));
+					if ((splitU && n < maxSubdivisions) || m >= maxSubdivisions)
+					{
+						++n;
+					}
+					else
+					{
+						++m;
+					}
+				}
+
+				stepsU[col] = std::max(stepsU[col], n);
+				stepsV[row] = std::max(stepsV[row], m);
+			}
+		}
+
+		// Spread the steps evenly over each patch.
+		samplesU.clear();
+		for (auto col = 0; col < numPatchesX; ++col)
+		{
+			for (auto i = 0; i < stepsU[col]; ++i)
+			{
+				samplesU.push_back(col + i / (float)stepsU[col]);
+			}
+		}
+		samplesU.push_back((float)numPatchesX);
+
+		samplesV.clear();
+		for (auto row = 0; row < numPatchesY; ++row)
+		{
+			for (auto i = 0; i < stepsV[row]; ++i)
+			{
+				samplesV.push_back(row + i / (float)stepsV[row]);
+			}
+		}
+		samplesV.push_back((float)numPatchesY);
+	}
+
+	//--------------------------------------------------------------
+	std::vector<glm::vec2> ControlGrid::resampleX(size_t n, bool linear) const
+	{
+		// There should be a minimum of 2 control points.
+		n = std::max(size_t(2), n);
+
+		// Create a list of new points.
+		std::vector<glm::vec2> tempPoints(n * this->numControlsY);
+
+		std::vector<glm::vec2> knots(this->numControlsX);
+		std::vector<glm::vec2> samples;
+		std::vector<float> lengths;
+
+		// Perform spline fitting.
+		for (size_t row = 0; row < this->numControlsY; ++row)
+		{
+			for (size_t col = 0; col < this->numControlsX; ++col)
+			{
+				knots[col] = this->getPoint(col, row);
+			}
+			tessellate(knots, linear, samples, lengths);
+
+			// Calculate position of new control points.
+			auto step = 1.0f / (n - 1);
+			for (size_t col = 0; col < n; ++col)
+			{
+				auto idx = (col * this->numControlsY) + row;
+				tempPoints[idx] = getPointAtPercent(samples, lengths, col * step);
+			}
+		}
+
+		return tempPoints;
+	}
+
+	//--------------------------------------------------------------
+	std::vector<glm::vec2> ControlGrid::resampleY(size_t n, bool linear) const
+	{
+		// There should be a minimum of 2 control points.
+		n = std::max(size_t(2), n);
+
+		// Create a list of new points.
+		std::vector<glm::vec2> tempPoints(this->numControlsX * n);
+
+		std::vector<glm::vec2> knots(this->numControlsY);
+		std::vector<glm::vec2> samples;
+		std::vector<float> lengths;
+
+		// Perform spline fitting.
+		for (size_t col = 0; col < this->numControlsX; ++col)
+		{
+			for (size_t row = 0; row < this->numControlsY; ++row)
+			{
+				knots[row] = this->getPoint(col, row);
+			}
+			tessellate(knots, linear, samples, lengths);
+
+			// Calculate position of new control points.
+			auto step = 1.0f / (n - 1);
+			for (size_t row = 0; row < n; ++row)
+			{
+				auto idx = (col * n) + row;
+				tempPoints[idx] = getPointAtPercent(samples, lengths, row * step);
+			}
+		}
+
+		return tempPoints;
+	}
+
+	//--------------------------------------------------------------
+	// From http://www.paulinternet.nl/?page=bicubic : fast catmull-rom calculation
+	glm::vec2 ControlGrid::cubicInterpolate(const glm::vec2 knots[4], float t)
+	{
+		return (knots[1] + 0.5f * t * (knots[2] - knots[0] + t * (2.0f * knots[0] - 5.0f * knots[1] + 4.0f * knots[2] - knots[3] + t * (3.0f * (knots[1] - knots[2]) + knots[3] - knots[0]))));
+	}
+
+	//--------------------------------------------------------------
+	float ControlGrid::getMaxCurvature(const glm::vec2 knots[4])
+	{
+		// The second derivative of the cubic in cubicInterpolate() is linear in t, so it peaks at either end.
+		auto c = (2.0f * knots[0] - 5.0f * knots[1] + 4.0f * knots[2] - knots[3]);
+		auto d = (3.0f * (knots[1] - knots[2]) + knots[3] - knots[0]);
+		return std::max(glm::length(c), glm::length(c + 3.0f * d));
+	}
+
+	//--------------------------------------------------------------
+	float ControlGrid::tessellate(const std::vector<glm::vec2> & knots, bool linear, std::vector<glm::vec2> & samples, std::vector<float> & lengths)
+	{
+		// Same number of points per segment as ofPolyline::curveTo().
+		static const int curveResolution = 20;
+
+		samples.clear();
+		lengths.clear();
+
+		auto addSample = [&](const glm::vec2 & pt)
+		{
+			lengths.push_back(samples.empty() ? 0.0f : (lengths.back() + glm::distance(samples.back(), pt)));
+			samples.push_back(pt);
+		};
+
+		auto numKnots = (int)knots.size();
+		if (linear || numKnots < 2)
+		{
+			for (const auto & knot : knots)
+			{
+				addSample(knot);
+			}
+			return lengths.empty() ? 0.0f : lengths.back();
+		}
+
+		// Extrapolate the knots beyond the ends, like getPoint().
+		auto getKnot = [&](int i)
+		{
+			if (i < 0) return (2.0f * knots.front() - knots[-i]);
+			if (i >= numKnots) return (2.0f * knots.back() - knots[2 * (numKnots - 1) - i]);
+			return knots[i];
+		};
+
+		// Each span is split at the control points of an optimized Catmull-Rom implementation, and the
+		// polyline is traced through the result the way ofPolyline::lineTo() and curveTo() used to:
+		// a Catmull-Rom segment between each middle pair of 4 consecutive points, and a straight first and last piece.
+		std::vector<glm::vec2> sequence;
+		sequence.reserve(3 * numKnots - 2);
+		for (auto i = 0; i < numKnots - 1; ++i)
+		{
+			auto p0 = getKnot(i - 1);
+			auto p1 = getKnot(i);
+			auto p2 = getKnot(i + 1);
+			auto p3 = getKnot(i + 2);
+
+			sequence.push_back(p1);
+			sequence.push_back(p1 + (p2 - p0) / 6.0f);
+			sequence.push_back(p2 - (p3 - p1) / 6.0f);
+		}
+		sequence.push_back(knots.back());
+
+		addSample(sequence.front());
+		for (size_t i = 0; i + 3 < sequence.size(); ++i)
+		{
+			for (auto j = 0; j < curveResolution; ++j)
+			{
+				addSample(cubicInterpolate(&sequence[i], j / (float)(curveResolution - 1)));
+			}
+		}
+		addSample(sequence.back());
+
+		return lengths.back();
+	}
+
+	//--------------------------------------------------------------
+	glm::vec2 ControlGrid::getPointAtPercent(const std::vector<glm::vec2> & samples, const std::vector<float> & lengths, float percent)
+	{
+		if (samples.empty()) return glm::vec2(0.0f);
+
+		auto length = percent * lengths.back();
+		auto it = std::lower_bound(lengths.begin(), lengths.end(), length);
+		if (it == lengths.begin()) return samples.front();
+		if (it == lengths.end()) return samples.back();
+
+		auto i = it - lengths.begin();
+		auto span = lengths[i] - lengths[i - 1];
+		auto t = (span > 0.0f) ? (length - lengths[i - 1]) / span : 0.0f;
+		return glm::mix(samples[i - 1], samples[i], t);
+	}
+}
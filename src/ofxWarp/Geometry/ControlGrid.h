@@ -0,0 +1,66 @@
+#pragma once
+
+#include "glm/vec2.hpp"
+#include "glm/vec3.hpp"
+#include "glm/vec4.hpp"
+
+#include <vector>
+
+namespace ofxWarp
+{
+	//! Read-only view over a column-major grid of normalized control points.
+	//! The grid does not own the points.
+	class ControlGrid
+	{
+	public:
+		ControlGrid(const glm::vec2 * points, size_t numControlsX, size_t numControlsY);
+		ControlGrid(const std::vector<glm::vec2> & points, size_t numControlsX, size_t numControlsY);
+
+		//! return the number of control points columns
+		size_t getNumControlsX() const;
+		//! return the number of control points rows
+		size_t getNumControlsY() const;
+		//! return the total number of control points
+		size_t getNumControlPoints() const;
+
+		//! return the specified control point, points beyond the edges are extrapolated
+		glm::vec2 getPoint(int col, int row) const;
+
+		//! evaluate the grid at (u, v), where u is in [0..numControlsX - 1] and v is in [0..numControlsY - 1]
+		glm::vec2 evaluate(float u, float v, bool linear) const;
+		//! evaluate columns [beginX..endX) of a resolutionX * resolutionY column-major vertex grid, scaled by scale
+		//! passing endX < 0 evaluates until the last column, so disjoint ranges can be filled from separate threads
+		void evaluate(int resolutionX, int resolutionY, bool linear, const glm::vec2 & scale, glm::vec3 * positions, int beginX = 0, int endX = -1) const;
+		//! evaluate columns [beginX..endX) of a column-major vertex grid at the specified grid coordinates, scaled by scale
+		//! the positions are homogeneous with w = 1, so that a projective transform can be applied to them afterwards
+		void evaluate(const std::vector<float> & samplesU, const std::vector<float> & samplesV, bool linear, const glm::vec2 & scale, glm::vec4 * positions, int beginX = 0, int endX = -1) const;
+
+		//! fill the grid coordinates at which to sample the grid, so that a triangle mesh through the samples stays within
+		//! maxError of the surface after scaling by scale. Each patch between control points is split into at most
+		//! maxSubdivisions steps, flat patches are not split at all. Columns and rows of patches share their steps,
+		//! so the result is still a regular vertex grid without cracks.
+		void getAdaptiveSamples(bool linear, const glm::vec2 & scale, float maxError, int maxSubdivisions, std::vector<float> & samplesU, std::vector<float> & samplesV) const;
+
+		//! return the points resampled to n columns, fitted along a linear or Catmull-Rom spline
+		std::vector<glm::vec2> resampleX(size_t n, bool linear) const;
+		//! return the points resampled to n rows, fitted along a linear or Catmull-Rom spline
+		std::vector<glm::vec2> resampleY(size_t n, bool linear) const;
+
+		//! perform fast Catmull-Rom interpolation, and return the interpolated value at t
+		static glm::vec2 cubicInterpolate(const glm::vec2 knots[4], float t);
+		//! return the largest second derivative of the Catmull-Rom segment between knots 1 and 2
+		static float getMaxCurvature(const glm::vec2 knots[4]);
+
+	protected:
+		//! fill samples with a polyline through the knots and return its length, either straight or curved
+		//! exactly like the ofPolyline::curveTo() spline the warps were resampled with before
+		static float tessellate(const std::vector<glm::vec2> & knots, bool linear, std::vector<glm::vec2> & samples, std::vector<float> & lengths);
+		//! return the point at percent of the total length of a tessellated spline
+		static glm::vec2 getPointAtPercent(const std::vector<glm::vec2> & samples, const std::vector<float> & lengths, float percent);
+
+	protected:
+		const glm::vec2 * points;
+		size_t numControlsX;
+		size_t numControlsY;
+	};
+}
@@ -0,0 +1,150 @@
+#include "DomeProjection.h"
+
+#include "glm/geometric.hpp"
+
+#include <cmath>
+
+namespace ofxWarp
+{
+	namespace
+	{
+		const float DEG_TO_RADIANS = 3.14159265358979f / 180.0f;
+
+		//--------------------------------------------------------------
+		glm::vec3 rotateX(const glm::vec3 & v, float angle)
+		{
+			auto c = std::cos(angle);
+			auto s = std::sin(angle);
+			return glm::vec3(v.x, v.y * c - v.z * s, v.y * s + v.z * c);
+		}
+
+		//--------------------------------------------------------------
+		glm::vec3 rotateY(const glm::vec3 & v, float angle)
+		{
+			auto c = std::cos(angle);
+			auto s = std::sin(angle);
+			return glm::vec3(v.x * c + v.z * s, v.y, -v.x * s + v.z * c);
+		}
+
+		//--------------------------------------------------------------
+		glm::vec3 rotateZ(const glm::vec3 & v, float angle)
+		{
+			auto c = std::cos(angle);
+			auto s = std::sin(angle);
+			return glm::vec3(v.x * c - v.y * s, v.x * s + v.y * c, v.z);
+		}
+	}
+
+	//--------------------------------------------------------------
+	DomeProjection::DomeProjection()
+		: domeRadius(1.0f)
+		, domeFieldOfView(180.0f)
+		, domeTilt(0.0f)
+		, projectorPosition(0.0f)
+		, projectorOrientation(0.0f, 90.0f, 0.0f)
+		, projectorFieldOfView(90.0f)
+		, projectorLensShift(0.0f)
+		, projectorAspectRatio(1.0f)
+	{}
+
+	//--------------------------------------------------------------
+	glm::vec3 DomeProjection::getDirection(const glm::vec2 & contentPoint) const
+	{
+		// The distance from the center of the image is proportional to the angle from the zenith.
+		auto offset = (contentPoint - 0.5f) * 2.0f;
+		auto theta = glm::length(offset) * 0.5f * this->domeFieldOfView * DEG_TO_RADIANS;
+		auto phi = std::atan2(offset.y, offset.x);
+		auto direction = glm::vec3(std::sin(theta) * std::cos(phi), std::sin(theta) * std::sin(phi), std::cos(theta));
+
+		return rotateX(direction, -this->domeTilt * DEG_TO_RADIANS);
+	}
+
+	//--------------------------------------------------------------
+	glm::vec3 DomeProjection::project(const glm::vec2 & contentPoint) const
+	{
+		auto point = this->getDirection(contentPoint) * this->domeRadius - this->projectorPosition;
+
+		// Rotate the projector axes by roll, pitch and yaw, in that order.
+		auto yaw = this->projectorOrientation.x * DEG_TO_RADIANS;
+		auto pitch = this->projectorOrientation.y * DEG_TO_RADIANS;
+		auto roll = this->projectorOrientation.z * DEG_TO_RADIANS;
+		auto right = rotateZ(rotateX(rotateY(glm::vec3(1.0f, 0.0f, 0.0f), roll), pitch), yaw);
+		auto up = rotateZ(rotateX(rotateY(glm::vec3(0.0f, 0.0f, 1.0f), roll), pitch), yaw);
+		auto forward = rotateZ(rotateX(glm::vec3(0.0f, 1.0f, 0.0f), pitch), yaw);
+
+		auto x = glm::dot(point, right);
+		auto y = glm::dot(point, up);
+		auto depth = glm::dot(point, forward);
+
+		// Pinhole projection into normalized image coordinates, kept homogeneous so there is no divide by the depth.
+		auto focalLength = 0.5f / std::tan(0.5f * this->projectorFieldOfView * DEG_TO_RADIANS);
+		auto projected = glm::vec3(
+			(0.5f - this->projectorLensShift.x) * depth + focalLength * x,
+			(0.5f + this->projectorLensShift.y) * depth - focalLength * this->projectorAspectRatio * y,
+			depth);
+
+		// Pre-compensate for the lens, this needs the actual image position.
+		if (depth > 1.0e-6f)
+		{
+			auto imagePoint = this->projectorLens.undistort(glm::vec2(projected) / depth);
+			projected = glm::vec3(imagePoint * depth, depth);
+		}
+
+		return projected;
+	}
+
+	//--------------------------------------------------------------
+	void DomeProjection::serialize(std::vector<float> & parameters) const
+	{
+		parameters.push_back(this->domeRadius);
+		parameters.push_back(this->domeFieldOfView);
+		parameters.push_back(this->domeTilt);
+		parameters.push_back(this->projectorPosition.x);
+		parameters.push_back(this->projectorPosition.y);
+		parameters.push_back(this->projectorPosition.z);
+		parameters.push_back(this->projectorOrientation.x);
+		parameters.push_back(this->projectorOrientation.y);
+		parameters.push_back(this->projectorOrientation.z);
+		parameters.push_back(this->projectorFieldOfView);
+		parameters.push_back(this->projectorLensShift.x);
+		parameters.push_back(this->projectorLensShift.y);
+		parameters.push_back(this->projectorAspectRatio);
+		this->projectorLens.serialize(parameters);
+	}
+
+	//--------------------------------------------------------------
+	bool DomeProjection::deserialize(const float * parameters, size_t numParameters)
+	{
+		if (numParameters != NUM_PARAMETERS) return false;
+
+		this->domeRadius = parameters[0];
+		this->domeFieldOfView = parameters[1];
+		this->domeTilt = parameters[2];
+		this->projectorPosition = glm::vec3(parameters[3], parameters[4], parameters[5]);
+		this->projectorOrientation = glm::vec3(parameters[6], parameters[7], parameters[8]);
+		this->projectorFieldOfView = parameters[9];
+		this->projectorLensShift = glm::vec2(parameters[10], parameters[11]);
+		this->projectorAspectRatio = (parameters[12] > 0.0f) ? parameters[12] : 1.0f;
+		return this->projectorLens.deserialize(parameters + 13, LensModel::NUM_PARAMETERS);
+	}
+
+	//--------------------------------------------------------------
+	bool DomeProjection::operator==(const DomeProjection & other) const
+	{
+		return (this->domeRadius == other.domeRadius
+			&& this->domeFieldOfView == other.domeFieldOfView
+			&& this->domeTilt == other.domeTilt
+			&& this->projectorPosition == other.projectorPosition
+			&& this->projectorOrientation == other.projectorOrientation
+			&& this->projectorFieldOfView == other.projectorFieldOfView
+			&& this->projectorLensShift == other.projectorLensShift
+			&& this->projectorAspectRatio == other.projectorAspectRatio
+			&& this->projectorLens == other.projectorLens);
+	}
+
+	//--------------------------------------------------------------
+	bool DomeProjection::operator!=(const DomeProjection & other) const
+	{
+		return !(*this == other);
+	}
+}
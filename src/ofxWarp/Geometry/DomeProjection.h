@@ -0,0 +1,59 @@
+#pragma once
+
+#include "glm/vec2.hpp"
+#include "glm/vec3.hpp"
+
+#include <vector>
+
+#include "LensModel.h"
+
+namespace ofxWarp
+{
+	//! Projection of domemaster content onto a hemisphere, as seen by a projector inside the dome.
+	//! The dome is centered on the origin with its zenith along +z, and +y pointing to the front. Domemaster content is an
+	//! azimuthal equidistant fisheye with the zenith in the middle and the front at the bottom of the image.
+	struct DomeProjection
+	{
+		//! number of floats written by serialize()
+		static const size_t NUM_PARAMETERS = 13 + LensModel::NUM_PARAMETERS;
+
+		DomeProjection();
+
+		//! return the unit direction from the dome center for a point in normalized domemaster coordinates
+		glm::vec3 getDirection(const glm::vec2 & contentPoint) const;
+
+		//! return where a point in normalized domemaster coordinates ends up in the projector image, as homogeneous
+		//! normalized coordinates (x * w, y * w, w) where w is the depth in front of the projector.
+		//! Points behind the projector have a negative w, so they are clipped when drawn.
+		glm::vec3 project(const glm::vec2 & contentPoint) const;
+
+		//! append the parameters to a flat list of floats
+		void serialize(std::vector<float> & parameters) const;
+		//! read the parameters from NUM_PARAMETERS floats, return false if the count doesn't match
+		bool deserialize(const float * parameters, size_t numParameters);
+
+		bool operator==(const DomeProjection & other) const;
+		bool operator!=(const DomeProjection & other) const;
+
+		//! radius of the dome, in the same units as the projector position
+		float domeRadius;
+		//! field of view of the domemaster content in degrees, 180 covers the hemisphere
+		float domeFieldOfView;
+		//! rotation of the dome around the x axis in degrees, positive values tilt the front down
+		float domeTilt;
+
+		//! position of the projector lens
+		glm::vec3 projectorPosition;
+		//! rotation of the projector around the vertical axis, then its horizontal axis and then its view axis, in degrees
+		//! with all angles at 0, the projector looks at the front of the dome with its image upright, positive pitch looks up
+		glm::vec3 projectorOrientation;
+		//! horizontal field of view of the projector in degrees
+		float projectorFieldOfView;
+		//! lens shift as a fraction of the image size, positive values move the image right and up
+		glm::vec2 projectorLensShift;
+		//! width over height of the projector image
+		float projectorAspectRatio;
+		//! distortion of the projector lens, it is pre-compensated
+		LensModel projectorLens;
+	};
+}
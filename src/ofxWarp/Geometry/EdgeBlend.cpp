@@ -0,0 +1,37 @@
+#include "EdgeBlend.h"
+
+#include "glm/common.hpp"
+
+#include <cmath>
+
+namespace ofxWarp
+{
+	//--------------------------------------------------------------
+	EdgeBlend::EdgeBlend()
+		: edges(0.0f)
+		, exponent(2.0f)
+		, luminance(0.5f)
+		, gamma(1.0f)
+	{}
+
+	//--------------------------------------------------------------
+	glm::vec3 EdgeBlend::getFactors(const glm::vec2 & contentPoint) const
+	{
+		// Same steps as the fragment shaders.
+		auto a = 1.0f;
+		if (this->edges.x > 0.0f) a *= glm::clamp(contentPoint.x / this->edges.x, 0.0f, 1.0f);
+		if (this->edges.y > 0.0f) a *= glm::clamp(contentPoint.y / this->edges.y, 0.0f, 1.0f);
+		if (this->edges.z > 0.0f) a *= glm::clamp((1.0f - contentPoint.x) / this->edges.z, 0.0f, 1.0f);
+		if (this->edges.w > 0.0f) a *= glm::clamp((1.0f - contentPoint.y) / this->edges.w, 0.0f, 1.0f);
+
+		if (a >= 1.0f) return glm::vec3(1.0f);
+
+		glm::vec3 factors;
+		for (int i = 0; i < 3; ++i)
+		{
+			auto blend = (a < 0.5f) ? (this->luminance[i] * std::pow(2.0f * a, this->exponent)) : 1.0f - (1.0f - this->luminance[i]) * std::pow(2.0f * (1.0f - a), this->exponent);
+			factors[i] = std::pow(blend, 1.0f / this->gamma[i]);
+		}
+		return factors;
+	}
+}
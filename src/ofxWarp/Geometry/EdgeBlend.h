@@ -0,0 +1,26 @@
+#pragma once
+
+#include "glm/vec2.hpp"
+#include "glm/vec3.hpp"
+#include "glm/vec4.hpp"
+
+namespace ofxWarp
+{
+	//! Edge blending curve of the warp shaders, for evaluating it on the CPU.
+	struct EdgeBlend
+	{
+		EdgeBlend();
+
+		//! return the factors the red, green and blue channels are multiplied by at a point in normalized content coordinates
+		glm::vec3 getFactors(const glm::vec2 & contentPoint) const;
+
+		//! blending area for the left, top, right and bottom edges, as the shaders get it
+		glm::vec4 edges;
+		//! curve exponent (1.0 = linear, 2.0 = quadratic)
+		float exponent;
+		//! luminance at the middle of the blending area, for the red, green and blue channels (0.5 = linear)
+		glm::vec3 luminance;
+		//! gamma curve for the red, green and blue channels
+		glm::vec3 gamma;
+	};
+}
@@ -0,0 +1,92 @@
+#include "GridMesh.h"
+
+#include "glm/common.hpp"
+
+namespace ofxWarp
+{
+	//--------------------------------------------------------------
+	glm::ivec2 GridMesh::getResolution(int numControlsX, int numControlsY, int resolutionX, int resolutionY)
+	{
+		// Convert from number of quads to number of vertices.
+		++resolutionX;
+		++resolutionY;
+
+		// Find a value for resolutionX and resolutionY that can be evenly divided by numControlsX and numControlsY.
+		if (numControlsX < resolutionX)
+		{
+			int dx = (resolutionX - 1) % (numControlsX - 1);
+			if (dx >= (numControlsX / 2))
+			{
+				dx -= (numControlsX - 1);
+			}
+			resolutionX -= dx;
+		}
+		else
+		{
+			resolutionX = numControlsX;
+		}
+
+		if (numControlsY < resolutionY)
+		{
+			int dy = (resolutionY - 1) % (numControlsY - 1);
+			if (dy >= (numControlsY / 2))
+			{
+				dy -= (numControlsY - 1);
+			}
+			resolutionY -= dy;
+		}
+		else
+		{
+			resolutionY = numControlsY;
+		}
+
+		return glm::ivec2(resolutionX, resolutionY);
+	}
+
+	//--------------------------------------------------------------
+	void GridMesh::getSamples(int numControls, int resolution, std::vector<float> & samples)
+	{
+		samples.resize(resolution);
+
+		auto step = (numControls - 1) / (float)(resolution - 1);
+		for (int i = 0; i < resolution; ++i)
+		{
+			samples[i] = i * step;
+		}
+	}
+
+	//--------------------------------------------------------------
+	void GridMesh::getTexCoords(int resolutionX, int resolutionY, const glm::vec4 & corners, std::vector<glm::vec2> & texCoords)
+	{
+		texCoords.resize(resolutionX * resolutionY);
+
+		auto j = 0;
+		for (int x = 0; x < resolutionX; ++x)
+		{
+			for (int y = 0; y < resolutionY; ++y)
+			{
+				float tx = glm::mix(corners.x, corners.z, x / (float)(resolutionX - 1));
+				float ty = glm::mix(corners.y, corners.w, y / (float)(resolutionY - 1));
+				texCoords[j++] = glm::vec2(tx, ty);
+			}
+		}
+	}
+
+	//--------------------------------------------------------------
+	void GridMesh::getTexCoords(const std::vector<float> & samplesU, const std::vector<float> & samplesV, const glm::vec4 & corners, std::vector<glm::vec2> & texCoords)
+	{
+		texCoords.resize(samplesU.size() * samplesV.size());
+		if (texCoords.empty()) return;
+
+		auto j = 0;
+		for (auto u : samplesU)
+		{
+			float tx = glm::mix(corners.x, corners.z, u / samplesU.back());
+			for (auto v : samplesV)
+			{
+				float ty = glm::mix(corners.y, corners.w, v / samplesV.back());
+				texCoords[j++] = glm::vec2(tx, ty);
+			}
+		}
+	}
+}
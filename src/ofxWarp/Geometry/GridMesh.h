@@ -0,0 +1,48 @@
+#pragma once
+
+#include "glm/vec2.hpp"
+#include "glm/vec4.hpp"
+
+#include <vector>
+
+namespace ofxWarp
+{
+	//! Topology and texture coordinates of the column-major vertex grid used to draw bilinear warps.
+	class GridMesh
+	{
+	public:
+		//! convert a number of quads to a number of vertices that can be evenly divided by the number of controls
+		static glm::ivec2 getResolution(int numControlsX, int numControlsY, int resolutionX, int resolutionY);
+
+		//! fill samples with resolution evenly spaced grid coordinates, spanning [0..numControls - 1]
+		static void getSamples(int numControls, int resolution, std::vector<float> & samples);
+
+		//! fill the triangle indices for a resolutionX * resolutionY vertex grid
+		template<typename IndexType>
+		static void getIndices(int resolutionX, int resolutionY, std::vector<IndexType> & indices)
+		{
+			indices.resize(2 * 3 * (resolutionX - 1) * (resolutionY - 1));
+
+			auto i = 0;
+			for (int x = 0; x < resolutionX - 1; ++x)
+			{
+				for (int y = 0; y < resolutionY - 1; ++y)
+				{
+					indices[i++] = (x + 0) * resolutionY + (y + 0);
+					indices[i++] = (x + 1) * resolutionY + (y + 0);
+					indices[i++] = (x + 1) * resolutionY + (y + 1);
+
+					indices[i++] = (x + 0) * resolutionY + (y + 0);
+					indices[i++] = (x + 1) * resolutionY + (y + 1);
+					indices[i++] = (x + 0) * resolutionY + (y + 1);
+				}
+			}
+		}
+
+		//! fill the texture coordinates for a resolutionX * resolutionY vertex grid, spanning the corners (left, top, right, bottom)
+		static void getTexCoords(int resolutionX, int resolutionY, const glm::vec4 & corners, std::vector<glm::vec2> & texCoords);
+		//! fill the texture coordinates for a vertex grid sampled at the specified grid coordinates, spanning the corners (left, top, right, bottom)
+		//! the last sample in each direction is taken to be the edge of the grid
+		static void getTexCoords(const std::vector<float> & samplesU, const std::vector<float> & samplesV, const glm::vec4 & corners, std::vector<glm::vec2> & texCoords);
+	};
+}
@@ -0,0 +1,217 @@
+#include "Homography.h"
+
+#include "glm/matrix.hpp"
+#include "glm/vec4.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace ofxWarp
+{
+	//--------------------------------------------------------------
+	Homography::Homography()
+		: sourceSize(1.0f)
+		, destinationSize(1.0f)
+	{
+		this->corners[0] = glm::vec2(0.0f, 0.0f);
+		this->corners[1] = glm::vec2(1.0f, 0.0f);
+		this->corners[2] = glm::vec2(1.0f, 1.0f);
+		this->corners[3] = glm::vec2(0.0f, 1.0f);
+
+		this->update();
+	}
+
+	//--------------------------------------------------------------
+	void Homography::setSourceSize(const glm::vec2 & size)
+	{
+		if (size == this->sourceSize) return;
+
+		this->sourceSize = size;
+		this->update();
+	}
+
+	//--------------------------------------------------------------
+	const glm::vec2 & Homography::getSourceSize() const
+	{
+		return this->sourceSize;
+	}
+
+	//--------------------------------------------------------------
+	void Homography::setDestinationSize(const glm::vec2 & size)
+	{
+		if (size == this->destinationSize) return;
+
+		this->destinationSize = size;
+		this->update();
+	}
+
+	//--------------------------------------------------------------
+	const glm::vec2 & Homography::getDestinationSize() const
+	{
+		return this->destinationSize;
+	}
+
+	//--------------------------------------------------------------
+	void Homography::setCorner(size_t index, const glm::vec2 & corner)
+	{
+		if (index >= 4 || corner == this->corners[index]) return;
+
+		this->corners[index] = corner;
+		this->update();
+	}
+
+	//--------------------------------------------------------------
+	void Homography::setCorners(const glm::vec2 corners[4])
+	{
+		if (std::equal(corners, corners + 4, this->corners)) return;
+
+		std::copy(corners, corners + 4, this->corners);
+		this->update();
+	}
+
+	//--------------------------------------------------------------
+	const glm::vec2 & Homography::getCorner(size_t index) const
+	{
+		return this->corners[index % 4];
+	}
+
+	//--------------------------------------------------------------
+	const glm::mat4 & Homography::getTransform() const
+	{
+		return this->transformMatrix;
+	}
+
+	//--------------------------------------------------------------
+	const glm::mat4 & Homography::getTransformInverted() const
+	{
+		return this->transformInverted;
+	}
+
+	//--------------------------------------------------------------
+	glm::vec2 Homography::map(const glm::vec2 & point) const
+	{
+		return transform(this->getTransform(), point);
+	}
+
+	//--------------------------------------------------------------
+	glm::vec2 Homography::unmap(const glm::vec2 & point) const
+	{
+		return transform(this->getTransformInverted(), point);
+	}
+
+	//--------------------------------------------------------------
+	void Homography::update()
+	{
+		const glm::vec2 src[4] =
+		{
+			glm::vec2(0.0f, 0.0f),
+			glm::vec2(this->sourceSize.x, 0.0f),
+			glm::vec2(this->sourceSize.x, this->sourceSize.y),
+			glm::vec2(0.0f, this->sourceSize.y)
+		};
+
+		// Convert corners to actual destination pixels.
+		glm::vec2 dst[4];
+		for (int i = 0; i < 4; ++i)
+		{
+			dst[i] = this->corners[i] * this->destinationSize;
+		}
+
+		// Calculate warp matrix.
+		this->transformMatrix = solve(src, dst);
+		this->transformInverted = glm::inverse(this->transformMatrix);
+	}
+
+	//--------------------------------------------------------------
+	glm::vec2 Homography::transform(const glm::mat4 & matrix, const glm::vec2 & point)
+	{
+		auto pt = matrix * glm::vec4(point.x, point.y, 0.0f, 1.0f);
+
+		if (pt.w != 0) pt.w = 1.0f / pt.w;
+		pt *= pt.w;
+
+		return glm::vec2(pt.x, pt.y);
+	}
+
+	//--------------------------------------------------------------
+	// Adapted from: http://forum.openframeworks.cc/t/quad-warping-homography-without-opencv/3121/19
+	glm::mat4 Homography::solve(const glm::vec2 src[4], const glm::vec2 dst[4])
+	{
+		float p[8][9] =
+		{
+			{ -src[0][0], -src[0][1], -1, 0, 0, 0, src[0][0] * dst[0][0], src[0][1] * dst[0][0], -dst[0][0] }, // h11
+			{ 0, 0, 0, -src[0][0], -src[0][1], -1, src[0][0] * dst[0][1], src[0][1] * dst[0][1], -dst[0][1] }, // h12
+			{ -src[1][0], -src[1][1], -1, 0, 0, 0, src[1][0] * dst[1][0], src[1][1] * dst[1][0], -dst[1][0] }, // h13
+			{ 0, 0, 0, -src[1][0], -src[1][1], -1, src[1][0] * dst[1][1], src[1][1] * dst[1][1], -dst[1][1] }, // h21
+			{ -src[2][0], -src[2][1], -1, 0, 0, 0, src[2][0] * dst[2][0], src[2][1] * dst[2][0], -dst[2][0] }, // h22
+			{ 0, 0, 0, -src[2][0], -src[2][1], -1, src[2][0] * dst[2][1], src[2][1] * dst[2][1], -dst[2][1] }, // h23
+			{ -src[3][0], -src[3][1], -1, 0, 0, 0, src[3][0] * dst[3][0], src[3][1] * dst[3][0], -dst[3][0] }, // h31
+			{ 0, 0, 0, -src[3][0], -src[3][1], -1, src[3][0] * dst[3][1], src[3][1] * dst[3][1], -dst[3][1] }, // h32
+		};
+
+		gaussianElimination(&p[0][0], 9);
+
+		return glm::mat4(p[0][8], p[3][8], 0, p[6][8],
+						 p[1][8], p[4][8], 0, p[7][8],
+						 0, 0, 1, 0,
+						 p[2][8], p[5][8], 0, 1);
+	}
+
+	//--------------------------------------------------------------
+	void Homography::gaussianElimination(float * input, int n)
+	{
+		auto i = 0;
+		auto j = 0;
+		auto m = n - 1;
+
+		while (i < m && j < n)
+		{
+			auto iMax = i;
+			for (auto k = i + 1; k < m; ++k)
+			{
+				if (std::fabs(input[k * n + j]) > std::fabs(input[iMax * n + j]))
+				{
+					iMax = k;
+				}
+			}
+
+			if (input[iMax * n + j] != 0)
+			{
+				if (i != iMax)
+				{
+					for (auto k = 0; k < n; ++k)
+					{
+						std::swap(input[i * n + k], input[iMax * n + k]);
+					}
+				}
+
+				float ijIn = input[i * n + j];
+				for (auto k = 0; k < n; ++k)
+				{
+					input[i * n + k] /= ijIn;
+				}
+
+				for (auto u = i + 1; u < m; ++u)
+				{
+					auto ujIn = input[u * n + j];
+					for (auto k = 0; k < n; ++k)
+					{
+						input[u * n + k] -= ujIn * input[i * n + k];
+					}
+				}
+
+				++i;
+			}
+			++j;
+		}
+
+		for (auto i = m - 2; i >= 0; --i)
+		{
+			for (auto j = i + 1; j < n - 1; ++j)
+			{
+				input[i * n + m] -= input[i * n + j] * input[j * n + m];
+			}
+		}
+	}
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "glm/mat4x4.hpp"
+#include "glm/vec2.hpp"
+
+namespace ofxWarp
+{
+	//! Perspective transform between a rectangle of content and four destination corners.
+	class Homography
+	{
+	public:
+		Homography();
+
+		//! set the size of the source content in pixels
+		void setSourceSize(const glm::vec2 & size);
+		//! return the size of the source content in pixels
+		const glm::vec2 & getSourceSize() const;
+
+		//! set the size of the destination in pixels, which the normalized corners are scaled by
+		void setDestinationSize(const glm::vec2 & size);
+		//! return the size of the destination in pixels
+		const glm::vec2 & getDestinationSize() const;
+
+		//! set the normalized destination corner (top-left, top-right, bottom-right, bottom-left)
+		void setCorner(size_t index, const glm::vec2 & corner);
+		//! return the normalized destination corner (top-left, top-right, bottom-right, bottom-left)
+		const glm::vec2 & getCorner(size_t index) const;
+		//! set all four normalized destination corners, solving the transform only once
+		void setCorners(const glm::vec2 corners[4]);
+
+		//! return the matrix mapping source pixels to destination pixels
+		const glm::mat4 & getTransform() const;
+		//! return the matrix mapping destination pixels to source pixels
+		const glm::mat4 & getTransformInverted() const;
+
+		//! map a point from source pixels to destination pixels
+		glm::vec2 map(const glm::vec2 & point) const;
+		//! map a point from destination pixels to source pixels
+		glm::vec2 unmap(const glm::vec2 & point) const;
+
+		//! return the perspective transform that maps the src quad onto the dst quad
+		static glm::mat4 solve(const glm::vec2 src[4], const glm::vec2 dst[4]);
+		//! transform a point by the matrix, including the perspective divide
+		static glm::vec2 transform(const glm::mat4 & matrix, const glm::vec2 & point);
+
+	protected:
+		//! recalculate the matrices, which every setter does right away so that the getters never write
+		void update();
+
+		static void gaussianElimination(float * input, int n);
+
+	protected:
+		glm::vec2 sourceSize;
+		glm::vec2 destinationSize;
+		glm::vec2 corners[4];
+
+		glm::mat4 transformMatrix;
+		glm::mat4 transformInverted;
+	};
+}
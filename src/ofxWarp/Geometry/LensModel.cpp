@@ -0,0 +1,126 @@
+#include "LensModel.h"
+
+#include "glm/geometric.hpp"
+
+#include <cmath>
+
+namespace ofxWarp
+{
+	namespace
+	{
+		//--------------------------------------------------------------
+		glm::vec2 distortNormalized(const LensModel & lens, const glm::vec2 & pt)
+		{
+			auto r2 = glm::dot(pt, pt);
+
+			if (lens.model == LensModel::MODEL_FISHEYE)
+			{
+				auto r = std::sqrt(r2);
+				if (r < 1.0e-8f) return pt;
+
+				auto theta = std::atan(r);
+				auto theta2 = theta * theta;
+				auto thetaDistorted = theta * (1.0f + theta2 * (lens.radial.x + theta2 * (lens.radial.y + theta2 * (lens.radial.z + theta2 * lens.radial.w))));
+				return pt * (thetaDistorted / r);
+			}
+
+			auto radial = 1.0f + r2 * (lens.radial.x + r2 * (lens.radial.y + r2 * lens.radial.z));
+			auto xy = pt.x * pt.y;
+			auto tangential = glm::vec2(
+				2.0f * lens.tangential.x * xy + lens.tangential.y * (r2 + 2.0f * pt.x * pt.x),
+				lens.tangential.x * (r2 + 2.0f * pt.y * pt.y) + 2.0f * lens.tangential.y * xy);
+			return (pt * radial + tangential);
+		}
+	}
+
+	//--------------------------------------------------------------
+	LensModel::LensModel()
+		: model(MODEL_BROWN_CONRADY)
+		, center(0.5f, 0.5f)
+		, focalLength(1.0f)
+		, aspectRatio(1.0f)
+		, radial(0.0f)
+		, tangential(0.0f)
+	{}
+
+	//--------------------------------------------------------------
+	glm::vec2 LensModel::distort(const glm::vec2 & point) const
+	{
+		auto scale = glm::vec2(this->aspectRatio, 1.0f) / this->focalLength;
+		return (distortNormalized(*this, (point - this->center) * scale) / scale + this->center);
+	}
+
+	//--------------------------------------------------------------
+	glm::vec2 LensModel::undistort(const glm::vec2 & point) const
+	{
+		auto scale = glm::vec2(this->aspectRatio, 1.0f) / this->focalLength;
+		auto target = (point - this->center) * scale;
+
+		// Newton's method, with the Jacobian taken by central differences. It starts from the target itself, which is
+		// close to the solution as long as the distortion is moderate.
+		static const int maxIterations = 20;
+		static const float epsilon = 1.0e-4f;
+		auto pt = target;
+		for (auto i = 0; i < maxIterations; ++i)
+		{
+			auto error = distortNormalized(*this, pt) - target;
+			if (glm::dot(error, error) < 1.0e-12f) break;
+
+			auto dx = (distortNormalized(*this, pt + glm::vec2(epsilon, 0.0f)) - distortNormalized(*this, pt - glm::vec2(epsilon, 0.0f))) / (2.0f * epsilon);
+			auto dy = (distortNormalized(*this, pt + glm::vec2(0.0f, epsilon)) - distortNormalized(*this, pt - glm::vec2(0.0f, epsilon))) / (2.0f * epsilon);
+			auto determinant = dx.x * dy.y - dy.x * dx.y;
+			if (std::abs(determinant) < 1.0e-8f) break;
+
+			pt -= glm::vec2(dy.y * error.x - dy.x * error.y, dx.x * error.y - dx.y * error.x) / determinant;
+		}
+
+		return (pt / scale + this->center);
+	}
+
+	//--------------------------------------------------------------
+	void LensModel::serialize(std::vector<float> & parameters) const
+	{
+		parameters.push_back(this->model);
+		parameters.push_back(this->center.x);
+		parameters.push_back(this->center.y);
+		parameters.push_back(this->focalLength);
+		parameters.push_back(this->aspectRatio);
+		parameters.push_back(this->radial.x);
+		parameters.push_back(this->radial.y);
+		parameters.push_back(this->radial.z);
+		parameters.push_back(this->radial.w);
+		parameters.push_back(this->tangential.x);
+		parameters.push_back(this->tangential.y);
+	}
+
+	//--------------------------------------------------------------
+	bool LensModel::deserialize(const float * parameters, size_t numParameters)
+	{
+		if (numParameters != NUM_PARAMETERS) return false;
+
+		this->model = (parameters[0] == MODEL_FISHEYE) ? MODEL_FISHEYE : MODEL_BROWN_CONRADY;
+		this->center = glm::vec2(parameters[1], parameters[2]);
+		this->focalLength = (parameters[3] > 0.0f) ? parameters[3] : 1.0f;
+		this->aspectRatio = (parameters[4] > 0.0f) ? parameters[4] : 1.0f;
+		this->radial = glm::vec4(parameters[5], parameters[6], parameters[7], parameters[8]);
+		this->tangential = glm::vec2(parameters[9], parameters[10]);
+		return true;
+	}
+
+	//--------------------------------------------------------------
+	bool LensModel::operator==(const LensModel & other) const
+	{
+		return (this->model == other.model
+			&& this->center == other.center
+			&& this->focalLength == other.focalLength
+			&& this->aspectRatio == other.aspectRatio
+			&& this->radial == other.radial
+			&& this->tangential == other.tangential);
+	}
+
+	//--------------------------------------------------------------
+	bool LensModel::operator!=(const LensModel & other) const
+	{
+		return !(*this == other);
+	}
+}
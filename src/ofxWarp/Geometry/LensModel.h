@@ -0,0 +1,54 @@
+#pragma once
+
+#include "glm/vec2.hpp"
+#include "glm/vec4.hpp"
+
+#include <vector>
+
+namespace ofxWarp
+{
+	//! Radial and tangential distortion of a lens, in normalized image coordinates.
+	//! Points are taken relative to the principal point and divided by the focal length, with x scaled by the aspect ratio
+	//! so that the distortion is circular in pixels.
+	struct LensModel
+	{
+		typedef enum
+		{
+			//! Brown-Conrady: r' = r * (1 + k1 r^2 + k2 r^4 + k3 r^6), plus tangential distortion
+			MODEL_BROWN_CONRADY,
+			//! equidistant fisheye: r' = theta * (1 + k1 theta^2 + k2 theta^4 + k3 theta^6 + k4 theta^8), where theta = atan(r)
+			MODEL_FISHEYE
+		} Model;
+
+		//! number of floats written by serialize()
+		static const size_t NUM_PARAMETERS = 11;
+
+		LensModel();
+
+		//! return where a point in normalized image coordinates ends up through the lens
+		glm::vec2 distort(const glm::vec2 & point) const;
+		//! return the point in normalized image coordinates that the lens moves to the specified point
+		//! the distortion is inverted numerically, which converges for any lens that doesn't fold the image onto itself
+		glm::vec2 undistort(const glm::vec2 & point) const;
+
+		//! append the parameters to a flat list of floats
+		void serialize(std::vector<float> & parameters) const;
+		//! read the parameters from NUM_PARAMETERS floats, return false if the count doesn't match
+		bool deserialize(const float * parameters, size_t numParameters);
+
+		bool operator==(const LensModel & other) const;
+		bool operator!=(const LensModel & other) const;
+
+		Model model;
+		//! principal point in normalized image coordinates
+		glm::vec2 center;
+		//! focal length in image heights, 1 means the top and bottom edges are at a radius of 0.5
+		float focalLength;
+		//! width over height of the image
+		float aspectRatio;
+		//! radial coefficients k1 to k4, k4 is only used by the fisheye model
+		glm::vec4 radial;
+		//! tangential coefficients p1 and p2, only used by the Brown-Conrady model
+		glm::vec2 tangential;
+	};
+}
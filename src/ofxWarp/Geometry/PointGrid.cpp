@@ -0,0 +1,188 @@
+#include "PointGrid.h"
+
+#include "glm/common.hpp"
+#include "glm/geometric.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace ofxWarp
+{
+	//--------------------------------------------------------------
+	PointGrid::PointGrid()
+		: origin(0.0f)
+		, cellSize(1.0f)
+		, numCellsX(0)
+		, numCellsY(0)
+	{}
+
+	//--------------------------------------------------------------
+	void PointGrid::build(const glm::vec2 * points, size_t numPoints)
+	{
+		this->points.assign(points, points + numPoints);
+		if (numPoints == 0)
+		{
+			this->clear();
+			return;
+		}
+
+		// Find the bounds, skipping points that can't be bucketed.
+		auto min = glm::vec2(std::numeric_limits<float>::max());
+		auto max = glm::vec2(std::numeric_limits<float>::lowest());
+		for (const auto & pt : this->points)
+		{
+			if (!std::isfinite(pt.x) || !std::isfinite(pt.y)) continue;
+
+			min = glm::min(min, pt);
+			max = glm::max(max, pt);
+		}
+		if (min.x > max.x)
+		{
+			min = max = glm::vec2(0.0f);
+		}
+
+		// Aim for about 2 points per cell. The size is also bounded by the longest side, so that
+		// thin or degenerate layouts don't end up with more cells than points.
+		auto extent = max - min;
+		auto targetCells = std::max<size_t>(1, numPoints / 2);
+		this->cellSize = std::sqrt((extent.x * extent.y) / targetCells);
+		this->cellSize = std::max(this->cellSize, std::max(extent.x, extent.y) / targetCells);
+		if (!(this->cellSize > 0.0f))
+		{
+			this->cellSize = 1.0f;
+		}
+
+		this->origin = min;
+		this->numCellsX = (int)(extent.x / this->cellSize) + 1;
+		this->numCellsY = (int)(extent.y / this->cellSize) + 1;
+
+		// Counting sort the point indices by cell.
+		auto numCells = (size_t)this->numCellsX * this->numCellsY;
+		this->cellStarts.assign(numCells + 1, 0);
+		this->cellIndices.resize(numPoints);
+
+		std::vector<uint32_t> pointCells(numPoints);
+		for (size_t i = 0; i < numPoints; ++i)
+		{
+			int col, row;
+			this->getCell(this->points[i], col, row);
+			col = std::min(std::max(col, 0), this->numCellsX - 1);
+			row = std::min(std::max(row, 0), this->numCellsY - 1);
+
+			pointCells[i] = (uint32_t)(row * this->numCellsX + col);
+			++this->cellStarts[pointCells[i] + 1];
+		}
+		for (size_t i = 0; i < numCells; ++i)
+		{
+			this->cellStarts[i + 1] += this->cellStarts[i];
+		}
+
+		// Fill in index order, so each cell lists its points in increasing order.
+		std::vector<uint32_t> cellEnds(this->cellStarts.begin(), this->cellStarts.end() - 1);
+		for (size_t i = 0; i < numPoints; ++i)
+		{
+			this->cellIndices[cellEnds[pointCells[i]]++] = (uint32_t)i;
+		}
+	}
+
+	//--------------------------------------------------------------
+	void PointGrid::clear()
+	{
+		this->points.clear();
+		this->cellStarts.clear();
+		this->cellIndices.clear();
+		this->numCellsX = 0;
+		this->numCellsY = 0;
+	}
+
+	//--------------------------------------------------------------
+	size_t PointGrid::findClosest(const glm::vec2 & pos, float * distance) const
+	{
+		size_t closestIndex = -1;
+		auto closestDistance2 = std::numeric_limits<float>::max();
+
+		if (!this->points.empty())
+		{
+			int col, row;
+			this->getCell(pos, col, row);
+
+			auto visitCell = [&](int x, int y)
+			{
+				if (x < 0 || x >= this->numCellsX || y < 0 || y >= this->numCellsY) return;
+
+				auto cell = y * this->numCellsX + x;
+				for (auto i = this->cellStarts[cell]; i < this->cellStarts[cell + 1]; ++i)
+				{
+					auto index = this->cellIndices[i];
+					auto delta = this->points[index] - pos;
+					auto candidate = glm::dot(delta, delta);
+					if (candidate < closestDistance2 || (candidate == closestDistance2 && index < closestIndex))
+					{
+						closestDistance2 = candidate;
+						closestIndex = index;
+					}
+				}
+			};
+
+			// Search rings of cells around pos, starting with the first ring that overlaps the grid.
+			auto firstRing = std::max({ 0, -col, col - (this->numCellsX - 1), -row, row - (this->numCellsY - 1) });
+			auto lastRing = std::max({ col, (this->numCellsX - 1) - col, row, (this->numCellsY - 1) - row });
+			for (auto r = firstRing; r <= lastRing; ++r)
+			{
+				if (r == 0)
+				{
+					visitCell(col, row);
+				}
+				else
+				{
+					for (auto x = std::max(col - r, 0); x <= std::min(col + r, this->numCellsX - 1); ++x)
+					{
+						visitCell(x, row - r);
+						visitCell(x, row + r);
+					}
+					for (auto y = std::max(row - r + 1, 0); y <= std::min(row + r - 1, this->numCellsY - 1); ++y)
+					{
+						visitCell(col - r, y);
+						visitCell(col + r, y);
+					}
+				}
+
+				// Every cell beyond this ring is at least r cells away from pos.
+				auto ringDistance = r * this->cellSize;
+				if (closestIndex != (size_t)-1 && closestDistance2 < ringDistance * ringDistance) break;
+			}
+		}
+
+		if (distance)
+		{
+			*distance = (closestIndex != (size_t)-1) ? std::sqrt(closestDistance2) : std::numeric_limits<float>::max();
+		}
+		return closestIndex;
+	}
+
+	//--------------------------------------------------------------
+	size_t PointGrid::getNumPoints() const
+	{
+		return this->points.size();
+	}
+
+	//--------------------------------------------------------------
+	const std::vector<glm::vec2> & PointGrid::getPoints() const
+	{
+		return this->points;
+	}
+
+	//--------------------------------------------------------------
+	void PointGrid::getCell(const glm::vec2 & pos, int & col, int & row) const
+	{
+		// Keep far away and non-finite positions within range of an int.
+		static const auto limit = 1.0e6f;
+		auto cell = (pos - this->origin) / this->cellSize;
+		cell.x = (cell.x > -limit) ? std::min(cell.x, limit) : -limit;
+		cell.y = (cell.y > -limit) ? std::min(cell.y, limit) : -limit;
+
+		col = (int)std::floor(cell.x);
+		row = (int)std::floor(cell.y);
+	}
+}
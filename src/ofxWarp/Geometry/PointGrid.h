@@ -0,0 +1,48 @@
+#pragma once
+
+#include "glm/vec2.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace ofxWarp
+{
+	//! Uniform grid of square cells over a set of 2D points, for nearest point queries that don't visit every point.
+	//! The points are copied in and bucketed with a counting sort, so building is linear and allocation free once warmed up.
+	class PointGrid
+	{
+	public:
+		PointGrid();
+
+		//! copy the points and bucket them, aiming for a couple of points per cell
+		void build(const glm::vec2 * points, size_t numPoints);
+		//! remove all points
+		void clear();
+
+		//! return the index of the point closest to pos and its distance, or -1 if the grid is empty
+		//! ties are resolved in favour of the lowest index, matching a linear search
+		size_t findClosest(const glm::vec2 & pos, float * distance) const;
+
+		//! return the number of points in the grid
+		size_t getNumPoints() const;
+		//! return the points, in the order they were passed to build()
+		const std::vector<glm::vec2> & getPoints() const;
+
+	protected:
+		//! return the cell containing pos, which may lie outside the grid
+		void getCell(const glm::vec2 & pos, int & col, int & row) const;
+
+	protected:
+		std::vector<glm::vec2> points;
+
+		glm::vec2 origin;
+		float cellSize;
+		int numCellsX;
+		int numCellsY;
+
+		//! start of each cell's range in cellIndices, with one extra entry marking the end of the last cell
+		std::vector<uint32_t> cellStarts;
+		//! point indices sorted by cell
+		std::vector<uint32_t> cellIndices;
+	};
+}
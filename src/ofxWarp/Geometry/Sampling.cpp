@@ -0,0 +1,37 @@
+#include "Sampling.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ofxWarp
+{
+	//--------------------------------------------------------------
+	void sampleBilinear(const float * pixels, size_t width, size_t height, size_t numChannels, const glm::vec2 & point, float * result, bool bottomUp)
+	{
+		// Work in texels, with the centers at whole coordinates.
+		auto x = point.x * width - 0.5f;
+		auto y = (bottomUp ? (1.0f - point.y) : point.y) * height - 0.5f;
+		auto x0 = std::floor(x);
+		auto y0 = std::floor(y);
+		auto fx = x - x0;
+		auto fy = y - y0;
+
+		auto lastColumn = (long)width - 1;
+		auto lastRow = (long)height - 1;
+		auto column0 = std::min(std::max((long)x0, 0L), lastColumn);
+		auto column1 = std::min(std::max((long)x0 + 1, 0L), lastColumn);
+		auto row0 = std::min(std::max((long)y0, 0L), lastRow);
+		auto row1 = std::min(std::max((long)y0 + 1, 0L), lastRow);
+
+		auto p00 = pixels + ((row0 * width + column0) * numChannels);
+		auto p10 = pixels + ((row0 * width + column1) * numChannels);
+		auto p01 = pixels + ((row1 * width + column0) * numChannels);
+		auto p11 = pixels + ((row1 * width + column1) * numChannels);
+		for (size_t i = 0; i < numChannels; ++i)
+		{
+			auto top = p00[i] + (p10[i] - p00[i]) * fx;
+			auto bottom = p01[i] + (p11[i] - p01[i]) * fx;
+			result[i] = top + (bottom - top) * fy;
+		}
+	}
+}
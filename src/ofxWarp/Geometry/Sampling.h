@@ -0,0 +1,13 @@
+#pragma once
+
+#include "glm/vec2.hpp"
+
+#include <cstddef>
+
+namespace ofxWarp
+{
+	//! sample an image of numChannels floats per pixel at a point in normalized coordinates, writing numChannels values to result
+	//! this filters like GL_LINEAR with GL_CLAMP_TO_EDGE: texel centers are at half coordinates and edge texels are repeated
+	//! rows are read from the top down, set bottomUp for images stored from the bottom up like pfm files
+	void sampleBilinear(const float * pixels, size_t width, size_t height, size_t numChannels, const glm::vec2 & point, float * result, bool bottomUp = false);
+}
@@ -0,0 +1,51 @@
+#include "Shading.h"
+
+#include <algorithm>
+
+namespace ofxWarp
+{
+	//--------------------------------------------------------------
+	void shadePixels(float * colors, const float * factors, size_t numPixels)
+	{
+		for (size_t i = 0; i < numPixels * 4; ++i)
+		{
+			colors[i] = std::min(std::max(colors[i] * factors[i], 0.0f), 1.0f);
+		}
+	}
+
+	//--------------------------------------------------------------
+	template<size_t NumChannels>
+	void blendPixels(const float * colors, float * destination, size_t numPixels)
+	{
+		// The channel count is known here, so the inner loop unrolls and the pixels vectorize.
+		for (size_t x = 0; x < numPixels; ++x)
+		{
+			auto source = colors + (x * 4);
+			auto target = destination + (x * NumChannels);
+			auto alpha = source[3];
+			for (size_t c = 0; c < NumChannels; ++c)
+			{
+				target[c] = source[c] * alpha + target[c] * (1.0f - alpha);
+			}
+		}
+	}
+
+	template void blendPixels<3>(const float * colors, float * destination, size_t numPixels);
+	template void blendPixels<4>(const float * colors, float * destination, size_t numPixels);
+
+	//--------------------------------------------------------------
+	bool blendPixels(const float * colors, float * destination, size_t numPixels, size_t numChannels)
+	{
+		switch (numChannels)
+		{
+		case 3:
+			blendPixels<3>(colors, destination, numPixels);
+			return true;
+		case 4:
+			blendPixels<4>(colors, destination, numPixels);
+			return true;
+		default:
+			return false;
+		}
+	}
+}
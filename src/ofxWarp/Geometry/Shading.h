@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstddef>
+
+namespace ofxWarp
+{
+	//! multiply numPixels RGBA colors by RGBA factors and clamp them to [0, 1], like the warp shaders do before output
+	//! both arrays hold 4 floats per pixel, so this is a single flat loop the compiler vectorizes
+	void shadePixels(float * colors, const float * factors, size_t numPixels);
+
+	//! blend numPixels RGBA colors over pixels with NumChannels floats each, 3 or 4, with their alpha
+	//! this is GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA on all channels, like ofEnableAlphaBlending()
+	template<size_t NumChannels>
+	void blendPixels(const float * colors, float * destination, size_t numPixels);
+	//! same as above, for a number of channels only known at runtime, return false if it isn't 3 or 4
+	bool blendPixels(const float * colors, float * destination, size_t numPixels, size_t numChannels);
+}
@@ -0,0 +1,220 @@
+#include "TriangleGrid.h"
+
+#include "glm/common.hpp"
+#include "glm/geometric.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace ofxWarp
+{
+	namespace
+	{
+		//--------------------------------------------------------------
+		bool isFinite(const glm::vec2 & pt)
+		{
+			return (std::isfinite(pt.x) && std::isfinite(pt.y));
+		}
+	}
+
+	//--------------------------------------------------------------
+	TriangleGrid::TriangleGrid()
+		: origin(0.0f)
+		, cellSize(1.0f)
+		, numCellsX(0)
+		, numCellsY(0)
+	{}
+
+	//--------------------------------------------------------------
+	void TriangleGrid::build(const WarpMesh & mesh)
+	{
+		// Same tolerance in pixels as WarpMesh::bakeMap(), so points on shared edges are always found.
+		static const float epsilon = 1.0e-3f;
+
+		// Project the triangles once, clipped like the rasterizer clips them.
+		this->triangles.clear();
+		this->triangles.reserve(mesh.getNumTriangles());
+		glm::vec4 positions[4];
+		glm::vec2 texCoords[4];
+		for (size_t t = 0; t < mesh.getNumTriangles(); ++t)
+		{
+			auto numCorners = mesh.clipTriangle(t, positions, texCoords);
+			for (size_t i = 2; i < numCorners; ++i)
+			{
+				const auto & p0 = positions[0];
+				const auto & p1 = positions[i - 1];
+				const auto & p2 = positions[i];
+
+				// Weights of the homogeneous corners as linear functions of the position, see WarpMesh::bakeMap().
+				auto c0 = glm::vec3(p0.x, p0.y, p0.w);
+				auto c1 = glm::vec3(p1.x, p1.y, p1.w);
+				auto c2 = glm::vec3(p2.x, p2.y, p2.w);
+				auto r0 = glm::cross(c1, c2);
+				auto det = glm::dot(c0, r0);
+				if (std::abs(det / (p0.w * p1.w * p2.w)) < 1.0e-12f) continue;
+
+				Triangle triangle;
+				triangle.a = glm::vec2(p0) / p0.w;
+				triangle.b = glm::vec2(p1) / p1.w;
+				triangle.c = glm::vec2(p2) / p2.w;
+				if (!isFinite(triangle.a) || !isFinite(triangle.b) || !isFinite(triangle.c)) continue;
+
+				auto invDet = 1.0f / det;
+				triangle.weights[0] = r0 * invDet;
+				triangle.weights[1] = glm::cross(c2, c0) * invDet;
+				triangle.weights[2] = glm::cross(c0, c1) * invDet;
+				for (size_t j = 0; j < 3; ++j)
+				{
+					triangle.tolerance[j] = -epsilon * glm::length(glm::vec2(triangle.weights[j]));
+				}
+				triangle.texCoords[0] = texCoords[0];
+				triangle.texCoords[1] = texCoords[i - 1];
+				triangle.texCoords[2] = texCoords[i];
+				this->triangles.push_back(triangle);
+			}
+		}
+
+		auto numTriangles = this->triangles.size();
+		if (numTriangles == 0)
+		{
+			this->clear();
+			return;
+		}
+
+		// Span the grid over the vertices in front of the viewer, corners added by clipping project far away and would
+		// make the cells huge. Triangles reaching beyond the grid are bucketed into its border cells instead.
+		auto min = glm::vec2(std::numeric_limits<float>::max());
+		auto max = glm::vec2(std::numeric_limits<float>::lowest());
+		for (const auto & position : mesh.positions)
+		{
+			if (!(position.w >= WarpMesh::MIN_W)) continue;
+
+			auto pos = glm::vec2(position) / position.w;
+			if (!isFinite(pos)) continue;
+
+			min = glm::min(min, pos);
+			max = glm::max(max, pos);
+		}
+		if (min.x > max.x || min.y > max.y)
+		{
+			this->clear();
+			return;
+		}
+
+		// Aim for about one triangle per cell, bounded by the longest side like PointGrid.
+		auto extent = max - min;
+		this->cellSize = std::sqrt((extent.x * extent.y) / numTriangles);
+		this->cellSize = std::max(this->cellSize, std::max(extent.x, extent.y) / numTriangles);
+		if (!(this->cellSize > 0.0f))
+		{
+			this->cellSize = 1.0f;
+		}
+
+		this->origin = min;
+		this->numCellsX = (int)(extent.x / this->cellSize) + 1;
+		this->numCellsY = (int)(extent.y / this->cellSize) + 1;
+
+		// Counting sort the triangle indices into every cell their bounds overlap.
+		auto numCells = (size_t)this->numCellsX * this->numCellsY;
+		this->cellStarts.assign(numCells + 1, 0);
+
+		auto forEachCell = [this](const Triangle & triangle, auto function)
+		{
+			int minCol, minRow, maxCol, maxRow;
+			this->getCell(glm::min(triangle.a, glm::min(triangle.b, triangle.c)), minCol, minRow);
+			this->getCell(glm::max(triangle.a, glm::max(triangle.b, triangle.c)), maxCol, maxRow);
+			minCol = std::max(minCol, 0);
+			minRow = std::max(minRow, 0);
+			maxCol = std::min(maxCol, this->numCellsX - 1);
+			maxRow = std::min(maxRow, this->numCellsY - 1);
+			for (auto row = minRow; row <= maxRow; ++row)
+			{
+				for (auto col = minCol; col <= maxCol; ++col)
+				{
+					function((size_t)row * this->numCellsX + col);
+				}
+			}
+		};
+
+		for (const auto & triangle : this->triangles)
+		{
+			forEachCell(triangle, [this](size_t cell)
+			{
+				++this->cellStarts[cell + 1];
+			});
+		}
+		for (size_t i = 0; i < numCells; ++i)
+		{
+			this->cellStarts[i + 1] += this->cellStarts[i];
+		}
+
+		// Fill in index order, so each cell lists its triangles in drawing order.
+		this->cellIndices.resize(this->cellStarts.back());
+		std::vector<uint32_t> cellEnds(this->cellStarts.begin(), this->cellStarts.end() - 1);
+		for (size_t i = 0; i < numTriangles; ++i)
+		{
+			forEachCell(this->triangles[i], [&](size_t cell)
+			{
+				this->cellIndices[cellEnds[cell]++] = (uint32_t)i;
+			});
+		}
+	}
+
+	//--------------------------------------------------------------
+	void TriangleGrid::clear()
+	{
+		this->triangles.clear();
+		this->cellStarts.clear();
+		this->cellIndices.clear();
+		this->numCellsX = 0;
+		this->numCellsY = 0;
+	}
+
+	//--------------------------------------------------------------
+	bool TriangleGrid::find(const glm::vec2 & pos, glm::vec2 & texCoord) const
+	{
+		if (this->triangles.empty() || !isFinite(pos)) return false;
+
+		// Points beyond the grid can still be covered by the triangles bucketed into its border cells.
+		int col, row;
+		this->getCell(pos, col, row);
+		col = std::min(std::max(col, 0), this->numCellsX - 1);
+		row = std::min(std::max(row, 0), this->numCellsY - 1);
+
+		// Walk the cell backwards, so the triangle drawn last wins.
+		auto point = glm::vec3(pos, 1.0f);
+		auto cell = row * this->numCellsX + col;
+		for (auto i = this->cellStarts[cell + 1]; i > this->cellStarts[cell]; --i)
+		{
+			const auto & triangle = this->triangles[this->cellIndices[i - 1]];
+
+			auto weights = glm::vec3(glm::dot(triangle.weights[0], point), glm::dot(triangle.weights[1], point), glm::dot(triangle.weights[2], point));
+			if (weights.x < triangle.tolerance.x || weights.y < triangle.tolerance.y || weights.z < triangle.tolerance.z) continue;
+
+			texCoord = (triangle.texCoords[0] * weights.x + triangle.texCoords[1] * weights.y + triangle.texCoords[2] * weights.z) / (weights.x + weights.y + weights.z);
+			return true;
+		}
+
+		return false;
+	}
+
+	//--------------------------------------------------------------
+	size_t TriangleGrid::getNumTriangles() const
+	{
+		return this->triangles.size();
+	}
+
+	//--------------------------------------------------------------
+	void TriangleGrid::getCell(const glm::vec2 & pos, int & col, int & row) const
+	{
+		// Keep far away positions within range of an int.
+		static const auto limit = 1.0e6f;
+		auto cell = (pos - this->origin) / this->cellSize;
+		cell.x = (cell.x > -limit) ? std::min(cell.x, limit) : -limit;
+		cell.y = (cell.y > -limit) ? std::min(cell.y, limit) : -limit;
+
+		col = (int)std::floor(cell.x);
+		row = (int)std::floor(cell.y);
+	}
+}
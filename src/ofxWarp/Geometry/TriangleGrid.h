@@ -0,0 +1,63 @@
+#pragma once
+
+#include "glm/vec2.hpp"
+#include "glm/vec3.hpp"
+
+#include <cstdint>
+#include <vector>
+
+#include "WarpMesh.h"
+
+namespace ofxWarp
+{
+	//! Uniform grid of square cells over the triangles of a warp mesh, for finding the content coordinates drawn at a
+	//! screen point without visiting every triangle. Triangles are bucketed into every cell their bounds overlap.
+	class TriangleGrid
+	{
+	public:
+		TriangleGrid();
+
+		//! project the triangles of the mesh to the screen and bucket them, aiming for about one triangle per cell
+		//! triangles that reach behind the viewer are clipped, as WarpMesh::bakeMap() does
+		void build(const WarpMesh & mesh);
+		//! remove all triangles
+		void clear();
+
+		//! find the content coordinates drawn at a point in pixels, interpolated like the GPU does
+		//! where the mesh overlaps itself the last triangle wins, return false if no triangle covers the point
+		bool find(const glm::vec2 & pos, glm::vec2 & texCoord) const;
+
+		//! return the number of triangles in the grid
+		size_t getNumTriangles() const;
+
+	protected:
+		//! return the cell containing pos, which may lie outside the grid
+		void getCell(const glm::vec2 & pos, int & col, int & row) const;
+
+	protected:
+		struct Triangle
+		{
+			//! corners in pixels
+			glm::vec2 a;
+			glm::vec2 b;
+			glm::vec2 c;
+			//! weight of each homogeneous corner at a point (x, y, 1) in pixels, as a dot product
+			glm::vec3 weights[3];
+			//! smallest weights that count as covered, a little below 0 so that points on shared edges are always found
+			glm::vec3 tolerance;
+			glm::vec2 texCoords[3];
+		};
+
+		std::vector<Triangle> triangles;
+
+		glm::vec2 origin;
+		float cellSize;
+		int numCellsX;
+		int numCellsY;
+
+		//! start of each cell's range in cellIndices, with one extra entry marking the end of the last cell
+		std::vector<uint32_t> cellStarts;
+		//! triangle indices sorted by cell, in increasing order within each cell
+		std::vector<uint32_t> cellIndices;
+	};
+}
@@ -0,0 +1,209 @@
+#include "WarpMesh.h"
+
+#include "glm/common.hpp"
+#include "glm/geometric.hpp"
+#include "glm/vec3.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace ofxWarp
+{
+	namespace
+	{
+		//--------------------------------------------------------------
+		void rasterizeTriangle(const glm::vec4 & p0, const glm::vec4 & p1, const glm::vec4 & p2,
+			const glm::vec2 & uv0, const glm::vec2 & uv1, const glm::vec2 & uv2,
+			size_t width, const glm::vec2 & scale, glm::vec2 * map, size_t rowBegin, size_t rowEnd)
+		{
+			// Solve for the weights of the homogeneous corners that project to a pixel, they are linear in the pixel
+			// position and are found without dividing by w, which keeps clipped corners that project far away precise.
+			auto c0 = glm::vec3(p0.x * scale.x, p0.y * scale.y, p0.w);
+			auto c1 = glm::vec3(p1.x * scale.x, p1.y * scale.y, p1.w);
+			auto c2 = glm::vec3(p2.x * scale.x, p2.y * scale.y, p2.w);
+			auto r0 = glm::cross(c1, c2);
+			auto r1 = glm::cross(c2, c0);
+			auto r2 = glm::cross(c0, c1);
+			auto det = glm::dot(c0, r0);
+
+			if (std::abs(det / (p0.w * p1.w * p2.w)) < 1.0e-12f) return;
+
+			// Only visit the pixel centers inside the bounding box, clamped to the rows of this pass.
+			auto a = glm::vec2(c0) / c0.z;
+			auto b = glm::vec2(c1) / c1.z;
+			auto c = glm::vec2(c2) / c2.z;
+			auto boundsMin = glm::min(a, glm::min(b, c));
+			auto boundsMax = glm::max(a, glm::max(b, c));
+			auto minX = std::max(0.0f, std::ceil(boundsMin.x - 0.5f));
+			auto maxX = std::min(width - 1.0f, std::floor(boundsMax.x - 0.5f));
+			auto minY = std::max((float)rowBegin, std::ceil(boundsMin.y - 0.5f));
+			auto maxY = std::min(rowEnd - 1.0f, std::floor(boundsMax.y - 0.5f));
+			if (minX > maxX || minY > maxY) return;
+
+			auto invDet = 1.0f / det;
+			auto stepX = glm::vec3(r0.x, r1.x, r2.x) * invDet;
+
+			// The rows are the lines through the edges, allow for a little overlap in pixels across them, so that shared
+			// edges never leave gaps between triangles.
+			static const float epsilon = 1.0e-3f;
+			auto tolerance = -epsilon * std::abs(invDet) * glm::vec3(glm::length(glm::vec2(r0)), glm::length(glm::vec2(r1)), glm::length(glm::vec2(r2)));
+
+			for (auto y = (size_t)minY; y <= (size_t)maxY; ++y)
+			{
+				auto start = glm::vec3(minX + 0.5f, y + 0.5f, 1.0f);
+				auto weights = glm::vec3(glm::dot(r0, start), glm::dot(r1, start), glm::dot(r2, start)) * invDet;
+
+				auto row = map + ((y - rowBegin) * width);
+				for (auto x = (size_t)minX; x <= (size_t)maxX; ++x, weights += stepX)
+				{
+					if (weights.x < tolerance.x || weights.y < tolerance.y || weights.z < tolerance.z) continue;
+
+					// Dividing by the sum of the weights interpolates the content coordinates like the GPU does.
+					row[x] = (uv0 * weights.x + uv1 * weights.y + uv2 * weights.z) / (weights.x + weights.y + weights.z);
+				}
+			}
+		}
+	}
+
+	//--------------------------------------------------------------
+	void WarpMesh::clear()
+	{
+		this->positions.clear();
+		this->texCoords.clear();
+		this->indices.clear();
+	}
+
+	//--------------------------------------------------------------
+	size_t WarpMesh::getNumTriangles() const
+	{
+		return (this->indices.size() / 3);
+	}
+
+	//--------------------------------------------------------------
+	size_t WarpMesh::clipTriangle(size_t t, glm::vec4 * positions, glm::vec2 * texCoords) const
+	{
+		// Walk the edges, keeping the corners in front and adding a corner where an edge crosses the plane.
+		size_t numCorners = 0;
+		for (size_t i = 0; i < 3; ++i)
+		{
+			auto i0 = this->indices[t * 3 + i];
+			auto i1 = this->indices[t * 3 + (i + 1) % 3];
+			const auto & p0 = this->positions[i0];
+			const auto & p1 = this->positions[i1];
+			auto inFront0 = (p0.w >= MIN_W);
+			auto inFront1 = (p1.w >= MIN_W);
+
+			if (inFront0)
+			{
+				positions[numCorners] = p0;
+				texCoords[numCorners] = this->texCoords[i0];
+				++numCorners;
+			}
+			if (inFront0 != inFront1)
+			{
+				// Interpolating in homogeneous coordinates keeps the content coordinates perspective correct.
+				auto s = (MIN_W - p0.w) / (p1.w - p0.w);
+				positions[numCorners] = p0 + (p1 - p0) * s;
+				positions[numCorners].w = MIN_W;
+				texCoords[numCorners] = this->texCoords[i0] + (this->texCoords[i1] - this->texCoords[i0]) * s;
+				++numCorners;
+			}
+		}
+
+		return numCorners;
+	}
+
+	//--------------------------------------------------------------
+	void WarpMesh::bakeMap(size_t width, size_t height, const glm::vec2 & screenSize, glm::vec2 * map, size_t rowBegin, size_t rowEnd) const
+	{
+		std::vector<uint32_t> triangles(this->getNumTriangles());
+		for (size_t t = 0; t < triangles.size(); ++t)
+		{
+			triangles[t] = (uint32_t)t;
+		}
+		this->bakeMap(width, height, screenSize, triangles.data(), triangles.size(), map, rowBegin, rowEnd);
+	}
+
+	//--------------------------------------------------------------
+	void WarpMesh::bakeMap(size_t width, size_t height, const glm::vec2 & screenSize, const uint32_t * triangles, size_t numTriangles, glm::vec2 * map, size_t rowBegin, size_t rowEnd) const
+	{
+		if (width == 0 || height == 0 || screenSize.x <= 0.0f || screenSize.y <= 0.0f) return;
+
+		rowEnd = std::min(rowEnd, height);
+		if (rowBegin >= rowEnd) return;
+
+		// Work in map pixels, so the pixel centers are at half coordinates.
+		auto scale = glm::vec2(width, height) / screenSize;
+
+		glm::vec4 positions[4];
+		glm::vec2 texCoords[4];
+		for (size_t i = 0; i < numTriangles; ++i)
+		{
+			auto numCorners = this->clipTriangle(triangles[i], positions, texCoords);
+			for (size_t j = 2; j < numCorners; ++j)
+			{
+				rasterizeTriangle(positions[0], positions[j - 1], positions[j], texCoords[0], texCoords[j - 1], texCoords[j], width, scale, map, rowBegin, rowEnd);
+			}
+		}
+	}
+
+	//--------------------------------------------------------------
+	void WarpMesh::getBands(size_t width, size_t height, const glm::vec2 & screenSize, size_t bandHeight, std::vector<uint32_t> & bandStarts, std::vector<uint32_t> & bandTriangles) const
+	{
+		bandHeight = std::max<size_t>(bandHeight, 1);
+		auto numBands = (height + bandHeight - 1) / bandHeight;
+		bandStarts.assign(numBands + 1, 0);
+		bandTriangles.clear();
+		if (width == 0 || height == 0 || screenSize.x <= 0.0f || screenSize.y <= 0.0f) return;
+
+		auto scale = glm::vec2(width, height) / screenSize;
+
+		// Find the bands each triangle covers once, with the same bounds the rasterizer uses.
+		auto numTriangles = this->getNumTriangles();
+		std::vector<glm::ivec2> triangleBands(numTriangles, glm::ivec2(0, -1));
+		glm::vec4 positions[4];
+		glm::vec2 texCoords[4];
+		for (size_t t = 0; t < numTriangles; ++t)
+		{
+			auto numCorners = this->clipTriangle(t, positions, texCoords);
+			if (numCorners == 0) continue;
+
+			auto boundsMin = glm::vec2(std::numeric_limits<float>::max());
+			auto boundsMax = glm::vec2(std::numeric_limits<float>::lowest());
+			for (size_t i = 0; i < numCorners; ++i)
+			{
+				auto corner = glm::vec2(positions[i].x * scale.x, positions[i].y * scale.y) / positions[i].w;
+				boundsMin = glm::min(boundsMin, corner);
+				boundsMax = glm::max(boundsMax, corner);
+			}
+
+			auto minX = std::max(0.0f, std::ceil(boundsMin.x - 0.5f));
+			auto maxX = std::min(width - 1.0f, std::floor(boundsMax.x - 0.5f));
+			auto minY = std::max(0.0f, std::ceil(boundsMin.y - 0.5f));
+			auto maxY = std::min(height - 1.0f, std::floor(boundsMax.y - 0.5f));
+			if (!(minX <= maxX && minY <= maxY)) continue;
+
+			triangleBands[t] = glm::ivec2((size_t)minY / bandHeight, (size_t)maxY / bandHeight);
+			for (auto band = triangleBands[t].x; band <= triangleBands[t].y; ++band)
+			{
+				++bandStarts[band + 1];
+			}
+		}
+
+		// Counting sort the triangles into the bands, filling in index order so each band keeps the drawing order.
+		for (size_t i = 0; i < numBands; ++i)
+		{
+			bandStarts[i + 1] += bandStarts[i];
+		}
+		bandTriangles.resize(bandStarts.back());
+		std::vector<uint32_t> bandEnds(bandStarts.begin(), bandStarts.end() - 1);
+		for (size_t t = 0; t < numTriangles; ++t)
+		{
+			for (auto band = triangleBands[t].x; band <= triangleBands[t].y; ++band)
+			{
+				bandTriangles[bandEnds[band]++] = (uint32_t)t;
+			}
+		}
+	}
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "glm/vec2.hpp"
+#include "glm/vec4.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace ofxWarp
+{
+	//! Triangles drawn by a warp, evaluated on the CPU so the warp can be baked or inspected without a GL context.
+	struct WarpMesh
+	{
+		//! remove all vertices and triangles
+		void clear();
+
+		//! return the number of triangles
+		size_t getNumTriangles() const;
+
+		//! clip triangle t against the plane w = MIN_W, like the GPU clips against its near plane, and copy the corners of
+		//! the part in front of the viewer to positions and texCoords, which must hold 4 entries
+		//! return the number of corners, 0 if the whole triangle is behind the viewer, otherwise 3 or 4 to be drawn as a fan
+		size_t clipTriangle(size_t t, glm::vec4 * positions, glm::vec2 * texCoords) const;
+
+		//! rasterize rows [rowBegin..rowEnd) of a width * height map of normalized content coordinates, spread over the
+		//! screen size in pixels and sampled at the pixel centers. Triangles are interpolated like on the GPU, with their
+		//! homogeneous positions, and triangles that reach behind the viewer are clipped with clipTriangle().
+		//! The map only holds the rasterized rows, starting with rowBegin, so passes can work on their own buffers.
+		//! Pixels that no triangle covers are left untouched, where the mesh overlaps itself the last triangle wins.
+		void bakeMap(size_t width, size_t height, const glm::vec2 & screenSize, glm::vec2 * map, size_t rowBegin, size_t rowEnd) const;
+		//! same as above, but only rasterize the listed triangles, in increasing order so the last one still wins
+		void bakeMap(size_t width, size_t height, const glm::vec2 & screenSize, const uint32_t * triangles, size_t numTriangles, glm::vec2 * map, size_t rowBegin, size_t rowEnd) const;
+
+		//! bucket the triangles by the bands of bandHeight rows of a width * height map they cover, so that bands can be
+		//! baked without visiting every triangle. Band i lists triangles [bandStarts[i]..bandStarts[i + 1]) of
+		//! bandTriangles, in increasing order, and triangles that miss the map aren't listed at all.
+		void getBands(size_t width, size_t height, const glm::vec2 & screenSize, size_t bandHeight, std::vector<uint32_t> & bandStarts, std::vector<uint32_t> & bandTriangles) const;
+
+		//! smallest w that is drawn, vertices closer to the viewer would project too far away
+		static constexpr float MIN_W = 1.0e-5f;
+
+		//! vertex positions in pixels, homogeneous so that perspective meshes keep their depth
+		std::vector<glm::vec4> positions;
+		//! normalized content coordinates of the vertices
+		std::vector<glm::vec2> texCoords;
+		//! three vertex indices per triangle
+		std::vector<uint32_t> indices;
+	};
+}
@@ -0,0 +1,194 @@
+#include "WarpStage.h"
+
+#include "Homography.h"
+
+namespace ofxWarp
+{
+	//--------------------------------------------------------------
+	WarpStage::WarpStage(Type type)
+		: type(type)
+	{}
+
+	//--------------------------------------------------------------
+	WarpStage::~WarpStage()
+	{}
+
+	//--------------------------------------------------------------
+	WarpStage::Type WarpStage::getType() const
+	{
+		return this->type;
+	}
+
+	//--------------------------------------------------------------
+	std::shared_ptr<WarpStage> WarpStage::create(Type type)
+	{
+		switch (type)
+		{
+		case STAGE_PERSPECTIVE:
+			return std::make_shared<PerspectiveStage>();
+
+		case STAGE_LENS:
+			return std::make_shared<LensStage>();
+
+		default:
+			return nullptr;
+		}
+	}
+
+	//--------------------------------------------------------------
+	FunctionStage::FunctionStage(const Function & function)
+		: WarpStage(STAGE_FUNCTION)
+		, function(function)
+	{}
+
+	//--------------------------------------------------------------
+	void FunctionStage::map(glm::vec2 * points, size_t numPoints) const
+	{
+		if (!this->function) return;
+
+		for (size_t i = 0; i < numPoints; ++i)
+		{
+			points[i] = this->function(points[i]);
+		}
+	}
+
+	//--------------------------------------------------------------
+	bool FunctionStage::serialize(std::vector<float> & /*parameters*/) const
+	{
+		return false;
+	}
+
+	//--------------------------------------------------------------
+	bool FunctionStage::deserialize(const float * /*parameters*/, size_t /*numParameters*/)
+	{
+		return false;
+	}
+
+	//--------------------------------------------------------------
+	PerspectiveStage::PerspectiveStage()
+		: WarpStage(STAGE_PERSPECTIVE)
+	{
+		this->corners[0] = glm::vec2(0.0f, 0.0f);
+		this->corners[1] = glm::vec2(1.0f, 0.0f);
+		this->corners[2] = glm::vec2(1.0f, 1.0f);
+		this->corners[3] = glm::vec2(0.0f, 1.0f);
+		this->update();
+	}
+
+	//--------------------------------------------------------------
+	PerspectiveStage::PerspectiveStage(const glm::vec2 corners[4])
+		: WarpStage(STAGE_PERSPECTIVE)
+	{
+		for (size_t i = 0; i < 4; ++i)
+		{
+			this->corners[i] = corners[i];
+		}
+		this->update();
+	}
+
+	//--------------------------------------------------------------
+	void PerspectiveStage::setCorner(size_t index, const glm::vec2 & corner)
+	{
+		if (index >= 4) return;
+
+		this->corners[index] = corner;
+		this->update();
+	}
+
+	//--------------------------------------------------------------
+	const glm::vec2 & PerspectiveStage::getCorner(size_t index) const
+	{
+		return this->corners[index % 4];
+	}
+
+	//--------------------------------------------------------------
+	void PerspectiveStage::map(glm::vec2 * points, size_t numPoints) const
+	{
+		for (size_t i = 0; i < numPoints; ++i)
+		{
+			points[i] = Homography::transform(this->transform, points[i]);
+		}
+	}
+
+	//--------------------------------------------------------------
+	bool PerspectiveStage::serialize(std::vector<float> & parameters) const
+	{
+		for (size_t i = 0; i < 4; ++i)
+		{
+			parameters.push_back(this->corners[i].x);
+			parameters.push_back(this->corners[i].y);
+		}
+		return true;
+	}
+
+	//--------------------------------------------------------------
+	bool PerspectiveStage::deserialize(const float * parameters, size_t numParameters)
+	{
+		if (numParameters != 8) return false;
+
+		for (size_t i = 0; i < 4; ++i)
+		{
+			this->corners[i] = glm::vec2(parameters[i * 2], parameters[i * 2 + 1]);
+		}
+		this->update();
+		return true;
+	}
+
+	//--------------------------------------------------------------
+	void PerspectiveStage::update()
+	{
+		static const glm::vec2 unitSquare[4] =
+		{
+			{ 0.0f, 0.0f },
+			{ 1.0f, 0.0f },
+			{ 1.0f, 1.0f },
+			{ 0.0f, 1.0f }
+		};
+		this->transform = Homography::solve(unitSquare, this->corners);
+	}
+
+	//--------------------------------------------------------------
+	LensStage::LensStage(const LensModel & lens, bool precompensate)
+		: WarpStage(STAGE_LENS)
+		, lens(lens)
+		, precompensate(precompensate)
+	{}
+
+	//--------------------------------------------------------------
+	const LensModel & LensStage::getLens() const
+	{
+		return this->lens;
+	}
+
+	//--------------------------------------------------------------
+	bool LensStage::getPrecompensate() const
+	{
+		return this->precompensate;
+	}
+
+	//--------------------------------------------------------------
+	void LensStage::map(glm::vec2 * points, size_t numPoints) const
+	{
+		for (size_t i = 0; i < numPoints; ++i)
+		{
+			points[i] = this->precompensate ? this->lens.undistort(points[i]) : this->lens.distort(points[i]);
+		}
+	}
+
+	//--------------------------------------------------------------
+	bool LensStage::serialize(std::vector<float> & parameters) const
+	{
+		this->lens.serialize(parameters);
+		parameters.push_back(this->precompensate);
+		return true;
+	}
+
+	//--------------------------------------------------------------
+	bool LensStage::deserialize(const float * parameters, size_t numParameters)
+	{
+		if (numParameters != LensModel::NUM_PARAMETERS + 1 || !this->lens.deserialize(parameters, LensModel::NUM_PARAMETERS)) return false;
+
+		this->precompensate = (parameters[LensModel::NUM_PARAMETERS] != 0.0f);
+		return true;
+	}
+}
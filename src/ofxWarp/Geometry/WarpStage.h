@@ -0,0 +1,115 @@
+#pragma once
+
+#include "glm/mat4x4.hpp"
+#include "glm/vec2.hpp"
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "LensModel.h"
+
+namespace ofxWarp
+{
+	//! One step of a warp chain, mapping normalized coordinates from the previous stage to the next one.
+	//! Stages are evaluated on the CPU while the mesh is built, possibly on a worker thread, so they must not be
+	//! changed once they are part of a chain: replace the stage instead.
+	class WarpStage
+	{
+	public:
+		typedef enum
+		{
+			STAGE_UNKNOWN,
+			STAGE_FUNCTION,
+			STAGE_PERSPECTIVE,
+			STAGE_LENS
+		} Type;
+
+		WarpStage(Type type = STAGE_UNKNOWN);
+		virtual ~WarpStage();
+
+		Type getType() const;
+
+		//! map the points in place
+		virtual void map(glm::vec2 * points, size_t numPoints) const = 0;
+
+		//! append the settings of the stage, return false if the stage can't be saved
+		virtual bool serialize(std::vector<float> & parameters) const = 0;
+		//! read the settings of the stage, return false if they don't match
+		virtual bool deserialize(const float * parameters, size_t numParameters) = 0;
+
+		//! return a default stage of the specified type, or nullptr if the type can't be loaded from settings
+		static std::shared_ptr<WarpStage> create(Type type);
+
+	protected:
+		Type type;
+	};
+
+	//! Stage that calls a function for each point, for mappings that are only known to the app.
+	//! The function may be called from a worker thread, and the stage is not saved with the settings.
+	class FunctionStage
+		: public WarpStage
+	{
+	public:
+		typedef std::function<glm::vec2(const glm::vec2 & point)> Function;
+
+		FunctionStage(const Function & function);
+
+		virtual void map(glm::vec2 * points, size_t numPoints) const override;
+
+		virtual bool serialize(std::vector<float> & parameters) const override;
+		virtual bool deserialize(const float * parameters, size_t numParameters) override;
+
+	protected:
+		Function function;
+	};
+
+	//! Stage that maps the unit square onto four corners with a perspective transform.
+	class PerspectiveStage
+		: public WarpStage
+	{
+	public:
+		PerspectiveStage();
+		//! corners are ordered top-left, top-right, bottom-right, bottom-left
+		PerspectiveStage(const glm::vec2 corners[4]);
+
+		//! set the corner (top-left, top-right, bottom-right, bottom-left)
+		void setCorner(size_t index, const glm::vec2 & corner);
+		//! return the corner (top-left, top-right, bottom-right, bottom-left)
+		const glm::vec2 & getCorner(size_t index) const;
+
+		virtual void map(glm::vec2 * points, size_t numPoints) const override;
+
+		virtual bool serialize(std::vector<float> & parameters) const override;
+		virtual bool deserialize(const float * parameters, size_t numParameters) override;
+
+	protected:
+		//! solve the transform, it is kept up to date so that mapping never writes to the stage
+		void update();
+
+	protected:
+		glm::vec2 corners[4];
+		glm::mat4 transform;
+	};
+
+	//! Stage that applies a lens distortion model, or its inverse to pre-compensate for the lens.
+	class LensStage
+		: public WarpStage
+	{
+	public:
+		//! when precompensate is set, points are moved to where the lens brings them back to their original position
+		LensStage(const LensModel & lens = LensModel(), bool precompensate = true);
+
+		const LensModel & getLens() const;
+		bool getPrecompensate() const;
+
+		virtual void map(glm::vec2 * points, size_t numPoints) const override;
+
+		virtual bool serialize(std::vector<float> & parameters) const override;
+		virtual bool deserialize(const float * parameters, size_t numParameters) override;
+
+	protected:
+		LensModel lens;
+		bool precompensate;
+	};
+}
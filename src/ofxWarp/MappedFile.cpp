@@ -0,0 +1,134 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ofxWarp
+{
+	//--------------------------------------------------------------
+	MappedFile::MappedFile()
+		: data(nullptr)
+		, size(0)
+#ifdef _WIN32
+		, fileHandle(INVALID_HANDLE_VALUE)
+		, mappingHandle(nullptr)
+#else
+		, fileDescriptor(-1)
+#endif
+	{}
+
+	//--------------------------------------------------------------
+	MappedFile::~MappedFile()
+	{
+		this->close();
+	}
+
+	//--------------------------------------------------------------
+	bool MappedFile::open(const std::string & filePath)
+	{
+		this->close();
+
+#ifdef _WIN32
+		this->fileHandle = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (this->fileHandle == INVALID_HANDLE_VALUE) return false;
+
+		LARGE_INTEGER fileSize;
+		if (!GetFileSizeEx(this->fileHandle, &fileSize) || fileSize.QuadPart == 0)
+		{
+			this->close();
+			return false;
+		}
+		this->size = (size_t)fileSize.QuadPart;
+
+		this->mappingHandle = CreateFileMappingA(this->fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (this->mappingHandle == nullptr)
+		{
+			this->close();
+			return false;
+		}
+
+		this->data = (const char *)MapViewOfFile(this->mappingHandle, FILE_MAP_READ, 0, 0, 0);
+#else
+		this->fileDescriptor = ::open(filePath.c_str(), O_RDONLY);
+		if (this->fileDescriptor < 0) return false;
+
+		struct stat fileStat;
+		if (fstat(this->fileDescriptor, &fileStat) != 0 || fileStat.st_size == 0)
+		{
+			this->close();
+			return false;
+		}
+		this->size = (size_t)fileStat.st_size;
+
+		auto mapped = mmap(nullptr, this->size, PROT_READ, MAP_PRIVATE, this->fileDescriptor, 0);
+		this->data = (mapped == MAP_FAILED) ? nullptr : (const char *)mapped;
+#endif
+
+		if (this->data == nullptr)
+		{
+			this->close();
+			return false;
+		}
+
+		return true;
+	}
+
+	//--------------------------------------------------------------
+	void MappedFile::close()
+	{
+#ifdef _WIN32
+		if (this->data)
+		{
+			UnmapViewOfFile(this->data);
+		}
+		if (this->mappingHandle)
+		{
+			CloseHandle(this->mappingHandle);
+			this->mappingHandle = nullptr;
+		}
+		if (this->fileHandle != INVALID_HANDLE_VALUE)
+		{
+			CloseHandle(this->fileHandle);
+			this->fileHandle = INVALID_HANDLE_VALUE;
+		}
+#else
+		if (this->data)
+		{
+			munmap((void *)this->data, this->size);
+		}
+		if (this->fileDescriptor >= 0)
+		{
+			::close(this->fileDescriptor);
+			this->fileDescriptor = -1;
+		}
+#endif
+
+		this->data = nullptr;
+		this->size = 0;
+	}
+
+	//--------------------------------------------------------------
+	bool MappedFile::isOpen() const
+	{
+		return (this->data != nullptr);
+	}
+
+	//--------------------------------------------------------------
+	const char * MappedFile::getData() const
+	{
+		return this->data;
+	}
+
+	//--------------------------------------------------------------
+	size_t MappedFile::getSize() const
+	{
+		return this->size;
+	}
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <string>
+
+namespace ofxWarp
+{
+	//! Read-only memory mapping of a file, so large settings and warp maps can be parsed in place without copying them first.
+	class MappedFile
+	{
+	public:
+		MappedFile();
+		~MappedFile();
+
+		MappedFile(const MappedFile &) = delete;
+		MappedFile & operator=(const MappedFile &) = delete;
+
+		//! map the file at the specified absolute path
+		bool open(const std::string & filePath);
+		//! unmap the file
+		void close();
+
+		bool isOpen() const;
+
+		//! return the start of the mapped file
+		const char * getData() const;
+		//! return the size of the mapped file in bytes
+		size_t getSize() const;
+
+	protected:
+		const char * data;
+		size_t size;
+
+#ifdef _WIN32
+		void * fileHandle;
+		void * mappingHandle;
+#else
+		int fileDescriptor;
+#endif
+	};
+}
@@ -0,0 +1,267 @@
+#include "MpcdiPackage.h"
+
+#include "ofImage.h"
+#include "ofUtils.h"
+#include "ofXml.h"
+
+#include <filesystem>
+
+#include "WarpMap.h"
+
+namespace ofxWarp
+{
+	namespace
+	{
+		//--------------------------------------------------------------
+		float getFloatAttribute(const ofXml & node, const std::string & name, float defaultValue)
+		{
+			auto attribute = node.getAttribute(name);
+			return attribute ? attribute.getFloatValue() : defaultValue;
+		}
+
+		//--------------------------------------------------------------
+		bool getRegionBounds(const WarpMap & warp, ofRectangle & bounds)
+		{
+			// Regions are rectangles in the buffer, so only maps whose corners form one can be written as is.
+			auto topLeft = warp.getControlPoint(0);
+			auto topRight = warp.getControlPoint(1);
+			auto bottomRight = warp.getControlPoint(2);
+			auto bottomLeft = warp.getControlPoint(3);
+			if (topLeft.y != topRight.y || bottomLeft.y != bottomRight.y || topLeft.x != bottomLeft.x || topRight.x != bottomRight.x) return false;
+			if (topRight.x <= topLeft.x || bottomLeft.y <= topLeft.y) return false;
+
+			bounds = ofRectangle(topLeft, bottomRight);
+			return true;
+		}
+
+		//--------------------------------------------------------------
+		void getAlphaMap(const WarpMap & warp, ofShortPixels & alphaMap)
+		{
+			auto width = warp.getMapWidth();
+			auto height = warp.getMapHeight();
+			auto edgeBlend = warp.getEdgeBlend();
+			const auto & blendMap = warp.getBlendMap();
+
+			alphaMap.allocate(width, height, OF_PIXELS_RGB);
+			for (size_t y = 0; y < height; ++y)
+			{
+				for (size_t x = 0; x < width; ++x)
+				{
+					auto uv = warp.getMapCoord(x, y);
+					auto factors = glm::vec3(0.0f);
+					if (uv.x >= 0.0f && uv.y >= 0.0f)
+					{
+						factors = edgeBlend.getFactors(uv);
+						if (blendMap.isAllocated())
+						{
+							// The blend map is spread over the same quad as the warp map, it may have a different size.
+							auto color = blendMap.getColor(x * blendMap.getWidth() / width, y * blendMap.getHeight() / height);
+							factors *= glm::vec3(color.r, color.g, color.b);
+						}
+					}
+
+					auto pixel = alphaMap.getData() + ((y * width + x) * 3);
+					for (int i = 0; i < 3; ++i)
+					{
+						pixel[i] = ofClamp(factors[i], 0.0f, 1.0f) * 65535.0f + 0.5f;
+					}
+				}
+			}
+		}
+	}
+
+	//--------------------------------------------------------------
+	bool MpcdiPackage::load(const std::string & directoryPath, std::vector<std::shared_ptr<WarpBase>> & warps)
+	{
+		auto directory = std::filesystem::path(ofToDataPath(directoryPath, true));
+
+		ofXml xml;
+		if (!xml.load((directory / "mpcdi.xml").string()))
+		{
+			ofLogWarning("MpcdiPackage::load") << "No mpcdi.xml found in directory " << directoryPath;
+			return false;
+		}
+
+		auto mpcdi = xml.getChild("MPCDI");
+		if (!mpcdi)
+		{
+			ofLogWarning("MpcdiPackage::load") << "Invalid mpcdi.xml in directory " << directoryPath;
+			return false;
+		}
+
+		// Other profiles store positions on the screen surface in their warp maps, instead of content coordinates.
+		auto profile = mpcdi.getAttribute("profile").getValue();
+		if (profile != "2d")
+		{
+			ofLogWarning("MpcdiPackage::load") << "Unsupported profile " << profile << ", only 2d packages can be loaded";
+			return false;
+		}
+
+		std::vector<std::shared_ptr<WarpBase>> loadedWarps;
+		for (auto buffer : mpcdi.getChild("display").getChildren("buffer"))
+		{
+			for (auto region : buffer.getChildren("region"))
+			{
+				auto regionId = region.getAttribute("id").getValue();
+
+				ofXml fileset;
+				for (auto candidate : mpcdi.getChild("files").getChildren("fileset"))
+				{
+					if (candidate.getAttribute("region").getValue() == regionId)
+					{
+						fileset = candidate;
+						break;
+					}
+				}
+
+				auto warpPath = fileset ? fileset.getChild("geometryWarpFile").getChild("path").getValue() : "";
+				if (warpPath.empty())
+				{
+					ofLogWarning("MpcdiPackage::load") << "Region " << regionId << " has no warp map, skipping it";
+					continue;
+				}
+
+				auto warp = std::make_shared<WarpMap>();
+				if (!warp->loadMap((directory / warpPath).string()))
+				{
+					continue;
+				}
+
+				// Place the quad at the region's position in the buffer.
+				auto x = getFloatAttribute(region, "x", 0.0f);
+				auto y = getFloatAttribute(region, "y", 0.0f);
+				auto xsize = getFloatAttribute(region, "xsize", 1.0f);
+				auto ysize = getFloatAttribute(region, "ysize", 1.0f);
+				const glm::vec2 corners[4] =
+				{
+					{ x, y },
+					{ x + xsize, y },
+					{ x + xsize, y + ysize },
+					{ x, y + ysize }
+				};
+				warp->setControlPoints(corners, 4);
+
+				// The alpha map is applied as it is, with its gamma embedded.
+				auto alphaPath = fileset.getChild("alphaMap").getChild("path").getValue();
+				if (!alphaPath.empty())
+				{
+					ofFloatPixels alphaMap;
+					if (ofLoadImage(alphaMap, (directory / alphaPath).string()))
+					{
+						warp->setBlendMap(alphaMap);
+					}
+					else
+					{
+						ofLogWarning("MpcdiPackage::load") << "Could not load the alpha map of region " << regionId;
+					}
+				}
+
+				loadedWarps.push_back(warp);
+			}
+		}
+
+		if (loadedWarps.empty())
+		{
+			ofLogWarning("MpcdiPackage::load") << "No regions could be loaded from directory " << directoryPath;
+			return false;
+		}
+
+		warps.insert(warps.end(), loadedWarps.begin(), loadedWarps.end());
+		return true;
+	}
+
+	//--------------------------------------------------------------
+	bool MpcdiPackage::save(const std::string & directoryPath, const std::vector<std::shared_ptr<WarpBase>> & warps, size_t width, size_t height)
+	{
+		auto directory = std::filesystem::path(ofToDataPath(directoryPath, true));
+		std::error_code error;
+		std::filesystem::create_directories(directory, error);
+
+		ofXml xml;
+		auto mpcdi = xml.appendChild("MPCDI");
+		mpcdi.setAttribute("profile", "2d");
+		mpcdi.setAttribute("geometry", "1");
+		mpcdi.setAttribute("version", "2.0");
+
+		auto buffer = mpcdi.appendChild("display").appendChild("buffer");
+		buffer.setAttribute("id", "buffer");
+		buffer.setAttribute("Xresolution", width);
+		buffer.setAttribute("Yresolution", height);
+
+		auto files = mpcdi.appendChild("files");
+
+		auto success = true;
+		for (size_t i = 0; i < warps.size(); ++i)
+		{
+			// Warps that aren't maps are baked into one, covering the buffer.
+			auto warpMap = std::dynamic_pointer_cast<WarpMap>(warps[i]);
+			if (!warpMap)
+			{
+				warpMap = std::make_shared<WarpMap>();
+				if (!warpMap->bake(*warps[i], width, height))
+				{
+					success = false;
+					continue;
+				}
+			}
+
+			ofRectangle bounds;
+			if (warpMap->getMapWidth() == 0 || !getRegionBounds(*warpMap, bounds))
+			{
+				ofLogWarning("MpcdiPackage::save") << "Warp " << i << " has no map or its corners don't form a rectangle, skipping it";
+				success = false;
+				continue;
+			}
+
+			auto regionId = "region" + ofToString(i);
+			auto warpPath = regionId + "_warp.pfm";
+			auto alphaPath = regionId + "_alpha.png";
+
+			if (!warpMap->saveMap((directory / warpPath).string()))
+			{
+				ofLogWarning("MpcdiPackage::save") << "Could not write the warp map of warp " << i;
+				success = false;
+				continue;
+			}
+
+			ofShortPixels alphaMap;
+			getAlphaMap(*warpMap, alphaMap);
+			if (!ofSaveImage(alphaMap, (directory / alphaPath).string()))
+			{
+				ofLogWarning("MpcdiPackage::save") << "Could not write the alpha map of warp " << i;
+				success = false;
+				continue;
+			}
+
+			auto region = buffer.appendChild("region");
+			region.setAttribute("id", regionId);
+			region.setAttribute("Xresolution", warpMap->getMapWidth());
+			region.setAttribute("Yresolution", warpMap->getMapHeight());
+			region.setAttribute("x", bounds.x);
+			region.setAttribute("y", bounds.y);
+			region.setAttribute("xsize", bounds.width);
+			region.setAttribute("ysize", bounds.height);
+
+			auto fileset = files.appendChild("fileset");
+			fileset.setAttribute("region", regionId);
+
+			auto geometryWarpFile = fileset.appendChild("geometryWarpFile");
+			geometryWarpFile.appendChild("path").set(warpPath);
+			geometryWarpFile.appendChild("interpolation").set("linear");
+
+			auto alphaMapNode = fileset.appendChild("alphaMap");
+			alphaMapNode.appendChild("path").set(alphaPath);
+			alphaMapNode.appendChild("componentDepth").set(3);
+			alphaMapNode.appendChild("bitDepth").set(16);
+			alphaMapNode.appendChild("gammaEmbedded").set(1.0f);
+		}
+
+		if (!xml.save((directory / "mpcdi.xml").string()))
+		{
+			ofLogWarning("MpcdiPackage::save") << "Could not write mpcdi.xml in directory " << directoryPath;
+			return false;
+		}
+
+		return success;
+	}
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "WarpBase.h"
+
+namespace ofxWarp
+{
+	//! Import and export of MPCDI packages using the 2D media profile, where every region (projector) has a pfm warp map
+	//! holding normalized content coordinates, and optionally an alpha map for blending.
+	//! Packages are read from and written to the directory they are extracted in, which holds mpcdi.xml and the maps.
+	class MpcdiPackage
+	{
+	public:
+		//! create a warp map for every region of the package, the warp maps are memory mapped and read in place
+		//! regions are placed at their position in the buffer, alpha maps are used as blend maps and beta maps are ignored
+		static bool load(const std::string & directoryPath, std::vector<std::shared_ptr<WarpBase>> & warps);
+
+		//! write every warp as a region covering the buffer, with a width * height warp and alpha map
+		//! warp maps are written as they are, other warps are baked first and their edge blending is written to the alpha map
+		static bool save(const std::string & directoryPath, const std::vector<std::shared_ptr<WarpBase>> & warps, size_t width, size_t height);
+	};
+}
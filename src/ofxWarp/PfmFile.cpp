@@ -0,0 +1,178 @@
+#include "PfmFile.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <utility>
+
+namespace ofxWarp
+{
+	namespace
+	{
+		//--------------------------------------------------------------
+		bool isSpace(char c)
+		{
+			return (c == ' ' || c == '\t' || c == '\n' || c == '\r');
+		}
+
+		//--------------------------------------------------------------
+		bool readToken(const char * data, size_t size, size_t & offset, std::string & token)
+		{
+			while (offset < size && isSpace(data[offset])) ++offset;
+
+			auto start = offset;
+			while (offset < size && !isSpace(data[offset])) ++offset;
+
+			token.assign(data + start, offset - start);
+			return !token.empty();
+		}
+
+		//--------------------------------------------------------------
+		bool isLittleEndian()
+		{
+			const uint32_t one = 1;
+			return (*(const char *)&one == 1);
+		}
+	}
+
+	//--------------------------------------------------------------
+	PfmFile::PfmFile()
+		: pixels(nullptr)
+		, width(0)
+		, height(0)
+		, numChannels(0)
+	{}
+
+	//--------------------------------------------------------------
+	bool PfmFile::open(const std::string & filePath)
+	{
+		this->close();
+
+		if (!this->file.open(filePath)) return false;
+
+		// The header is three whitespace separated lines of text: the type, the size and the scale.
+		auto data = this->file.getData();
+		auto size = this->file.getSize();
+		size_t offset = 0;
+		std::string type;
+		std::string width;
+		std::string height;
+		std::string scale;
+		if (!readToken(data, size, offset, type) || !readToken(data, size, offset, width) || !readToken(data, size, offset, height) || !readToken(data, size, offset, scale))
+		{
+			this->close();
+			return false;
+		}
+
+		// A single whitespace character separates the header from the pixels, where files written on Windows may have
+		// a line break of two. Pixels can start with bytes that look like whitespace, so nothing more is skipped.
+		if (offset < size && data[offset] == '\r' && offset + 1 < size && data[offset + 1] == '\n')
+		{
+			offset += 2;
+		}
+		else if (offset < size && isSpace(data[offset]))
+		{
+			++offset;
+		}
+
+		auto numChannels = (type == "PF") ? 3 : (type == "Pf") ? 1 : 0;
+		auto numColumns = std::atol(width.c_str());
+		auto numRows = std::atol(height.c_str());
+		auto scaleFactor = std::atof(scale.c_str());
+		if (numChannels == 0 || numColumns <= 0 || numRows <= 0 || scaleFactor == 0.0)
+		{
+			this->close();
+			return false;
+		}
+
+		// Divide the space that's left instead of multiplying the size out, which could overflow for a bogus header.
+		if ((size_t)numColumns > (size - offset) / sizeof(float) / numChannels / (size_t)numRows)
+		{
+			this->close();
+			return false;
+		}
+		auto numValues = (size_t)numColumns * numRows * numChannels;
+
+		// A negative scale marks little-endian pixels.
+		auto littleEndian = (scaleFactor < 0.0);
+		auto payload = data + offset;
+		if (littleEndian == isLittleEndian() && ((uintptr_t)payload % alignof(float)) == 0)
+		{
+			this->pixels = (const float *)payload;
+		}
+		else
+		{
+			this->swapped.resize(numValues);
+			memcpy(this->swapped.data(), payload, numValues * sizeof(float));
+			if (littleEndian != isLittleEndian())
+			{
+				for (auto & value : this->swapped)
+				{
+					auto bytes = (char *)&value;
+					std::swap(bytes[0], bytes[3]);
+					std::swap(bytes[1], bytes[2]);
+				}
+			}
+			this->pixels = this->swapped.data();
+		}
+
+		this->width = numColumns;
+		this->height = numRows;
+		this->numChannels = numChannels;
+		return true;
+	}
+
+	//--------------------------------------------------------------
+	void PfmFile::close()
+	{
+		this->file.close();
+		this->swapped.clear();
+		this->pixels = nullptr;
+		this->width = 0;
+		this->height = 0;
+		this->numChannels = 0;
+	}
+
+	//--------------------------------------------------------------
+	bool PfmFile::isOpen() const
+	{
+		return (this->pixels != nullptr);
+	}
+
+	//--------------------------------------------------------------
+	size_t PfmFile::getWidth() const
+	{
+		return this->width;
+	}
+
+	//--------------------------------------------------------------
+	size_t PfmFile::getHeight() const
+	{
+		return this->height;
+	}
+
+	//--------------------------------------------------------------
+	size_t PfmFile::getNumChannels() const
+	{
+		return this->numChannels;
+	}
+
+	//--------------------------------------------------------------
+	const float * PfmFile::getPixels() const
+	{
+		return this->pixels;
+	}
+
+	//--------------------------------------------------------------
+	bool PfmFile::save(const std::string & filePath, size_t width, size_t height, size_t numChannels, const float * pixels)
+	{
+		if (numChannels != 1 && numChannels != 3) return false;
+
+		std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+		file << ((numChannels == 3) ? "PF" : "Pf") << "\n" << width << " " << height << "\n" << (isLittleEndian() ? "-1.0" : "1.0") << "\n";
+		file.write((const char *)pixels, width * height * numChannels * sizeof(float));
+
+		return file.good();
+	}
+}
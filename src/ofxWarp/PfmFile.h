@@ -0,0 +1,51 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "MappedFile.h"
+
+namespace ofxWarp
+{
+	//! Portable float map, the format MPCDI packages store their warp maps in.
+	//! The file is memory mapped and its pixels are read in place, so large maps are never copied on the CPU.
+	//! Only big-endian files are copied, to swap them to the native (little-endian) byte order.
+	class PfmFile
+	{
+	public:
+		PfmFile();
+
+		PfmFile(const PfmFile &) = delete;
+		PfmFile & operator=(const PfmFile &) = delete;
+
+		//! map the file at the specified absolute path and parse its header
+		bool open(const std::string & filePath);
+		//! unmap the file
+		void close();
+
+		bool isOpen() const;
+
+		//! return the number of columns
+		size_t getWidth() const;
+		//! return the number of rows
+		size_t getHeight() const;
+		//! return the number of floats per pixel, 3 for color maps and 1 for grayscale maps
+		size_t getNumChannels() const;
+
+		//! return the pixels, rows are stored from the bottom up
+		const float * getPixels() const;
+
+		//! write a pfm file with rows stored from the bottom up, in native byte order
+		static bool save(const std::string & filePath, size_t width, size_t height, size_t numChannels, const float * pixels);
+
+	protected:
+		MappedFile file;
+		//! swapped copy of the pixels, only used when the file isn't in native byte order
+		std::vector<float> swapped;
+
+		const float * pixels;
+		size_t width;
+		size_t height;
+		size_t numChannels;
+	};
+}
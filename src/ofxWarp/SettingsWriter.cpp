@@ -0,0 +1,229 @@
+#include "SettingsWriter.h"
+
+#include "BinarySettings.h"
+#include "ofLog.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#endif
+
+namespace ofxWarp
+{
+	namespace
+	{
+		//--------------------------------------------------------------
+		void append(std::vector<char> & buffer, const std::string & str)
+		{
+			buffer.insert(buffer.end(), str.begin(), str.end());
+		}
+	}
+
+	//--------------------------------------------------------------
+	SettingsWriter::SettingsWriter()
+		: running(false)
+		, busy(false)
+		, hasPending(false)
+		, pendingNumWarps(0)
+		, pendingFormat(Controller::FORMAT_JSON)
+		, encodedFormat(Controller::FORMAT_JSON)
+	{}
+
+	//--------------------------------------------------------------
+	SettingsWriter::~SettingsWriter()
+	{
+		// Finish any queued save before shutting down, so that saving on exit is never lost.
+		{
+			std::unique_lock<std::mutex> lock(this->mutex);
+			this->running = false;
+		}
+		this->condition.notify_all();
+
+		if (this->thread.joinable())
+		{
+			this->thread.join();
+		}
+	}
+
+	//--------------------------------------------------------------
+	void SettingsWriter::save(const std::string & filePath, size_t numWarps, ChangedWarps && changedWarps, Controller::Format format)
+	{
+		{
+			std::unique_lock<std::mutex> lock(this->mutex);
+
+			// The save being replaced may hold the only copy of warps that changed since the last one was written.
+			if (this->hasPending)
+			{
+				for (auto & pending : this->pendingWarps)
+				{
+					auto replaced = std::any_of(changedWarps.begin(), changedWarps.end(), [&](const ChangedWarps::value_type & changed)
+					{
+						return (changed.first == pending.first);
+					});
+					if (pending.first < numWarps && !replaced)
+					{
+						changedWarps.push_back(std::move(pending));
+					}
+				}
+			}
+
+			this->pendingPath = filePath;
+			this->pendingNumWarps = numWarps;
+			this->pendingWarps = std::move(changedWarps);
+			this->pendingFormat = format;
+			this->hasPending = true;
+
+			if (!this->running)
+			{
+				this->running = true;
+				this->thread = std::thread(&SettingsWriter::threadedFunction, this);
+			}
+		}
+		this->condition.notify_all();
+	}
+
+	//--------------------------------------------------------------
+	bool SettingsWriter::isSaving() const
+	{
+		std::unique_lock<std::mutex> lock(this->mutex);
+		return (this->hasPending || this->busy);
+	}
+
+	//--------------------------------------------------------------
+	void SettingsWriter::waitForSave()
+	{
+		std::unique_lock<std::mutex> lock(this->mutex);
+		this->condition.wait(lock, [this]
+		{
+			return (!this->hasPending && !this->busy);
+		});
+	}
+
+	//--------------------------------------------------------------
+	void SettingsWriter::threadedFunction()
+	{
+		std::string filePath;
+		size_t numWarps;
+		ChangedWarps warps;
+		Controller::Format format;
+		std::vector<char> buffer;
+
+		while (true)
+		{
+			{
+				std::unique_lock<std::mutex> lock(this->mutex);
+				this->busy = false;
+				this->condition.notify_all();
+
+				this->condition.wait(lock, [this]
+				{
+					return (this->hasPending || !this->running);
+				});
+				if (!this->hasPending)
+				{
+					return;
+				}
+
+				filePath = std::move(this->pendingPath);
+				numWarps = this->pendingNumWarps;
+				warps = std::move(this->pendingWarps);
+				this->pendingWarps.clear();
+				format = this->pendingFormat;
+				this->hasPending = false;
+				this->busy = true;
+			}
+
+			this->encode(numWarps, warps, format, buffer);
+			if (!writeFile(filePath, buffer))
+			{
+				ofLogWarning("SettingsWriter::save") << "Could not write settings to " << filePath;
+			}
+		}
+	}
+
+	//--------------------------------------------------------------
+	void SettingsWriter::encode(size_t numWarps, const ChangedWarps & changedWarps, Controller::Format format, std::vector<char> & buffer)
+	{
+		if (format != this->encodedFormat)
+		{
+			this->encodedBlocks.clear();
+			this->encodedFormat = format;
+		}
+		this->encodedBlocks.resize(numWarps);
+
+		for (const auto & changed : changedWarps)
+		{
+			if (changed.first >= numWarps) continue;
+
+			auto & block = this->encodedBlocks[changed.first];
+			block.clear();
+			if (format == Controller::FORMAT_BINARY)
+			{
+				BinarySettings::writeWarp(changed.second, block);
+			}
+			else
+			{
+				nlohmann::json json;
+				changed.second.serialize(json);
+
+				// Indent the warp as it would be inside the "warps" array of the document.
+				auto dump = json.dump(4);
+				block.reserve(dump.size() + dump.size() / 4);
+				for (auto c : dump)
+				{
+					block.push_back(c);
+					if (c == '\n')
+					{
+						block.insert(block.end(), 8, ' ');
+					}
+				}
+			}
+		}
+
+		if (format == Controller::FORMAT_BINARY)
+		{
+			BinarySettings::writeBlocks(this->encodedBlocks, buffer);
+			return;
+		}
+
+		// Same layout as nlohmann::json::dump(4) of the whole document.
+		buffer.clear();
+		append(buffer, "{\n    \"version\": " + std::to_string(WarpData::JSON_VERSION) + ",\n    \"warps\": ");
+		if (this->encodedBlocks.empty())
+		{
+			append(buffer, "[]\n}");
+			return;
+		}
+		append(buffer, "[\n");
+		for (size_t i = 0; i < this->encodedBlocks.size(); ++i)
+		{
+			append(buffer, (i == 0) ? "        " : ",\n        ");
+			buffer.insert(buffer.end(), this->encodedBlocks[i].begin(), this->encodedBlocks[i].end());
+		}
+		append(buffer, "\n    ]\n}");
+	}
+
+	//--------------------------------------------------------------
+	bool SettingsWriter::writeFile(const std::string & filePath, const std::vector<char> & buffer)
+	{
+		auto tempPath = filePath + ".tmp";
+		{
+			std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+			file.write(buffer.data(), buffer.size());
+			if (!file.good())
+			{
+				return false;
+			}
+		}
+
+#ifdef _WIN32
+		return (MoveFileExA(tempPath.c_str(), filePath.c_str(), MOVEFILE_REPLACE_EXISTING) != 0);
+#else
+		return (std::rename(tempPath.c_str(), filePath.c_str()) == 0);
+#endif
+	}
+}
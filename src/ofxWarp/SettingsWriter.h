@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Controller.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace ofxWarp
+{
+	//! Writes settings files on a background thread.
+	//! Each warp is encoded separately and the encoding is kept until the next save, so only the warps passed in as
+	//! changed are encoded again. Files are written to a temporary path first and renamed over the target,
+	//! so a crash while saving never leaves a truncated settings file behind.
+	class SettingsWriter
+	{
+	public:
+		//! records of the warps that changed since the last save, with their index
+		typedef std::vector<std::pair<size_t, WarpData>> ChangedWarps;
+
+		SettingsWriter();
+		~SettingsWriter();
+
+		SettingsWriter(const SettingsWriter &) = delete;
+		SettingsWriter & operator=(const SettingsWriter &) = delete;
+
+		//! queue numWarps warps to be written to the absolute file path, replaces any save that hasn't started yet
+		//! warps that aren't passed in as changed are written as they were encoded last, which has to be in the same format
+		void save(const std::string & filePath, size_t numWarps, ChangedWarps && changedWarps, Controller::Format format);
+
+		//! return whether a save is queued or in progress
+		bool isSaving() const;
+		//! block until all queued saves are written
+		void waitForSave();
+
+		//! encode the changed warps, and assemble them with the encoding of the others into a settings file
+		void encode(size_t numWarps, const ChangedWarps & changedWarps, Controller::Format format, std::vector<char> & buffer);
+
+		//! write the buffer to a temporary file, then rename it to the file path
+		static bool writeFile(const std::string & filePath, const std::vector<char> & buffer);
+
+	protected:
+		void threadedFunction();
+
+	protected:
+		std::thread thread;
+		mutable std::mutex mutex;
+		std::condition_variable condition;
+
+		bool running;
+		bool busy;
+		bool hasPending;
+
+		std::string pendingPath;
+		size_t pendingNumWarps;
+		ChangedWarps pendingWarps;
+		Controller::Format pendingFormat;
+
+		//! the encoding of each warp as of the last save
+		std::vector<std::vector<char>> encodedBlocks;
+		Controller::Format encodedFormat;
+	};
+}
@@ -0,0 +1,191 @@
+#include "SoftwareRenderer.h"
+
+#include <algorithm>
+
+#include "Geometry/EdgeBlend.h"
+#include "Geometry/Sampling.h"
+#include "Geometry/Shading.h"
+#include "Geometry/WarpMesh.h"
+#include "WarpMap.h"
+
+namespace ofxWarp
+{
+	//--------------------------------------------------------------
+	SoftwareRenderer::SoftwareRenderer(ThreadPool & threadPool)
+		: threadPool(threadPool)
+		, tileHeight(16)
+	{}
+
+	//--------------------------------------------------------------
+	void SoftwareRenderer::setTileHeight(size_t tileHeight)
+	{
+		this->tileHeight = std::max(tileHeight, (size_t)1);
+	}
+
+	//--------------------------------------------------------------
+	size_t SoftwareRenderer::getTileHeight() const
+	{
+		return this->tileHeight;
+	}
+
+	//--------------------------------------------------------------
+	bool SoftwareRenderer::draw(const WarpBase & warp, const ofFloatPixels & content, ofFloatPixels & output) const
+	{
+		const auto contentChannels = content.getNumChannels();
+		if (!content.isAllocated() || (contentChannels != 3 && contentChannels != 4))
+		{
+			ofLogWarning("SoftwareRenderer::draw") << "Expected content with 3 or 4 channels";
+			return false;
+		}
+
+		if (!output.isAllocated())
+		{
+			const auto windowSize = warp.getWindowSize();
+			output.allocate(windowSize.x, windowSize.y, OF_PIXELS_RGBA);
+			output.set(0.0f);
+		}
+		const auto outputChannels = output.getNumChannels();
+		if (outputChannels != 3 && outputChannels != 4)
+		{
+			ofLogWarning("SoftwareRenderer::draw") << "Expected an output with 3 or 4 channels but got " << outputChannels;
+			return false;
+		}
+
+		const auto width = output.getWidth();
+		const auto height = output.getHeight();
+		auto bands = this->getBands(warp, width, height);
+		if (bands == nullptr)
+		{
+			ofLogWarning("SoftwareRenderer::draw") << "Warp of type " << warp.getType() << " isn't drawn as a mesh and can't be rendered";
+			return false;
+		}
+
+		// Dark warps are skipped, as in Controller::draw(), and brightness only ever darkens.
+		const auto brightness = std::min(warp.getBrightness(), 1.0f);
+		if (brightness <= 0.0f) return true;
+
+		const auto edgeBlend = warp.getEdgeBlend();
+		const auto warpMap = dynamic_cast<const WarpMap *>(&warp);
+
+		this->threadPool.parallelFor(height, bands->bandHeight, [&](size_t begin, size_t end)
+		{
+			// Ranges line up with the bands, as they are cut at the same height.
+			auto band = begin / bands->bandHeight;
+			auto bandBegin = bands->bandStarts[band];
+			auto bandEnd = bands->bandStarts[band + 1];
+			if (bandBegin == bandEnd) return;
+
+			std::vector<glm::vec2> coords((end - begin) * width, glm::vec2(-1.0f));
+			bands->mesh.bakeMap(width, height, bands->screenSize, bands->bandTriangles.data() + bandBegin, bandEnd - bandBegin, coords.data(), begin, end);
+
+			// Colors and factors are gathered per row, then shaded and blended in loops without branches.
+			std::vector<float> colors(width * 4);
+			std::vector<float> factors(width * 4);
+			for (auto y = begin; y < end; ++y)
+			{
+				auto rowCoords = coords.data() + ((y - begin) * width);
+				for (size_t x = 0; x < width; ++x)
+				{
+					auto color = colors.data() + (x * 4);
+					auto factor = factors.data() + (x * 4);
+
+					// Pixels without content are transparent, so blending leaves the output untouched.
+					auto uv = rowCoords[x];
+					if (warpMap != nullptr && uv.x >= 0.0f && uv.y >= 0.0f)
+					{
+						uv = warpMap->sampleMap(rowCoords[x]);
+					}
+					if (!(uv.x >= 0.0f && uv.y >= 0.0f))
+					{
+						std::fill(color, color + 4, 0.0f);
+						std::fill(factor, factor + 4, 0.0f);
+						continue;
+					}
+
+					sampleBilinear(content.getData(), content.getWidth(), content.getHeight(), contentChannels, uv, color);
+					if (contentChannels == 3) color[3] = 1.0f;
+
+					// Edge blending only scales the colors, alpha is kept.
+					auto blend = edgeBlend.getFactors(uv) * brightness;
+					if (warpMap != nullptr) blend *= warpMap->sampleBlendMap(rowCoords[x]);
+					factor[0] = blend.r;
+					factor[1] = blend.g;
+					factor[2] = blend.b;
+					factor[3] = 1.0f;
+				}
+
+				shadePixels(colors.data(), factors.data(), width);
+				blendPixels(colors.data(), output.getData() + (y * width * outputChannels), width, outputChannels);
+			}
+		});
+
+		return true;
+	}
+
+	//--------------------------------------------------------------
+	bool SoftwareRenderer::draw(const std::vector<std::shared_ptr<WarpBase>> & warps, const ofFloatPixels & content, ofFloatPixels & output) const
+	{
+		auto success = true;
+		for (auto & warp : warps)
+		{
+			success &= this->draw(*warp, content, output);
+		}
+
+		// Forget the warps that were removed, before another warp can take their address.
+		std::lock_guard<std::mutex> lock(this->cacheMutex);
+		for (auto it = this->cache.begin(); it != this->cache.end();)
+		{
+			auto drawn = std::any_of(warps.begin(), warps.end(), [&](const std::shared_ptr<WarpBase> & warp)
+			{
+				return (warp.get() == it->first);
+			});
+			it = drawn ? std::next(it) : this->cache.erase(it);
+		}
+
+		return success;
+	}
+
+	//--------------------------------------------------------------
+	void SoftwareRenderer::clearCache()
+	{
+		std::lock_guard<std::mutex> lock(this->cacheMutex);
+		this->cache.clear();
+	}
+
+	//--------------------------------------------------------------
+	std::shared_ptr<const SoftwareRenderer::Bands> SoftwareRenderer::getBands(const WarpBase & warp, size_t width, size_t height) const
+	{
+		const auto revision = warp.getRevision();
+		const auto screenSize = warp.getWindowSize();
+		{
+			std::lock_guard<std::mutex> lock(this->cacheMutex);
+			auto it = this->cache.find(&warp);
+			if (it != this->cache.end())
+			{
+				const auto & bands = *it->second;
+				if (bands.revision == revision && bands.screenSize == screenSize && bands.width == width
+					&& bands.height == height && bands.bandHeight == this->tileHeight)
+				{
+					return it->second;
+				}
+			}
+		}
+
+		// Maps are drawn as a quad whose coordinates are looked up in the map, like in the shader.
+		auto bands = std::make_shared<Bands>();
+		auto warpMap = dynamic_cast<const WarpMap *>(&warp);
+		auto meshed = (warpMap != nullptr) ? warpMap->WarpPerspective::getMesh(bands->mesh) : warp.getMesh(bands->mesh);
+		if (!meshed) return nullptr;
+
+		bands->revision = revision;
+		bands->screenSize = screenSize;
+		bands->width = width;
+		bands->height = height;
+		bands->bandHeight = this->tileHeight;
+		bands->mesh.getBands(width, height, screenSize, bands->bandHeight, bands->bandStarts, bands->bandTriangles);
+
+		std::lock_guard<std::mutex> lock(this->cacheMutex);
+		this->cache[&warp] = bands;
+		return bands;
+	}
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "ofPixels.h"
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "ThreadPool.h"
+#include "WarpBase.h"
+
+namespace ofxWarp
+{
+	//! Draws warps into pixels on the CPU, with the same steps as the warp shaders, so content can be warped without a
+	//! GL context, for example to render frames offline or to check a calibration on a headless machine.
+	//! The output is split in bands of rows that are rasterized and shaded on the thread pool. Each band only rasterizes
+	//! the triangles binned to it, and the binned mesh is cached until the warp's revision or the output size changes.
+	//! Every band is shaded row by row in contiguous arrays, with the blending loop specialized for 3 and 4 channels,
+	//! so the compiler can vectorize it (see shadePixels() and blendPixels()).
+	//! The editing overlay isn't drawn.
+	class SoftwareRenderer
+	{
+	public:
+		//! render on the specified thread pool, which must outlive the renderer
+		SoftwareRenderer(ThreadPool & threadPool = ThreadPool::getShared());
+
+		//! set the number of rows each task renders, larger bands have less overhead but balance worse across cores
+		void setTileHeight(size_t tileHeight);
+		size_t getTileHeight() const;
+
+		//! draw the content warped into the output, blended over what the output holds like the GPU blends with alpha
+		//! the output covers the window of the warp at its own resolution, if it isn't allocated it is allocated
+		//! with 4 channels at the window size and cleared to transparent black
+		//! the content and the output must have 3 or 4 channels, return false if they don't or the warp isn't supported
+		bool draw(const WarpBase & warp, const ofFloatPixels & content, ofFloatPixels & output) const;
+		//! draw each warp in turn, like Controller::draw()
+		//! the cached meshes of warps that aren't in the list any more are released
+		bool draw(const std::vector<std::shared_ptr<WarpBase>> & warps, const ofFloatPixels & content, ofFloatPixels & output) const;
+
+		//! release all cached meshes, warps are told apart by their address so call this after deleting warps
+		//! that were drawn with the single warp overload
+		void clearCache();
+
+	protected:
+		//! mesh of a warp with its triangles binned into the bands of the output
+		struct Bands
+		{
+			uint64_t revision;
+			glm::vec2 screenSize;
+			size_t width;
+			size_t height;
+			size_t bandHeight;
+
+			WarpMesh mesh;
+			std::vector<uint32_t> bandStarts;
+			std::vector<uint32_t> bandTriangles;
+		};
+
+		//! return the binned mesh of a warp for an output size, from the cache unless the warp changed
+		//! return nullptr if the warp isn't drawn as a mesh
+		std::shared_ptr<const Bands> getBands(const WarpBase & warp, size_t width, size_t height) const;
+
+	protected:
+		ThreadPool & threadPool;
+		size_t tileHeight;
+
+		//! binned meshes by warp, draw() may be called from several threads
+		mutable std::map<const WarpBase *, std::shared_ptr<const Bands>> cache;
+		mutable std::mutex cacheMutex;
+	};
+}
@@ -0,0 +1,131 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+
+namespace ofxWarp
+{
+	//--------------------------------------------------------------
+	ThreadPool::ThreadPool(size_t numThreads)
+		: running(true)
+	{
+		numThreads = std::max<size_t>(1, numThreads);
+		for (size_t i = 0; i < numThreads; ++i)
+		{
+			this->threads.emplace_back(&ThreadPool::threadedFunction, this);
+		}
+	}
+
+	//--------------------------------------------------------------
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::unique_lock<std::mutex> lock(this->mutex);
+			this->running = false;
+		}
+		this->condition.notify_all();
+
+		for (auto & thread : this->threads)
+		{
+			thread.join();
+		}
+	}
+
+	//--------------------------------------------------------------
+	void ThreadPool::parallelFor(size_t count, size_t grainSize, const std::function<void(size_t begin, size_t end)> & function)
+	{
+		grainSize = std::max<size_t>(1, grainSize);
+		auto numRanges = (count + grainSize - 1) / grainSize;
+		if (numRanges <= 1)
+		{
+			if (count > 0)
+			{
+				function(0, count);
+			}
+			return;
+		}
+
+		struct State
+		{
+			std::atomic<size_t> nextRange;
+			size_t numDone;
+			std::mutex mutex;
+			std::condition_variable condition;
+		};
+		auto state = std::make_shared<State>();
+		state->nextRange = 0;
+		state->numDone = 0;
+
+		auto run = [state, numRanges, count, grainSize, function]
+		{
+			while (true)
+			{
+				auto range = state->nextRange++;
+				if (range >= numRanges) return;
+
+				auto begin = range * grainSize;
+				function(begin, std::min(begin + grainSize, count));
+
+				std::unique_lock<std::mutex> lock(state->mutex);
+				if (++state->numDone == numRanges)
+				{
+					state->condition.notify_all();
+				}
+			}
+		};
+
+		// Helpers that only start once all ranges are taken return right away, so there is
+		// no need to wait for them, only for the ranges that were taken.
+		auto numHelpers = std::min(this->threads.size(), numRanges - 1);
+		for (size_t i = 0; i < numHelpers; ++i)
+		{
+			this->submit(run);
+		}
+		run();
+
+		std::unique_lock<std::mutex> lock(state->mutex);
+		state->condition.wait(lock, [&]
+		{
+			return (state->numDone == numRanges);
+		});
+	}
+
+	//--------------------------------------------------------------
+	size_t ThreadPool::getNumThreads() const
+	{
+		return this->threads.size();
+	}
+
+	//--------------------------------------------------------------
+	ThreadPool & ThreadPool::getShared()
+	{
+		static auto numCores = std::thread::hardware_concurrency();
+		static ThreadPool pool((numCores > 1) ? numCores - 1 : 1);
+		return pool;
+	}
+
+	//--------------------------------------------------------------
+	void ThreadPool::threadedFunction()
+	{
+		while (true)
+		{
+			std::function<void()> task;
+			{
+				std::unique_lock<std::mutex> lock(this->mutex);
+				this->condition.wait(lock, [this]
+				{
+					return (!this->tasks.empty() || !this->running);
+				});
+				if (this->tasks.empty())
+				{
+					return;
+				}
+
+				task = std::move(this->tasks.front());
+				this->tasks.pop_front();
+			}
+
+			task();
+		}
+	}
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ofxWarp
+{
+	//! Fixed set of worker threads for CPU work that shouldn't block the render thread.
+	class ThreadPool
+	{
+	public:
+		//! start the specified number of worker threads, at least one thread is always started
+		ThreadPool(size_t numThreads);
+		//! finish all queued tasks, then stop the worker threads
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool &) = delete;
+		ThreadPool & operator=(const ThreadPool &) = delete;
+
+		//! queue a task, the returned future becomes ready once it has run
+		template<typename Function>
+		std::future<void> submit(Function function)
+		{
+			auto task = std::make_shared<std::packaged_task<void()>>(std::move(function));
+			auto future = task->get_future();
+			{
+				std::unique_lock<std::mutex> lock(this->mutex);
+				this->tasks.push_back([task]
+				{
+					(*task)();
+				});
+			}
+			this->condition.notify_one();
+
+			return future;
+		}
+
+		//! call function(begin, end) on consecutive ranges of at most grainSize items, until all count items are done
+		//! the calling thread takes ranges as well, so this can be called from a task without waiting for a free worker
+		void parallelFor(size_t count, size_t grainSize, const std::function<void(size_t begin, size_t end)> & function);
+
+		//! return the number of worker threads
+		size_t getNumThreads() const;
+
+		//! return the pool shared by all warps, it keeps one core free for the render thread
+		static ThreadPool & getShared();
+
+	protected:
+		void threadedFunction();
+
+	protected:
+		std::vector<std::thread> threads;
+		std::mutex mutex;
+		std::condition_variable condition;
+		std::deque<std::function<void()>> tasks;
+		bool running;
+	};
+}
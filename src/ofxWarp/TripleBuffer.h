@@ -0,0 +1,68 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace ofxWarp
+{
+	//! Lock-free triple buffer, for handing the latest value from one producer thread to one consumer thread.
+	//! The producer fills the write buffer and publishes it, the consumer picks up the most recently published
+	//! buffer whenever it is ready to. Neither side ever waits, and intermediate values may be skipped.
+	template<typename Type>
+	class TripleBuffer
+	{
+	public:
+		TripleBuffer()
+			: writeIndex(0)
+			, middle(1)
+			, readIndex(2)
+		{}
+
+		TripleBuffer(const TripleBuffer &) = delete;
+		TripleBuffer & operator=(const TripleBuffer &) = delete;
+
+		//! return the buffer the producer writes to, only call this from the producer thread
+		Type & getWriteBuffer()
+		{
+			return this->buffers[this->writeIndex];
+		}
+
+		//! make the write buffer the latest value, only call this from the producer thread
+		void publish()
+		{
+			auto previous = this->middle.exchange(this->writeIndex | FRESH_FLAG, std::memory_order_acq_rel);
+			this->writeIndex = previous & INDEX_MASK;
+		}
+
+		//! swap in the latest published value, returns false if nothing was published since the last call
+		//! only call this from the consumer thread
+		bool update()
+		{
+			if (!(this->middle.load(std::memory_order_relaxed) & FRESH_FLAG)) return false;
+
+			auto previous = this->middle.exchange(this->readIndex, std::memory_order_acq_rel);
+			this->readIndex = previous & INDEX_MASK;
+
+			return true;
+		}
+
+		//! return the buffer the consumer reads from, only call this from the consumer thread
+		const Type & getReadBuffer() const
+		{
+			return this->buffers[this->readIndex];
+		}
+
+	protected:
+		static const uint8_t INDEX_MASK = 0x3;
+		static const uint8_t FRESH_FLAG = 0x4;
+
+		Type buffers[3];
+
+		//! only touched by the producer
+		uint8_t writeIndex;
+		//! index of the buffer between the two threads, with a flag set when it holds an unread value
+		std::atomic<uint8_t> middle;
+		//! only touched by the consumer
+		uint8_t readIndex;
+	};
+}
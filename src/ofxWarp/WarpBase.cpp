@@ -1,6 +1,8 @@
 #include "WarpBase.h"
 
-#include "ofPolyline.h"
+#include "ControlPointRenderer.h"
+#include "Geometry/Clip.h"
+#include "ThreadPool.h"
 
 namespace ofxWarp
 {
@@ -13,12 +15,20 @@ namespace ofxWarp
 		WarpBase::shaderPath = shaderPath;
 	}
 
+	//--------------------------------------------------------------
+	const std::filesystem::path & WarpBase::getShaderPath()
+	{
+		return WarpBase::shaderPath;
+	}
+
 	//--------------------------------------------------------------
 	WarpBase::WarpBase(Type type)
 		: type(type)
 		, editing(false)
 		, dirty(true)
+		, revision(1)
 		, brightness(1.0f)
+		, opaque(false)
 		, width(640.0f)
 		, height(480.0f)
 		, numControlsX(2)
@@ -29,6 +39,10 @@ namespace ofxWarp
 		, gamma(1.0f)
 		, exponent(2.0f)
 		, edges(0.0f)
+		, screenPointRevision(0)
+		, pointGridRevision(0)
+		, screenBoundsRevision(0)
+		, triangleGridRevision(0)
 	{
 		this->windowSize = glm::vec2(ofGetWidth(), ofGetHeight());
 	}
@@ -45,98 +59,136 @@ namespace ofxWarp
 
 	//--------------------------------------------------------------
 	void WarpBase::serialize(nlohmann::json & json)
+	{
+		WarpData data;
+		this->serialize(data);
+		data.serialize(json);
+	}
+	
+	//--------------------------------------------------------------
+	void WarpBase::deserialize(const nlohmann::json & json)
+	{
+		WarpData data;
+		if (!data.deserialize(json))
+		{
+			ofLogWarning("WarpBase::deserialize") << "Ignoring a malformed warp record";
+			return;
+		}
+		this->deserialize(data);
+	}
+
+	//--------------------------------------------------------------
+	void WarpBase::serialize(WarpData & data) const
 	{
 		// Main parameters.
-		json["type"] = this->type;
-		json["brightness"] = this->brightness;
+		data.type = this->type;
+		data.brightness = this->brightness;
 
 		// Warp parameters.
-		{
-			auto & jsonWarp = json["warp"];
+		data.numControlsX = this->numControlsX;
+		data.numControlsY = this->numControlsY;
+		data.controlPoints = this->controlPoints;
 
-			jsonWarp["columns"] = this->numControlsX;
-			jsonWarp["rows"] = this->numControlsY;
+		// Blend parameters.
+		data.exponent = this->exponent;
+		data.edges = this->edges;
+		data.gamma = this->gamma;
+		data.luminance = this->luminance;
+	}
 
-			std::vector<std::string> points;
-			for (auto & controlPoint : this->controlPoints)
-			{
-				std::ostringstream oss;
-				oss << controlPoint;
-				points.push_back(oss.str());
-			}
-			jsonWarp["control points"] = points;
+	//--------------------------------------------------------------
+	void WarpBase::deserialize(const WarpData & data)
+	{
+		if (data.controlPoints.size() != data.numControlsX * data.numControlsY || !this->isValidGrid(data.numControlsX, data.numControlsY))
+		{
+			ofLogWarning("WarpBase::deserialize") << "Control points don't match a " << data.numControlsX << "x" << data.numControlsY << " grid, ignoring record";
+			return;
 		}
 
-		// Blend parameters.
-		{
-			auto & jsonBlend = json["blend"];
+		// Blend parameters are only used at draw time, so only a change in the control grid needs a rebuild.
+		auto geometryChanged = (this->numControlsX != data.numControlsX
+			|| this->numControlsY != data.numControlsY
+			|| this->controlPoints != data.controlPoints);
 
-			jsonBlend["exponent"] = this->exponent;
+		// Main parameters.
+		this->type = (Type)data.type;
+		this->brightness = data.brightness;
 
-			std::ostringstream oss;
-			oss << this->edges;
-			jsonBlend["edges"] = oss.str();
+		// Warp parameters.
+		this->numControlsX = data.numControlsX;
+		this->numControlsY = data.numControlsY;
+		this->controlPoints = data.controlPoints;
 
-			oss.str("");
-			oss << this->gamma;
-			jsonBlend["gamma"] = oss.str();
+		// Blend parameters.
+		this->exponent = data.exponent;
+		this->edges = data.edges;
+		this->gamma = data.gamma;
+		this->luminance = data.luminance;
 
-			oss.str("");
-			oss << this->luminance;
-			jsonBlend["luminance"] = oss.str();
+		if (geometryChanged)
+		{
+			this->markDirty();
 		}
 	}
-	
+
 	//--------------------------------------------------------------
-	void WarpBase::deserialize(const nlohmann::json & json)
+	void WarpBase::getParameters(WarpParameters & parameters) const
 	{
-		// Main parameters.
-		int typeAsInt = json["type"];
-		this->type = (Type)typeAsInt;
-		this->brightness = json["brightness"];
+		parameters.brightness = this->brightness;
 
-		// Warp parameters.
-		{
-			const auto & jsonWarp = json["warp"];
+		parameters.numControlsX = this->numControlsX;
+		parameters.numControlsY = this->numControlsY;
+		parameters.controlPoints = this->controlPoints;
 
-			this->numControlsX = jsonWarp["columns"];
-			this->numControlsY = jsonWarp["rows"];
+		parameters.exponent = this->exponent;
+		parameters.edges = this->edges;
+		parameters.gamma = this->gamma;
+		parameters.luminance = this->luminance;
+	}
 
-			this->controlPoints.clear();
-			for (const auto & jsonPoint : jsonWarp["control points"])
-			{
-				glm::vec2 controlPoint;
-				std::istringstream iss;
-				iss.str(jsonPoint);
-				iss >> controlPoint;
-				this->controlPoints.push_back(controlPoint);
-			}
-		}
+	//--------------------------------------------------------------
+	void WarpBase::publishParameters(const WarpParameters & parameters)
+	{
+		// Assigning keeps the capacity of the write buffer, so publishing doesn't allocate once it has warmed up.
+		this->parameterChannel.getWriteBuffer() = parameters;
+		this->parameterChannel.publish();
+	}
 
-		// Blend parameters.
+	//--------------------------------------------------------------
+	bool WarpBase::applyParameterUpdates()
+	{
+		if (!this->parameterChannel.update()) return false;
+
+		const auto & parameters = this->parameterChannel.getReadBuffer();
+		if (parameters.controlPoints.size() != parameters.numControlsX * parameters.numControlsY || !this->isValidGrid(parameters.numControlsX, parameters.numControlsY))
 		{
-			const auto & jsonBlend = json["blend"];
+			ofLogWarning("WarpBase::applyParameterUpdates") << "Control points don't match a " << parameters.numControlsX << "x" << parameters.numControlsY << " grid, ignoring update";
+			return false;
+		}
 
-			this->exponent = jsonBlend["exponent"];
+		this->brightness = parameters.brightness;
 
-			{
-				std::istringstream iss;
-				iss.str(jsonBlend["edges"]);
-				iss >> this->edges;
-			}
-			{
-				std::istringstream iss;
-				iss.str(jsonBlend["gamma"]);
-				iss >> this->gamma;
-			}
-			{
-				std::istringstream iss;
-				iss.str(jsonBlend["luminance"]);
-				iss >> this->luminance;
-			}
+		this->exponent = parameters.exponent;
+		this->edges = parameters.edges;
+		this->gamma = parameters.gamma;
+		this->luminance = parameters.luminance;
+
+		// Only a change in the control grid needs a rebuild.
+		if (this->numControlsX != parameters.numControlsX || this->numControlsY != parameters.numControlsY || this->controlPoints != parameters.controlPoints)
+		{
+			this->numControlsX = parameters.numControlsX;
+			this->numControlsY = parameters.numControlsY;
+			this->controlPoints = parameters.controlPoints;
+			this->markDirty();
 		}
 
-		this->dirty = true;
+		return true;
+	}
+
+	//--------------------------------------------------------------
+	bool WarpBase::isValidGrid(size_t numControlsX, size_t numControlsY) const
+	{
+		return (numControlsX >= 2 && numControlsY >= 2);
 	}
 
 	//--------------------------------------------------------------
@@ -186,7 +238,7 @@ namespace ofxWarp
 	{
 		this->width = width;
 		this->height = height;
-		this->dirty = true;
+		this->markDirty();
 	}
 	
 	//--------------------------------------------------------------
@@ -219,6 +271,18 @@ namespace ofxWarp
 		return this->brightness;
 	}
 
+	//--------------------------------------------------------------
+	void WarpBase::setOpaque(bool opaque)
+	{
+		this->opaque = opaque;
+	}
+
+	//--------------------------------------------------------------
+	bool WarpBase::isOpaque() const
+	{
+		return this->opaque;
+	}
+
 	//--------------------------------------------------------------
 	void WarpBase::setLuminance(float luminance)
 	{
@@ -300,6 +364,17 @@ namespace ofxWarp
 		return this->edges * 2.0f;
 	}
 
+	//--------------------------------------------------------------
+	EdgeBlend WarpBase::getEdgeBlend() const
+	{
+		EdgeBlend edgeBlend;
+		edgeBlend.edges = this->edges;
+		edgeBlend.exponent = this->exponent;
+		edgeBlend.luminance = this->luminance;
+		edgeBlend.gamma = this->gamma;
+		return edgeBlend;
+	}
+
 	//--------------------------------------------------------------
 	void WarpBase::draw(const ofTexture & texture)
 	{
@@ -322,69 +397,96 @@ namespace ofxWarp
 	//--------------------------------------------------------------
 	bool WarpBase::clip(ofRectangle & srcBounds, ofRectangle & dstBounds) const
 	{
-		bool clipped = false;
+		auto srcVec = glm::vec4(srcBounds.x, srcBounds.y, srcBounds.width, srcBounds.height);
+		auto dstVec = glm::vec4(dstBounds.x, dstBounds.y, dstBounds.width, dstBounds.height);
 
-		glm::vec4 srcVec = glm::vec4(srcBounds.getMinX(), srcBounds.getMinY(), srcBounds.getMaxX(), srcBounds.getMaxY());
-		glm::vec4 dstVec = glm::vec4(dstBounds.getMinX(), dstBounds.getMinY(), dstBounds.getMaxX(), dstBounds.getMaxY());
-		
-		float x1 = dstVec.x / this->width;
-		float x2 = dstVec.z / this->width;
-		float y1 = dstVec.y / this->height;
-		float y2 = dstVec.w / this->height;
+		auto clipped = clipBounds(srcVec, dstVec, this->getSize());
 
-		if (x1 < 0.0f) 
-		{
-			dstVec.x = 0.0f;
-			srcVec.x -= (x1 * srcBounds.getWidth());
-			clipped = true;
-		}
-		else if (x1 > 1.0f) 
-		{
-			dstVec.x = this->width;
-			srcVec.x -= ((1.0f / x1) * srcBounds.getWidth());
-			clipped = true;
-		}
+		srcBounds.set(srcVec.x, srcVec.y, srcVec.z, srcVec.w);
+		dstBounds.set(dstVec.x, dstVec.y, dstVec.z, dstVec.w);
 
-		if (x2 < 0.0f) 
-		{
-			dstVec.z = 0.0f;
-			srcVec.z -= (x2 * srcBounds.getWidth());
-			clipped = true;
-		}
-		else if (x2 > 1.0f) {
-			dstVec.z = this->width;
-			srcVec.z -= ((1.0f / x2) * srcBounds.getWidth());
-			clipped = true;
-		}
+		return clipped;
+	}
 
-		if (y1 < 0.0f) 
-		{
-			dstVec.y = 0.0f;
-			srcVec.y -= (y1 * srcBounds.getHeight());
-			clipped = true;
-		}
-		else if (y1 > 1.0f) 
+	//--------------------------------------------------------------
+	ofRectangle WarpBase::getScreenBounds() const
+	{
+		auto currentRevision = this->getRevision();
+		if (this->screenBoundsRevision != currentRevision)
 		{
-			dstVec.y = this->height;
-			srcVec.y -= ((1.0f / y1) * srcBounds.getHeight());
-			clipped = true;
+			const auto & points = this->getScreenControlPoints();
+			if (points.empty())
+			{
+				this->screenBounds = ofRectangle();
+			}
+			else
+			{
+				auto min = points.front();
+				auto max = points.front();
+				for (const auto & pt : points)
+				{
+					min = glm::min(min, pt);
+					max = glm::max(max, pt);
+				}
+
+				auto margin = glm::vec2(this->getScreenBoundsMargin(points));
+				this->screenBounds = ofRectangle(min - margin, max + margin);
+			}
+			this->screenBoundsRevision = currentRevision;
 		}
 
-		if (y2 < 0.0f) {
-			dstVec.w = 0.0f;
-			srcVec.w -= (y2 * srcBounds.getHeight());
-			clipped = true;
-		}
-		else if (y2 > 1.0f) {
-			dstVec.w = this->height;
-			srcVec.w -= ((1.0f / y2) * srcBounds.getHeight());
-			clipped = true;
-		}
+		return this->screenBounds;
+	}
 
-		srcBounds.set(srcVec.x, srcVec.y, srcVec.z - srcVec.x, srcVec.w - srcVec.y);
-		dstBounds.set(dstVec.x, dstVec.y, dstVec.z - dstVec.x, dstVec.w - dstVec.y);
+	//--------------------------------------------------------------
+	bool WarpBase::covers(const ofRectangle & screenBounds) const
+	{
+		return false;
+	}
 
-		return clipped;
+	//--------------------------------------------------------------
+	bool WarpBase::getMesh(WarpMesh & mesh) const
+	{
+		mesh.clear();
+		return false;
+	}
+
+	//--------------------------------------------------------------
+	bool WarpBase::getContentCoord(const glm::vec2 & screenPoint, glm::vec2 & contentPoint) const
+	{
+		glm::vec2 coord;
+		if (!this->getTriangleGrid()->find(screenPoint, coord) || !this->resolveContentCoord(coord)) return false;
+
+		contentPoint = coord;
+		return true;
+	}
+
+	//--------------------------------------------------------------
+	size_t WarpBase::getContentCoords(const glm::vec2 * screenPoints, size_t numPoints, glm::vec2 * contentPoints) const
+	{
+		// Build the grid up front, the workers only read from it.
+		auto grid = this->getTriangleGrid();
+
+		std::atomic<size_t> numFound(0);
+		ThreadPool::getShared().parallelFor(numPoints, 1024, [&](size_t begin, size_t end)
+		{
+			size_t found = 0;
+			for (auto i = begin; i < end; ++i)
+			{
+				auto & coord = contentPoints[i];
+				if (grid->find(screenPoints[i], coord) && this->resolveContentCoord(coord))
+				{
+					++found;
+				}
+				else
+				{
+					coord = glm::vec2(-1.0f);
+				}
+			}
+			numFound += found;
+		});
+
+		return numFound;
 	}
 
 	//--------------------------------------------------------------
@@ -401,7 +503,7 @@ namespace ofxWarp
 		if (index >= this->controlPoints.size()) return;
 
 		this->controlPoints[index] = pos;
-		this->dirty = true;
+		this->markDirty();
 	}
 
 	//--------------------------------------------------------------
@@ -410,7 +512,7 @@ namespace ofxWarp
 		if (index >= this->controlPoints.size()) return;
 
 		this->controlPoints[index] += shift;
-		this->dirty = true;
+		this->markDirty();
 	}
 
 	//--------------------------------------------------------------
@@ -419,6 +521,46 @@ namespace ofxWarp
 		return this->controlPoints.size();
 	}
 
+	//--------------------------------------------------------------
+	void WarpBase::getControlPoints(glm::vec2 * points, size_t numPoints) const
+	{
+		numPoints = MIN(numPoints, this->controlPoints.size());
+		std::copy(this->controlPoints.begin(), this->controlPoints.begin() + numPoints, points);
+	}
+
+	//--------------------------------------------------------------
+	void WarpBase::setControlPoints(const glm::vec2 * points, size_t numPoints)
+	{
+		numPoints = MIN(numPoints, this->controlPoints.size());
+		std::copy(points, points + numPoints, this->controlPoints.begin());
+		this->markDirty();
+	}
+
+	//--------------------------------------------------------------
+	void WarpBase::setControlPoints(const std::vector<glm::vec2> & points)
+	{
+		if (points.size() != this->getNumControlPoints())
+		{
+			ofLogWarning("WarpBase::setControlPoints") << "Expected " << this->getNumControlPoints() << " points, got " << points.size();
+			return;
+		}
+
+		this->setControlPoints(points.data(), points.size());
+	}
+
+	//--------------------------------------------------------------
+	void WarpBase::transformControlPoints(const size_t * indices, size_t numIndices, const glm::mat3 & transform)
+	{
+		for (size_t i = 0; i < numIndices; ++i)
+		{
+			if (indices[i] >= this->controlPoints.size()) continue;
+
+			auto & pt = this->controlPoints[indices[i]];
+			pt = glm::vec2(transform * glm::vec3(pt, 1.0f));
+		}
+		this->markDirty();
+	}
+
 	//--------------------------------------------------------------
 	size_t WarpBase::getSelectedControlPoint() const
 	{
@@ -443,23 +585,56 @@ namespace ofxWarp
 	//--------------------------------------------------------------
 	size_t WarpBase::findClosestControlPoint(const glm::vec2 & pos, float * distance) const
 	{
-		size_t index;
-		auto minDistance = std::numeric_limits<float>::max();
-
-		for (auto i = 0; i < this->controlPoints.size(); ++i)
+		// The grid is rebuilt lazily, so dragging a point only costs a rebuild on the next pick.
+		const auto & screenPoints = this->getScreenControlPoints();
+		if (this->pointGridRevision != this->screenPointRevision)
 		{
-			auto candidate = glm::distance(pos, this->getControlPoint(i) * this->windowSize);
-			if (candidate < minDistance)
-			{
-				minDistance = candidate;
-				index = i;
-			}
+			this->pointGrid.build(screenPoints.data(), screenPoints.size());
+			this->pointGridRevision = this->screenPointRevision;
 		}
 
+		float minDistance;
+		auto index = this->pointGrid.findClosest(pos, &minDistance);
+
 		*distance = minDistance;
 		return index;
 	}
 
+	//--------------------------------------------------------------
+	bool WarpBase::getLocatorMesh(WarpMesh & mesh) const
+	{
+		return this->getMesh(mesh);
+	}
+
+	//--------------------------------------------------------------
+	bool WarpBase::resolveContentCoord(glm::vec2 & coord) const
+	{
+		return true;
+	}
+
+	//--------------------------------------------------------------
+	std::shared_ptr<const TriangleGrid> WarpBase::getTriangleGrid() const
+	{
+		auto currentRevision = this->getRevision();
+		if (this->triangleGrid == nullptr || this->triangleGridRevision != currentRevision)
+		{
+			WarpMesh mesh;
+			this->getLocatorMesh(mesh);
+			auto grid = std::make_shared<TriangleGrid>();
+			grid->build(mesh);
+			this->triangleGrid = grid;
+			this->triangleGridRevision = currentRevision;
+		}
+
+		return this->triangleGrid;
+	}
+
+	//--------------------------------------------------------------
+	uint64_t WarpBase::getRevision() const
+	{
+		return this->revision;
+	}
+
 	//--------------------------------------------------------------
 	size_t WarpBase::getNumControlsX() const
 	{
@@ -472,6 +647,38 @@ namespace ofxWarp
 		return this->numControlsY;
 	}
 
+	//--------------------------------------------------------------
+	void WarpBase::markDirty()
+	{
+		this->dirty = true;
+		++this->revision;
+	}
+
+	//--------------------------------------------------------------
+	const std::vector<glm::vec2> & WarpBase::getScreenControlPoints() const
+	{
+		auto currentRevision = this->getRevision();
+		if (this->screenPointRevision != currentRevision)
+		{
+			// Fetch all points at once, so derived warps convert them in a single batch.
+			this->screenPoints.resize(this->getNumControlPoints());
+			this->getControlPoints(this->screenPoints.data(), this->screenPoints.size());
+			for (auto & pt : this->screenPoints)
+			{
+				pt *= this->windowSize;
+			}
+			this->screenPointRevision = currentRevision;
+		}
+
+		return this->screenPoints;
+	}
+
+	//--------------------------------------------------------------
+	float WarpBase::getScreenBoundsMargin(const std::vector<glm::vec2> & screenPoints) const
+	{
+		return 0.0f;
+	}
+
 	//--------------------------------------------------------------
 	void WarpBase::queueControlPoint(const glm::vec2 & pos, bool selected, bool attached)
 	{
@@ -498,76 +705,10 @@ namespace ofxWarp
 	//--------------------------------------------------------------
 	void WarpBase::queueControlPoint(const glm::vec2 & pos, const ofFloatColor & color, float scale)
 	{
-		if (this->controlData.size() < MAX_NUM_CONTROL_POINTS)
-		{
-			this->controlData.emplace_back(ControlData(pos, color, scale));
-		}
+		// Points of all warps are drawn together once the app is done drawing.
+		ControlPointRenderer::getShared().queue(pos, color, scale);
 	}
 
-	//--------------------------------------------------------------
-	void WarpBase::setupControlPoints()
-	{
-		if (this->controlMesh.getVertices().empty())
-		{
-			// Set up the vbo mesh.
-			ofPolyline unitCircle;
-			unitCircle.arc(glm::vec3(0.0f), 1.0f, 1.0f, 0.0f, 360.0f, 18);
-			const auto & circlePoints = unitCircle.getVertices();
-			static const auto radius = 15.0f;
-			static const auto halfVec = glm::vec2(0.5f);
-			this->controlMesh.clear();
-			this->controlMesh.setMode(OF_PRIMITIVE_TRIANGLE_FAN);
-			this->controlMesh.setUsage(GL_STATIC_DRAW);
-			this->controlMesh.addVertex(glm::vec3(0.0f));
-			this->controlMesh.addTexCoord(halfVec);
-			for (auto & pt : circlePoints)
-			{
-				this->controlMesh.addVertex(pt * radius);
-                this->controlMesh.addTexCoord(glm::vec2(pt) * 0.5f + halfVec);
-			}
-
-			// Set up per-instance data to the vbo.
-			std::vector<ControlData> instanceData;
-			instanceData.resize(MAX_NUM_CONTROL_POINTS);
-
-			this->controlMesh.getVbo().setAttributeData(INSTANCE_POS_SCALE_ATTRIBUTE, (float *)&instanceData[0].pos, 4, instanceData.size(), GL_STREAM_DRAW, sizeof(ControlData));
-			this->controlMesh.getVbo().setAttributeDivisor(INSTANCE_POS_SCALE_ATTRIBUTE, 1);
-			this->controlMesh.getVbo().setAttributeData(INSTANCE_COLOR_ATTRIBUTE, (float *)&instanceData[0].color, 4, instanceData.size(), GL_STREAM_DRAW, sizeof(ControlData));
-			this->controlMesh.getVbo().setAttributeDivisor(INSTANCE_COLOR_ATTRIBUTE, 1);
-		}
-
-		if (!this->controlShader.isLoaded())
-		{
-			// Load the shader.
-			this->controlShader.setupShaderFromFile(GL_VERTEX_SHADER, WarpBase::shaderPath / "ControlPoint.vert");
-			this->controlShader.setupShaderFromFile(GL_FRAGMENT_SHADER, WarpBase::shaderPath / "ControlPoint.frag");
-			this->controlShader.bindAttribute(INSTANCE_POS_SCALE_ATTRIBUTE, "iPositionScale");
-			this->controlShader.bindAttribute(INSTANCE_COLOR_ATTRIBUTE, "iColor");
-			this->controlShader.bindDefaults();
-			this->controlShader.linkProgram();
-		}
-	}
-
-	//--------------------------------------------------------------
-	void WarpBase::drawControlPoints()
-	{
-		this->setupControlPoints();
-
-		if (!this->controlData.empty())
-		{
-			this->controlMesh.getVbo().updateAttributeData(INSTANCE_POS_SCALE_ATTRIBUTE, (float *)&this->controlData[0].pos, this->controlData.size());
-			this->controlMesh.getVbo().updateAttributeData(INSTANCE_COLOR_ATTRIBUTE, (float *)&this->controlData[0].color, this->controlData.size());
-		
-			this->controlShader.begin();
-			{
-				this->controlMesh.drawInstanced(OF_MESH_FILL, this->controlData.size());
-			}
-			this->controlShader.end();
-		}
-
-		this->controlData.clear();
-	}
-	
 	//--------------------------------------------------------------
 	bool WarpBase::handleCursorDown(const glm::vec2 & pos)
 	{
@@ -589,7 +730,7 @@ namespace ofxWarp
 		glm::vec2 screenPoint = pos - this->selectedOffset;
 		this->setControlPoint(this->selectedIndex, screenPoint / this->windowSize);
 
-		this->dirty = true;
+		this->markDirty();
 
 		return true;
 	}
@@ -598,8 +739,14 @@ namespace ofxWarp
 	bool WarpBase::handleWindowResize(int width, int height)
 	{
 		this->windowSize = glm::vec2(width, height);
-		this->dirty = true;
+		this->markDirty();
 
 		return true;
 	}
+
+	//--------------------------------------------------------------
+	glm::vec2 WarpBase::getWindowSize() const
+	{
+		return this->windowSize;
+	}
 }
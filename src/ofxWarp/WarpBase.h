@@ -9,6 +9,15 @@
 #include "ofVboMesh.h"
 #include "ofVectorMath.h"
 
+#include <memory>
+
+#include "TripleBuffer.h"
+#include "WarpData.h"
+#include "Geometry/EdgeBlend.h"
+#include "Geometry/PointGrid.h"
+#include "Geometry/TriangleGrid.h"
+#include "Geometry/WarpMesh.h"
+
 namespace ofxWarp
 {
 	class WarpBase
@@ -19,7 +28,11 @@ namespace ofxWarp
 			TYPE_UNKNOWN,
 			TYPE_BILINEAR,
 			TYPE_PERSPECTIVE,
-			TYPE_PERSPECTIVE_BILINEAR
+			TYPE_PERSPECTIVE_BILINEAR,
+			TYPE_CHAIN,
+			TYPE_LENS,
+			TYPE_DOME,
+			TYPE_MAP
 		} Type;
 
 		WarpBase(Type type = TYPE_UNKNOWN);
@@ -28,9 +41,25 @@ namespace ofxWarp
 		//! returns the type of the warp
 		Type getType() const;
 
+		//! write the warp settings to a json object
 		virtual void serialize(nlohmann::json & json);
+		//! read the warp settings from a json object
 		virtual void deserialize(const nlohmann::json & json);
 
+		//! copy the warp settings to a plain data record
+		virtual void serialize(WarpData & data) const;
+		//! copy the warp settings from a plain data record, records whose control points don't match their grid are ignored
+		virtual void deserialize(const WarpData & data);
+
+		//! copy the parameters that can be driven from another thread
+		void getParameters(WarpParameters & parameters) const;
+		//! publish a complete set of parameters from any thread, it is applied by applyParameterUpdates()
+		//! this never blocks, but only one thread may publish to a warp at a time
+		void publishParameters(const WarpParameters & parameters);
+		//! apply the latest published parameters, call this from the render thread before drawing
+		//! returns false if nothing was published since the last call
+		bool applyParameterUpdates();
+
 		virtual void setEditing(bool editing);
 		void toggleEditing();
 		bool isEditing() const;
@@ -59,6 +88,12 @@ namespace ofxWarp
 		//! return the brightness value of the texture (values between 0 and 1)
 		float getBrightness() const;
 
+		//! set whether the content drawn on the warp is fully opaque and fills the whole warp
+		//! opaque warps without edge blending hide the warps drawn before them, which lets Controller::draw() skip those
+		void setOpaque(bool opaque);
+		//! return whether the content drawn on the warp is fully opaque
+		bool isOpaque() const;
+
 		//! set the luminance value for all color channels, used for edge blending (0.5 = linear)
 		void setLuminance(float luminance);
 		//! set the luminance value for the red, green and blue channels, used for edge blending (0.5 = linear)
@@ -89,6 +124,9 @@ namespace ofxWarp
 		//! return the edge blending area for the left, top, right and bottom edges (values between 0 and 1)
 		glm::vec4 getEdges() const;
 
+		//! return all the edge blending parameters, for evaluating the blend on the CPU
+		EdgeBlend getEdgeBlend() const;
+
 		//! reset control points to undistorted image
 		virtual void reset(const glm::vec2 & scale = glm::vec2(1.0f), const glm::vec2 & offset = glm::vec2(0.0f)) = 0;
 		//! setup the warp before drawing its contents
@@ -106,6 +144,23 @@ namespace ofxWarp
 		//! adjust both the source and destination rectangles so that they are clipped against the warp's content
 		bool clip(ofRectangle & srcBounds, ofRectangle & dstBounds) const;
 
+		//! return the area the warp draws to in pixels, cached until the warp changes
+		ofRectangle getScreenBounds() const;
+		//! return whether the warp's output fully covers the specified area in pixels
+		//! this is conservative, warps that can't easily tell return false
+		virtual bool covers(const ofRectangle & screenBounds) const;
+
+		//! fill the triangles the warp draws, with positions in pixels and normalized content coordinates
+		//! the mesh is evaluated from the current settings, return false if the warp isn't drawn as a mesh
+		virtual bool getMesh(WarpMesh & mesh) const;
+
+		//! find the normalized content coordinates drawn at a point in window pixels, as the warp is rendered
+		//! return false if the warp doesn't draw at the point, call this from the thread that edits and draws the warp
+		bool getContentCoord(const glm::vec2 & screenPoint, glm::vec2 & contentPoint) const;
+		//! find the content coordinates of many points at once, points the warp doesn't draw at get negative coordinates
+		//! large batches are spread over the thread pool, return the number of points found, same threading as getContentCoord()
+		size_t getContentCoords(const glm::vec2 * screenPoints, size_t numPoints, glm::vec2 * contentPoints) const;
+
 		//! return the coordinates of the specified control point
 		virtual glm::vec2 getControlPoint(size_t index) const;
 		//! set the coordinates of the specified control point
@@ -114,6 +169,14 @@ namespace ofxWarp
 		virtual void moveControlPoint(size_t index, const glm::vec2 & shift);
 		//! get the number of control points
 		virtual size_t getNumControlPoints() const;
+		//! copy the coordinates of the first numPoints control points
+		virtual void getControlPoints(glm::vec2 * points, size_t numPoints) const;
+		//! set the coordinates of the first numPoints control points, the warp is only updated once for the whole batch
+		virtual void setControlPoints(const glm::vec2 * points, size_t numPoints);
+		//! set the coordinates of all control points, the vector has to hold one point per control
+		void setControlPoints(const std::vector<glm::vec2> & points);
+		//! apply an affine transform to the specified control points, in normalized screen coordinates
+		virtual void transformControlPoints(const size_t * indices, size_t numIndices, const glm::mat3 & transform);
 		//! get the index of the currently selected control point
 		virtual size_t getSelectedControlPoint() const;
 		//! select one of the control points
@@ -123,6 +186,11 @@ namespace ofxWarp
 		//! return the index of the closest control point, as well as the distance in pixels
 		virtual size_t findClosestControlPoint(const glm::vec2 & pos, float * distance) const;
 
+		//! return a counter that changes whenever the control points, their position on screen or what the warp draws
+		//! through them change, but not the brightness and blend parameters
+		//! derived data like the picking grid, and the settings saved by Controller::saveSettingsAsync(), are cached against it
+		virtual uint64_t getRevision() const;
+
 		//! return the number of control points columns
 		size_t getNumControlsX() const;
 		//! return the number of control points rows
@@ -138,30 +206,52 @@ namespace ofxWarp
 		virtual bool handleCursorDrag(const glm::vec2 & pos);
 
 		virtual bool handleWindowResize(int width, int height);
+		//! return the size of the window the warp is drawn in, which the control points are scaled by
+		glm::vec2 getWindowSize() const;
 
 		static void setShaderPath(const std::filesystem::path shaderPath);
+		static const std::filesystem::path & getShaderPath();
 
 	protected:
 		//! draw a specific area of a warped texture to a specific region
 		virtual void drawTexture(const ofTexture & texture, const ofRectangle & srcBounds, const ofRectangle & dstBounds) = 0;
 		//! draw the warp's controls interface
 		virtual void drawControls() = 0;
+
+		//! load the shader if it isn't loaded yet, call this before drawing with it
+		//! shaders are loaded on first use rather than on construction, so that warps can be created, edited and
+		//! rendered with SoftwareRenderer without a GL context
+		virtual void setupShader() = 0;
 		
+		//! return whether the warp supports a control grid of the specified size
+		virtual bool isValidGrid(size_t numControlsX, size_t numControlsY) const;
+
+		//! flag the warp for a rebuild and invalidate everything cached against the revision
+		void markDirty();
+		//! return the control points in pixels, they are only recalculated when the revision changes
+		const std::vector<glm::vec2> & getScreenControlPoints() const;
+		//! fill the mesh that screen points are located in, the mesh the warp draws by default
+		virtual bool getLocatorMesh(WarpMesh & mesh) const;
+		//! convert coordinates interpolated on the locator mesh to content coordinates, return false if there is no content
+		virtual bool resolveContentCoord(glm::vec2 & coord) const;
+		//! return the grid over the locator mesh, it is only rebuilt when the revision changes
+		//! building it evaluates the warp's mesh, so only call this from the thread that edits and draws the warp
+		std::shared_ptr<const TriangleGrid> getTriangleGrid() const;
+
+		//! return how far the drawn mesh may extend beyond the bounds of the screen control points, in pixels
+		virtual float getScreenBoundsMargin(const std::vector<glm::vec2> & screenPoints) const;
+
 		//! draw a control point in the preset color
 		void queueControlPoint(const glm::vec2 & pos, bool selected = false, bool attached = false);
 		//! draw a control point in the specified color
 		void queueControlPoint(const glm::vec2 & pos, const ofFloatColor & color, float scale = 1.0f);
 
-		//! setup the control points instanced vbo
-		void setupControlPoints();
-		//! draw the control points
-		void drawControlPoints();
-
 	protected:
 		Type type;
 
 		bool editing;
 		bool dirty;
+		uint64_t revision;
 
 		float width;
 		float height;
@@ -169,6 +259,7 @@ namespace ofxWarp
 		glm::vec2 windowSize;
 
 		float brightness;
+		bool opaque;
 
 		size_t numControlsX;
 		size_t numControlsY;
@@ -183,36 +274,26 @@ namespace ofxWarp
 		float exponent;
 		glm::vec4 edges;
 
-		static const int MAX_NUM_CONTROL_POINTS = 1024;
+		//! Caches rebuilt in const methods. They are used by the overlay, picking, content lookups and Controller::draw(),
+		//! and must only be touched from the thread that edits and draws the warp.
+
+		//! control points in pixels, shared by the overlay and picking
+		mutable std::vector<glm::vec2> screenPoints;
+		mutable uint64_t screenPointRevision;
+		//! screen points bucketed for picking
+		mutable PointGrid pointGrid;
+		mutable uint64_t pointGridRevision;
+		//! bounds of the drawn output in pixels
+		mutable ofRectangle screenBounds;
+		mutable uint64_t screenBoundsRevision;
+		//! triangles of the locator mesh bucketed for inverse mapping, shared with the workers of getContentCoords(),
+		//! which only read the grid handed to them and never rebuild it
+		mutable std::shared_ptr<const TriangleGrid> triangleGrid;
+		mutable uint64_t triangleGridRevision;
 
 		static std::filesystem::path shaderPath;
 
-	private:
-		typedef enum
-		{
-			INSTANCE_POS_SCALE_ATTRIBUTE = 5,
-			INSTANCE_COLOR_ATTRIBUTE = 6
-		} Attribute;
-
-		typedef struct ControlData
-		{
-			glm::vec2 pos;
-			float scale;
-			float dummy;
-			ofFloatColor color;
-
-			ControlData() 
-			{}
-
-			ControlData(const glm::vec2 & pos, const ofFloatColor & color, float scale)
-				: pos(pos)
-				, color(color)
-				, scale(scale)
-			{}
-		} ControlData;
-
-		std::vector<ControlData> controlData;
-		ofVboMesh controlMesh;
-		ofShader controlShader;
+		//! parameters published from other threads
+		TripleBuffer<WarpParameters> parameterChannel;
 	};
 }
\ No newline at end of file
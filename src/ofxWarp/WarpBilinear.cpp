@@ -1,7 +1,11 @@
 #include "WarpBilinear.h"
 
 #include "ofGraphics.h"
-#include "ofPolyline.h"
+
+#include "ControlPointRenderer.h"
+#include "Geometry/Clip.h"
+#include "Geometry/GridMesh.h"
+#include "ThreadPool.h"
 
 namespace ofxWarp
 {
@@ -12,37 +16,52 @@ namespace ofxWarp
 		, linear(false)
 		, adaptive(true)
 		, corners(0.0f, 0.0f, 1.0f, 1.0f)
+		, meshCorners(0.0f, 0.0f, 1.0f, 1.0f)
+		, controlPointSpacing(2.0f * ControlPointRenderer::RADIUS)
+		, resolution(16)  // higher value is coarser mesh
 		, resolutionX(0)
 		, resolutionY(0)
-		, resolution(16)  // higher value is coarser mesh
+		, meshTransformed(false)
+		, meshTransform(1.0f)
+		, asyncMesh(false)
+		, meshBoundsRevision(0)
 	{
 		this->reset();
-
-		this->shader.load(WarpBase::shaderPath / "WarpBilinear");
 	}
 
 	//--------------------------------------------------------------
 	WarpBilinear::~WarpBilinear()
-	{}
+	{
+		// The job writes to the staging buffer, so it has to finish first.
+		if (this->meshJob.valid())
+		{
+			this->meshJob.wait();
+		}
+	}
 
 	//--------------------------------------------------------------
-	void WarpBilinear::serialize(nlohmann::json & json)
+	void WarpBilinear::serialize(WarpData & data) const
 	{
-		WarpBase::serialize(json);
+		WarpBase::serialize(data);
 
-		json["resolution"] = this->resolution;
-		json["linear"] = this->linear;
-		json["adaptive"] = this->adaptive;
+		data.hasMesh = true;
+		data.resolution = this->resolution;
+		data.linear = this->linear;
+		data.adaptive = this->adaptive;
 	}
 
 	//--------------------------------------------------------------
-	void WarpBilinear::deserialize(const nlohmann::json & json)
+	void WarpBilinear::deserialize(const WarpData & data)
 	{
-		WarpBase::deserialize(json);
+		WarpBase::deserialize(data);
 
-		this->resolution = json["resolution"];
-		this->linear = json["linear"];
-		this->adaptive = json["adaptive"];
+		if (data.hasMesh && (this->resolution != data.resolution || this->linear != data.linear || this->adaptive != data.adaptive))
+		{
+			this->resolution = data.resolution;
+			this->linear = data.linear;
+			this->adaptive = data.adaptive;
+			this->markDirty();
+		}
 	}
 
 	//--------------------------------------------------------------
@@ -63,7 +82,7 @@ namespace ofxWarp
 	void WarpBilinear::setLinear(bool linear)
 	{
 		this->linear = linear;
-		this->dirty = true;
+		this->markDirty();
 	}
 
 	//--------------------------------------------------------------
@@ -76,7 +95,7 @@ namespace ofxWarp
 	void WarpBilinear::setAdaptive(bool adaptive)
 	{
 		this->adaptive = adaptive;
-		this->dirty = true;
+		this->markDirty();
 	}
 
 	//--------------------------------------------------------------
@@ -85,13 +104,37 @@ namespace ofxWarp
 		return this->adaptive;
 	}
 
+	//--------------------------------------------------------------
+	void WarpBilinear::setAsyncMesh(bool asyncMesh)
+	{
+		this->asyncMesh = asyncMesh;
+	}
+
+	//--------------------------------------------------------------
+	bool WarpBilinear::getAsyncMesh() const
+	{
+		return this->asyncMesh;
+	}
+
+	//--------------------------------------------------------------
+	void WarpBilinear::setControlPointSpacing(float spacing)
+	{
+		this->controlPointSpacing = MAX(0.0f, spacing);
+	}
+
+	//--------------------------------------------------------------
+	float WarpBilinear::getControlPointSpacing() const
+	{
+		return this->controlPointSpacing;
+	}
+
 	//--------------------------------------------------------------
 	void WarpBilinear::increaseResolution()
 	{
 		if (this->resolution < 64)
 		{
 			this->resolution += 4;
-			this->dirty = true;
+			this->markDirty();
 		}
 	}
 
@@ -101,7 +144,7 @@ namespace ofxWarp
 		if (this->resolution > 4)
 		{
 			this->resolution -= 4;
-			this->dirty = true;
+			this->markDirty();
 		}
 	}
 
@@ -123,7 +166,7 @@ namespace ofxWarp
 			}
 		}
 
-		this->dirty = true;
+		this->markDirty();
 	}
 
 	//--------------------------------------------------------------
@@ -177,6 +220,7 @@ namespace ofxWarp
 		}
 
 		this->setupVbo();
+		this->setupShader();
 
 		auto currentColor = ofGetStyle().color;
 		ofPushStyle();
@@ -219,16 +263,140 @@ namespace ofxWarp
 	//--------------------------------------------------------------
 	void WarpBilinear::drawControls()
 	{
-		if (this->editing && this->selectedIndex < this->controlPoints.size())
+		if (!this->editing || this->selectedIndex >= this->controlPoints.size()) return;
+
+		// Screen positions are cached until the warp changes, so a still frame only touches the points it draws.
+		const auto & points = this->getScreenControlPoints();
+		auto stride = this->getControlPointStride(points);
+
+		// Cull points that can't overlap the window.
+		auto margin = 2.0f * ControlPointRenderer::RADIUS;
+		auto viewport = ofRectangle(-margin, -margin, this->windowSize.x + 2.0f * margin, this->windowSize.y + 2.0f * margin);
+
+		// Every stride-th column and row stands in for the points around it, the last ones are always kept
+		// so the outline of the grid stays intact.
+		auto numControlsX = (int)this->numControlsX;
+		auto numControlsY = (int)this->numControlsY;
+		std::vector<int> cols;
+		for (auto col = 0; col < numControlsX; col += stride.x)
+		{
+			cols.push_back(col);
+		}
+		if (cols.back() != numControlsX - 1)
+		{
+			cols.push_back(numControlsX - 1);
+		}
+		std::vector<int> rows;
+		for (auto row = 0; row < numControlsY; row += stride.y)
+		{
+			rows.push_back(row);
+		}
+		if (rows.back() != numControlsY - 1)
 		{
-			// Draw control points.
-			for (auto i = 0; i < this->controlPoints.size(); ++i)
+			rows.push_back(numControlsY - 1);
+		}
+
+		// Points around the selection and the cursor are always shown at full density.
+		// The cursor area is centered on the closest visible representative, found without the picking grid
+		// so that dragging a point doesn't rebuild it every frame.
+		static const auto maxDetailSteps = 16;
+		auto detailSize = glm::ivec2(MIN(stride.x, maxDetailSteps), MIN(stride.y, maxDetailSteps));
+		auto hasDetail = (stride.x > 1 || stride.y > 1);
+
+		auto selectedCell = glm::ivec2((int)this->selectedIndex / numControlsY, (int)this->selectedIndex % numControlsY);
+		auto cursorCell = glm::ivec2(-1);
+		if (hasDetail)
+		{
+			auto cursor = glm::vec2(ofGetMouseX(), ofGetMouseY());
+			auto maxDistance = 2.0f * this->controlPointSpacing;
+			auto closestDistance2 = maxDistance * maxDistance;
+			for (auto col : cols)
+			{
+				for (auto row : rows)
+				{
+					auto delta = points[col * numControlsY + row] - cursor;
+					auto distance2 = glm::dot(delta, delta);
+					if (distance2 < closestDistance2)
+					{
+						closestDistance2 = distance2;
+						cursorCell = glm::ivec2(col, row);
+					}
+				}
+			}
+		}
+
+		auto isDetail = [&](const glm::ivec2 & center, int col, int row)
+		{
+			return (center.x >= 0 && abs(col - center.x) <= detailSize.x && abs(row - center.y) <= detailSize.y);
+		};
+
+		// Queue the representatives outside of the detail areas.
+		for (auto col : cols)
+		{
+			for (auto row : rows)
 			{
-				this->queueControlPoint(this->getControlPoint(i) * this->windowSize, i == this->selectedIndex);
+				if (hasDetail && (isDetail(selectedCell, col, row) || isDetail(cursorCell, col, row))) continue;
+
+				auto index = (size_t)(col * numControlsY + row);
+				if (!viewport.inside(points[index])) continue;
+
+				this->queueControlPoint(points[index], index == this->selectedIndex);
 			}
+		}
 
-			this->drawControlPoints();
+		if (!hasDetail) return;
+
+		// Queue every point of the detail areas, without queueing points twice where they overlap.
+		auto queueDetail = [&](const glm::ivec2 & center, const glm::ivec2 & exclude)
+		{
+			if (center.x < 0) return;
+
+			for (auto col = MAX(0, center.x - detailSize.x); col <= MIN(numControlsX - 1, center.x + detailSize.x); ++col)
+			{
+				for (auto row = MAX(0, center.y - detailSize.y); row <= MIN(numControlsY - 1, center.y + detailSize.y); ++row)
+				{
+					if (isDetail(exclude, col, row)) continue;
+
+					auto index = (size_t)(col * numControlsY + row);
+					if (!viewport.inside(points[index])) continue;
+
+					this->queueControlPoint(points[index], index == this->selectedIndex);
+				}
+			}
+		};
+		queueDetail(selectedCell, glm::ivec2(-1));
+		queueDetail(cursorCell, selectedCell);
+	}
+
+	//--------------------------------------------------------------
+	glm::ivec2 WarpBilinear::getControlPointStride(const std::vector<glm::vec2> & screenPoints) const
+	{
+		if (this->controlPointSpacing <= 0.0f) return glm::ivec2(1);
+
+		// Estimate the average spacing along columns and rows from the first, middle and last row and column.
+		auto spacing = glm::vec2(0.0f);
+		for (auto row : { (size_t)0, this->numControlsY / 2, this->numControlsY - 1 })
+		{
+			for (size_t col = 1; col < this->numControlsX; ++col)
+			{
+				spacing.x += glm::distance(screenPoints[col * this->numControlsY + row], screenPoints[(col - 1) * this->numControlsY + row]);
+			}
 		}
+		for (auto col : { (size_t)0, this->numControlsX / 2, this->numControlsX - 1 })
+		{
+			for (size_t row = 1; row < this->numControlsY; ++row)
+			{
+				spacing.y += glm::distance(screenPoints[col * this->numControlsY + row], screenPoints[col * this->numControlsY + row - 1]);
+			}
+		}
+		spacing /= glm::vec2(3.0f * (this->numControlsX - 1), 3.0f * (this->numControlsY - 1));
+
+		// Step over enough points to reach the minimum spacing, keeping collapsed grids bounded too.
+		auto stride = glm::ivec2(1);
+		stride.x = (spacing.x > 0.0f) ? (int)ceilf(this->controlPointSpacing / spacing.x) : (int)this->numControlsX;
+		stride.y = (spacing.y > 0.0f) ? (int)ceilf(this->controlPointSpacing / spacing.y) : (int)this->numControlsY;
+
+		return glm::clamp(stride, glm::ivec2(1), glm::ivec2(MAX(1, (int)this->numControlsX - 1), MAX(1, (int)this->numControlsY - 1)));
 	}
 
 	//--------------------------------------------------------------
@@ -242,110 +410,210 @@ namespace ofxWarp
 		}
 	}
 
+	//--------------------------------------------------------------
+	void WarpBilinear::setupShader()
+	{
+		if (!this->shader.isLoaded())
+		{
+			this->shader.load(WarpBase::shaderPath / "WarpBilinear");
+		}
+	}
+
 	//--------------------------------------------------------------
 	void WarpBilinear::setupVbo()
 	{
+		// The first mesh is always built right away, there is nothing to draw in the meantime.
+		if (this->asyncMesh && this->vbo.getIsAllocated())
+		{
+			this->setupVboAsync();
+			return;
+		}
+
 		if (this->dirty)
 		{
-			if (this->adaptive)
-			{
-				// Determine a suitable mesh resolution based on the dimensions of the window
-				// and the size of the mesh in pixels.
-				auto meshBounds = this->getMeshBounds();
-				this->setupMesh(meshBounds.getWidth() / this->resolution, meshBounds.getHeight() / this->resolution);
-			}
-			else
-			{
-				// Use a fixed mesh resolution.
-				this->setupMesh(this->width / this->resolution, this->height / this->resolution);
-			}
+			std::vector<float> samplesU;
+			std::vector<float> samplesV;
+			this->getMeshSamples(samplesU, samplesV);
+			this->setupMesh(samplesU, samplesV);
 			this->updateMesh();
 		}
 	}
 
 	//--------------------------------------------------------------
-	void WarpBilinear::setupMesh(int resolutionX, int resolutionY)
+	void WarpBilinear::setupVboAsync()
 	{
-		// Convert from number of quads to number of vertices.
-		++resolutionX;
-		++resolutionY;
+		// Upload the positions of a finished job, until then the previous mesh is drawn.
+		if (this->meshJob.valid() && this->meshJob.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+		{
+			this->meshJob.get();
+
+			this->setupMesh(this->stagingSamplesU, this->stagingSamplesV);
+			this->vbo.updateVertexData(&this->stagingPositions[0].x, this->stagingPositions.size());
+		}
 
-		// Find a value for resolutionX and resolutionY that can be evenly divided by numControlsX and numControlsY.
-		if (this->numControlsX < resolutionX) 
+		// Start a new job if the warp changed, edits made while a job runs are picked up by the next one.
+		if (this->dirty && !this->meshJob.valid())
 		{
-			int dx = (resolutionX - 1) % (this->numControlsX - 1);
-			if (dx >= (this->numControlsX / 2))
+			this->dirty = false;
+
+			// The job works on a copy, so the control points can keep changing while it runs.
+			auto controlPoints = this->controlPoints;
+			auto numControlsX = this->numControlsX;
+			auto numControlsY = this->numControlsY;
+			auto linear = this->linear;
+			auto windowSize = this->windowSize;
+			auto adaptive = this->usesAdaptiveMesh();
+			auto maxError = this->getMeshTolerance();
+			auto maxSubdivisions = this->getMaxMeshSubdivisions();
+			auto evaluator = this->getMeshEvaluator();
+			auto positions = &this->stagingPositions;
+			auto samplesU = &this->stagingSamplesU;
+			auto samplesV = &this->stagingSamplesV;
+
+			// Even samples are cheap, but finding adaptive ones means looking at every patch, so that's done by the job.
+			if (!adaptive)
 			{
-				dx -= (this->numControlsX - 1);
+				this->getMeshSamples(*samplesU, *samplesV);
 			}
-			resolutionX -= dx;
+
+			this->meshJob = ThreadPool::getShared().submit([=]
+			{
+				if (adaptive)
+				{
+					ControlGrid grid(controlPoints, numControlsX, numControlsY);
+					grid.getAdaptiveSamples(linear, windowSize, maxError, maxSubdivisions, *samplesU, *samplesV);
+				}
+
+				positions->resize(samplesU->size() * samplesV->size());
+				evaluator(*samplesU, *samplesV, positions->data());
+			});
 		}
-		else 
+	}
+
+	//--------------------------------------------------------------
+	void WarpBilinear::getMeshSamples(std::vector<float> & samplesU, std::vector<float> & samplesV) const
+	{
+		if (this->usesAdaptiveMesh())
 		{
-			resolutionX = this->numControlsX;
+			// Refine the mesh where the curved surface is furthest from its linear approximation.
+			this->getControlGrid().getAdaptiveSamples(this->linear, this->windowSize, this->getMeshTolerance(), this->getMaxMeshSubdivisions(), samplesU, samplesV);
+			return;
 		}
 
-		if (this->numControlsY < resolutionY) 
+		// Use a fixed mesh resolution.
+		auto resolution = GridMesh::getResolution(this->numControlsX, this->numControlsY, this->width / this->resolution, this->height / this->resolution);
+		GridMesh::getSamples(this->numControlsX, resolution.x, samplesU);
+		GridMesh::getSamples(this->numControlsY, resolution.y, samplesV);
+	}
+
+	//--------------------------------------------------------------
+	bool WarpBilinear::usesAdaptiveMesh() const
+	{
+		return this->adaptive;
+	}
+
+	//--------------------------------------------------------------
+	WarpBilinear::MeshEvaluator WarpBilinear::getMeshEvaluator() const
+	{
+		return this->getGridEvaluator(this->meshTransformed, this->meshTransform);
+	}
+
+	//--------------------------------------------------------------
+	WarpBilinear::MeshEvaluator WarpBilinear::getGridEvaluator(bool transformed, const glm::mat4 & transform) const
+	{
+		auto controlPoints = this->controlPoints;
+		auto numControlsX = this->numControlsX;
+		auto numControlsY = this->numControlsY;
+		auto linear = this->linear;
+		auto windowSize = this->windowSize;
+
+		return [=](const std::vector<float> & samplesU, const std::vector<float> & samplesV, glm::vec4 * positions)
 		{
-			int dy = (resolutionY - 1) % (this->numControlsY - 1);
-			if (dy >= (this->numControlsY / 2))
+			ControlGrid grid(controlPoints, numControlsX, numControlsY);
+			grid.evaluate(samplesU, samplesV, linear, windowSize, positions);
+			if (transformed)
 			{
-				dy -= (this->numControlsY - 1);
+				WarpBilinear::transformMesh(transform, positions, samplesU.size() * samplesV.size());
 			}
-			resolutionY -= dy;
-		}
-		else 
-		{
-			resolutionY = this->numControlsY;
-		}
+		};
+	}
 
-		this->resolutionX = resolutionX;
-		this->resolutionY = resolutionY;
+	//--------------------------------------------------------------
+	bool WarpBilinear::getMesh(WarpMesh & mesh) const
+	{
+		this->buildMesh(this->getMeshEvaluator(), mesh);
+		return true;
+	}
 
-		int numVertices = (resolutionX * resolutionY);
-		int numTriangles = 2 * (resolutionX - 1) * (resolutionY - 1);
-		int numIndices = numTriangles * 3;
+	//--------------------------------------------------------------
+	void WarpBilinear::buildMesh(const MeshEvaluator & evaluator, WarpMesh & mesh) const
+	{
+		std::vector<float> samplesU;
+		std::vector<float> samplesV;
+		this->getMeshSamples(samplesU, samplesV);
 
-		// Build the static data.
-		int i = 0;
-		int j = 0;
+		mesh.positions.resize(samplesU.size() * samplesV.size());
+		evaluator(samplesU, samplesV, mesh.positions.data());
 
-		auto indices = std::vector<ofIndexType>(numIndices);
-		auto texCoords = std::vector<glm::vec2>(numVertices);
+		GridMesh::getTexCoords(samplesU, samplesV, glm::vec4(0.0f, 0.0f, 1.0f, 1.0f), mesh.texCoords);
+		GridMesh::getIndices(samplesU.size(), samplesV.size(), mesh.indices);
+	}
 
-		for (int x = 0; x < resolutionX; ++x) 
+	//--------------------------------------------------------------
+	float WarpBilinear::getMeshTolerance() const
+	{
+		return (this->resolution / 32.0f);
+	}
+
+	//--------------------------------------------------------------
+	int WarpBilinear::getMaxMeshSubdivisions() const
+	{
+		// There is no point in splitting patches into steps much smaller than a pixel, which also keeps
+		// dense grids with jittered points from blowing up the vertex count.
+		auto meshBounds = this->getMeshBounds();
+		auto patchSize = MAX(meshBounds.getWidth() / (this->numControlsX - 1), meshBounds.getHeight() / (this->numControlsY - 1));
+		return ofClamp(ceilf(patchSize / 2.0f), 1, 64);
+	}
+
+	//--------------------------------------------------------------
+	void WarpBilinear::setupMesh(const std::vector<float> & samplesU, const std::vector<float> & samplesV)
+	{
+		// Keep the existing buffers if the layout didn't change, only the positions need to be updated.
+		if (this->vbo.getIsAllocated() && samplesU == this->meshSamplesU && samplesV == this->meshSamplesV && this->corners == this->meshCorners)
 		{
-			for (int y = 0; y < resolutionY; ++y) 
-			{
-				// Index.
-				if (((x + 1) < resolutionX) && ((y + 1) < resolutionY)) 
-				{
-					indices[i++] = (x + 0) * resolutionY + (y + 0);
-					indices[i++] = (x + 1) * resolutionY + (y + 0);
-					indices[i++] = (x + 1) * resolutionY + (y + 1);
+			return;
+		}
 
-					indices[i++] = (x + 0) * resolutionY + (y + 0);
-					indices[i++] = (x + 1) * resolutionY + (y + 1);
-					indices[i++] = (x + 0) * resolutionY + (y + 1);
-				}
+		auto sameTopology = (this->vbo.getIsAllocated() && samplesU.size() == this->meshSamplesU.size() && samplesV.size() == this->meshSamplesV.size());
 
-				// Tex Coord.
-				float tx = ofLerp(this->corners.x, this->corners.z, x / (float)(this->resolutionX - 1));
-				float ty = ofLerp(this->corners.y, this->corners.w, y / (float)(this->resolutionY - 1));
-				texCoords[j++] = glm::vec2(tx, ty);
-			}
+		this->meshSamplesU = samplesU;
+		this->meshSamplesV = samplesV;
+		this->resolutionX = samplesU.size();
+		this->resolutionY = samplesV.size();
+		this->meshCorners = this->corners;
+
+		std::vector<glm::vec2> texCoords;
+		GridMesh::getTexCoords(this->meshSamplesU, this->meshSamplesV, this->corners, texCoords);
+
+		// Adaptive meshes move their samples around as the warp is edited, but mostly keep the same vertex count.
+		if (sameTopology)
+		{
+			this->vbo.updateTexCoordData(texCoords.data(), texCoords.size());
+			return;
 		}
 
-		// Build placeholder data.
-		std::vector<glm::vec3> positions(this->resolutionX * this->resolutionY);
+		// Build the static data.
+		std::vector<ofIndexType> indices;
+		GridMesh::getIndices(this->resolutionX, this->resolutionY, indices);
+
+		// Build placeholder data, positions are homogeneous in case the mesh is projected.
+		std::vector<glm::vec4> positions(this->resolutionX * this->resolutionY);
 
 		// Build mesh.
 		this->vbo.clear();
-		this->vbo.setVertexData(positions.data(), positions.size(), GL_STATIC_DRAW);
+		this->vbo.setVertexData(&positions[0].x, 4, positions.size(), GL_STATIC_DRAW, sizeof(glm::vec4));
 		this->vbo.setTexCoordData(texCoords.data(), texCoords.size(), GL_STATIC_DRAW);
 		this->vbo.setIndexData(indices.data(), indices.size(), GL_STATIC_DRAW);
-
-		this->dirty = true;
 	}
 
 	// Mapped buffer seems to be a *tiny* bit faster.
@@ -355,112 +623,65 @@ namespace ofxWarp
 	void WarpBilinear::updateMesh()
 	{
 		if (!this->vbo.getIsAllocated() || !this->dirty) return;
-		
-		glm::vec2 pt;
-		float u, v;
-		int col, row;
-
-		std::vector<glm::vec2> cols, rows;
 
 #if USE_MAPPED_BUFFER
 		auto vertexBuffer = this->vbo.getVertexBuffer();
-		auto mappedMesh = (glm::vec3 *)vertexBuffer.map(GL_WRITE_ONLY);
+		auto mappedMesh = (glm::vec4 *)vertexBuffer.map(GL_WRITE_ONLY);
+		
+		this->evaluateMesh(mappedMesh);
+		
+		vertexBuffer.unmap();
 #else
-		std::vector<glm::vec3> positions(this->resolutionX * this->resolutionY);
-		auto index = 0;
+		std::vector<glm::vec4> positions(this->resolutionX * this->resolutionY);
+		
+		this->evaluateMesh(positions.data());
+		
+		this->vbo.updateVertexData(&positions[0].x, positions.size());
 #endif
 
-		for (auto x = 0; x < this->resolutionX; ++x) 
-		{
-			for (auto y = 0; y < this->resolutionY; ++y) 
-			{
-				// Transform coordinates to [0..numControls]
-				u = x * (this->numControlsX - 1) / (float)(this->resolutionX - 1);
-				v = y * (this->numControlsY - 1) / (float)(this->resolutionY - 1);
-
-				// Determine col and row.
-				col = (int)u;
-				row = (int)v;
+		this->dirty = false;
+	}
 
-				// Normalize coordinates to [0..1]
-				u -= col;
-				v -= row;
+	//--------------------------------------------------------------
+	void WarpBilinear::evaluateMesh(glm::vec4 * positions) const
+	{
+		this->getMeshEvaluator()(this->meshSamplesU, this->meshSamplesV, positions);
+	}
 
-				if (this->linear) 
-				{
-					// Perform linear interpolation.
-					auto p1 = (1.0f - u) * this->getPoint(col, row) + u * this->getPoint(col + 1, row);
-					auto p2 = (1.0f - u) * this->getPoint(col, row + 1) + u * this->getPoint(col + 1, row + 1);
-					pt = ((1.0f - v) * p1 + v * p2) * this->windowSize;
-				}
-				else {
-					// Perform bicubic interpolation.
-					rows.clear();
-					for (int i = -1; i < 3; ++i) 
-					{
-						cols.clear();
-						for (int j = -1; j < 3; ++j) 
-						{
-							cols.push_back(this->getPoint(col + i, row + j));
-						}
-						rows.push_back(this->cubicInterpolate(cols, v));
-					}
-					pt = this->cubicInterpolate(rows, u) * this->windowSize;
-				}
+	//--------------------------------------------------------------
+	void WarpBilinear::setMeshTransform(const glm::mat4 & transform)
+	{
+		if (this->meshTransformed && this->meshTransform == transform) return;
 
-#if USE_MAPPED_BUFFER
-				*mappedMesh++ = glm::vec3(pt.x, pt.y, 0.0f);
-#else
-				positions[index++] = glm::vec3(pt.x, pt.y, 0.0f);
-#endif
-			}
-		}
+		// Only the mesh needs to be rebuilt, the control points didn't change.
+		this->meshTransformed = true;
+		this->meshTransform = transform;
+		this->dirty = true;
+	}
 
-#if USE_MAPPED_BUFFER
-		vertexBuffer.unmap();
-#else
-		this->vbo.updateVertexData(positions.data(), positions.size());
-#endif
+	//--------------------------------------------------------------
+	void WarpBilinear::clearMeshTransform()
+	{
+		if (!this->meshTransformed) return;
 
-		this->dirty = false;
+		this->meshTransformed = false;
+		this->dirty = true;
 	}
 
 	//--------------------------------------------------------------
-	glm::vec2 WarpBilinear::getPoint(int col, int row) const
+	void WarpBilinear::transformMesh(const glm::mat4 & transform, glm::vec4 * positions, size_t numPositions)
 	{
-		auto maxCol = this->numControlsX - 1;
-		auto maxRow = this->numControlsY - 1;
-
-		// Here's the magic: extrapolate points beyond the edges.
-		if (col < 0)
-		{
-			return (2.0f * getPoint(0, row) - getPoint(0 - col, row));
-		}
-		if (row < 0)
-		{
-			return (2.0f * getPoint(col, 0) - getPoint(col, 0 - row));
-		}
-		if (col > maxCol)
-		{
-			return (2.0f * getPoint(maxCol, row) - getPoint(2 * maxCol - col, row));
-		}
-		if (row > maxRow)
+		for (size_t i = 0; i < numPositions; ++i)
 		{
-			return (2.0f * getPoint(col, maxRow) - getPoint(col, 2 * maxRow - row));
+			// Don't divide by w, the rasterizer does that after interpolating, which keeps the texture perspective correct.
+			positions[i] = transform * positions[i];
 		}
-
-		// Points on the edges or within the mesh can simply be looked up.
-		auto idx = (col * this->numControlsY) + row;
-		return this->controlPoints[idx];
 	}
 
 	//--------------------------------------------------------------
-	// From http://www.paulinternet.nl/?page=bicubic : fast catmull-rom calculation
-	glm::vec2 WarpBilinear::cubicInterpolate(const std::vector<glm::vec2> & knots, float t) const
+	ControlGrid WarpBilinear::getControlGrid() const
 	{
-		assert(knots.size() >= 4);
-
-		return (knots[1] + 0.5f * t * (knots[2] - knots[0] + t * (2.0f * knots[0] - 5.0f * knots[1] + 4.0f * knots[2] - knots[3] + t * (3.0f * (knots[1] - knots[2]) + knots[3] - knots[0]))));
+		return ControlGrid(this->controlPoints, this->numControlsX, this->numControlsY);
 	}
 
 	//--------------------------------------------------------------
@@ -469,83 +690,14 @@ namespace ofxWarp
 		// There should be a minimum of 2 control points.
 		n = MAX(2, n);
 
-		// Prevent overflow.
-		if ((n * this->numControlsY) > MAX_NUM_CONTROL_POINTS) return;
-
-		// Create a list of new points.
-		std::vector<glm::vec2> tempPoints(n * this->numControlsY);
-
-		// Perform spline fitting.
-		for (auto row = 0; row < this->numControlsY; ++row) {
-			if (this->linear)
-			{
-				// Construct piece-wise linear spline.
-				ofPolyline polyline;
-				for (auto col = 0; col < this->numControlsX; ++col)
-				{
-					polyline.lineTo(glm::vec3(this->getPoint(col, row), 0.0f));
-				}
-
-				// Calculate position of new control points.
-				auto step = 1.0f / (n - 1);
-				for (auto col = 0; col < n; ++col)
-				{
-					auto idx = (col * this->numControlsY) + row;
-                    tempPoints[idx] = glm::vec2(polyline.getPointAtPercent(col * step));
-				}
-			}
-			else 
-			{
-				// Construct piece-wise catmull-rom spline.
-				ofPolyline polyline;
-				for (auto col = 0; col < this->numControlsX; ++col)
-				{
-					auto p0 = this->getPoint(col - 1, row);
-					auto p1 = this->getPoint(col, row);
-					auto p2 = this->getPoint(col + 1, row);
-					auto p3 = this->getPoint(col + 2, row);
-
-					// Control points according to an optimized Catmull-Rom implementation
-					auto b1 = p1 + (p2 - p0) / 6.0f;
-					auto b2 = p2 - (p3 - p1) / 6.0f;
-
-					if (col == 0)
-					{
-						polyline.lineTo(glm::vec3(p1, 0.0f));
-					}
-					
-					polyline.curveTo(glm::vec3(p1, 0.0f));
-
-					if (col < (this->numControlsX - 1)) 
-					{
-						polyline.curveTo(glm::vec3(b1, 0.0f));
-						polyline.curveTo(glm::vec3(b2, 0.0f));
-					}
-					else
-					{
-						polyline.lineTo(glm::vec3(p1, 0.0f));
-					}
-				}
-
-				// Calculate position of new control points.
-				auto step = 1.0f / (n - 1);
-				for (auto col = 0; col < n; ++col)
-				{
-					auto idx = (col * this->numControlsY) + row; 
-                    tempPoints[idx] = glm::vec2(polyline.getPointAtPercent(col * step));
-				}
-			}
-		}
-
-		// Save new control points.
-		this->controlPoints = tempPoints;
+		// Perform spline fitting and save new control points.
+		this->controlPoints = this->getControlGrid().resampleX(n, this->linear);
 		this->numControlsX = n;
+		this->markDirty();
 
 		// Find new closest control point.
 		float distance;
 		this->selectedIndex = this->findClosestControlPoint(glm::vec2(ofGetMouseX(), ofGetMouseY()), &distance);
-
-		this->dirty = true;
 	}
 
 	//--------------------------------------------------------------
@@ -554,89 +706,22 @@ namespace ofxWarp
 		// There should be a minimum of 2 control points.
 		n = MAX(2, n);
 
-		// Prevent overflow.
-		if ((this->numControlsX * n) > MAX_NUM_CONTROL_POINTS) return;
-
-		// Create a list of new points.
-		std::vector<glm::vec2> tempPoints(this->numControlsX * n);
-
-		// Perform spline fitting
-		for (auto col = 0; col < this->numControlsX; ++col) 
-		{
-			if (this->linear) 
-			{
-				// Construct piece-wise linear spline.
-				ofPolyline polyline;
-				for (auto row = 0; row < this->numControlsY; ++row)
-				{
-					polyline.lineTo(glm::vec3(this->getPoint(col, row), 0.0f));
-				}
-
-				// Calculate position of new control points.
-				float step = 1.0f / (n - 1);
-				for (auto row = 0; row < n; ++row) 
-				{
-					auto idx = (col * n) + row;
-                    tempPoints[idx] = glm::vec2(polyline.getPointAtPercent(row * step));
-				}
-			}
-			else 
-			{
-				// Construct piece-wise catmull-rom spline.
-				ofPolyline polyline;
-				for (auto row = 0; row < this->numControlsY; ++row)
-				{
-					auto p0 = this->getPoint(col, row - 1);
-					auto p1 = this->getPoint(col, row);
-					auto p2 = this->getPoint(col, row + 1);
-					auto p3 = this->getPoint(col, row + 2);
-
-					// Control points according to an optimized Catmull-Rom implementation
-					auto b1 = p1 + (p2 - p0) / 6.0f;
-					auto b2 = p2 - (p3 - p1) / 6.0f;
-
-					if (row == 0)
-					{
-						polyline.lineTo(glm::vec3(p1, 0.0f));
-					}
-
-					polyline.curveTo(glm::vec3(p1, 0.0f));
-
-					if (row < (this->numControlsY - 1)) 
-					{
-						polyline.curveTo(glm::vec3(b1, 0.0f));
-						polyline.curveTo(glm::vec3(b2, 0.0f));
-					}
-					else
-					{
-						polyline.lineTo(glm::vec3(p1, 0.0f));
-					}
-				}
-
-				// Calculate position of new control points.
-				auto step = 1.0f / (n - 1);
-				for (auto row = 0; row < n; ++row) 
-				{
-					auto idx = (col * n) + row;
-                    tempPoints[idx] = glm::vec2(polyline.getPointAtPercent(row * step));
-				}
-			}
-		}
-
-		// Save new control points.
-		this->controlPoints = tempPoints;
+		// Perform spline fitting and save new control points.
+		this->controlPoints = this->getControlGrid().resampleY(n, this->linear);
 		this->numControlsY = n;
+		this->markDirty();
 
 		// Find new closest control point.
 		float distance;
 		this->selectedIndex = this->findClosestControlPoint(glm::vec2(ofGetMouseX(), ofGetMouseY()), &distance);
-
-		this->dirty = true;
 	}
 
 	//--------------------------------------------------------------
 	ofRectangle WarpBilinear::getMeshBounds() const
 	{
+		// Only scan the control points when they changed since the last call.
+		if (this->meshBoundsRevision == this->revision) return this->meshBounds;
+
 		auto min = glm::vec2(1.0f);
 		auto max = glm::vec2(0.0f);
 
@@ -645,10 +730,13 @@ namespace ofxWarp
 			min.x = MIN(pt.x, min.x);
 			min.y = MIN(pt.y, min.y);
 			max.x = MAX(pt.x, max.x);
-			max.y = MAX(pt.y, min.y);
+			max.y = MAX(pt.y, max.y);
 		}
 
-		return ofRectangle(min * this->windowSize, max * this->windowSize);
+		this->meshBounds = ofRectangle(min * this->windowSize, max * this->windowSize);
+		this->meshBoundsRevision = this->revision;
+
+		return this->meshBounds;
 	}
 
 	//--------------------------------------------------------------
@@ -660,6 +748,46 @@ namespace ofxWarp
 		this->corners = glm::vec4(left, top, right, bottom);
 	}
 
+	//--------------------------------------------------------------
+	bool WarpBilinear::covers(const ofRectangle & screenBounds) const
+	{
+		// With more control points the edges can be curved or folded, so only the plain quad is handled.
+		if (this->numControlsX != 2 || this->numControlsY != 2) return false;
+
+		const auto & points = this->getScreenControlPoints();
+		const glm::vec2 quad[4] = { points[0], points[2], points[3], points[1] };
+
+		return quadContainsRect(quad, glm::vec4(screenBounds.x, screenBounds.y, screenBounds.width, screenBounds.height));
+	}
+
+	//--------------------------------------------------------------
+	float WarpBilinear::getScreenBoundsMargin(const std::vector<glm::vec2> & screenPoints) const
+	{
+		if (this->linear) return 0.0f;
+
+		// Catmull-Rom segments stay within a quarter of the neighbor distance of their chord in each direction.
+		auto maxDistance2 = 0.0f;
+		for (size_t col = 0; col < this->numControlsX; ++col)
+		{
+			for (size_t row = 0; row < this->numControlsY; ++row)
+			{
+				const auto & pt = screenPoints[col * this->numControlsY + row];
+				if (col > 0)
+				{
+					auto delta = pt - screenPoints[(col - 1) * this->numControlsY + row];
+					maxDistance2 = MAX(maxDistance2, glm::dot(delta, delta));
+				}
+				if (row > 0)
+				{
+					auto delta = pt - screenPoints[col * this->numControlsY + row - 1];
+					maxDistance2 = MAX(maxDistance2, glm::dot(delta, delta));
+				}
+			}
+		}
+
+		return 0.5f * sqrtf(maxDistance2);
+	}
+
 	//--------------------------------------------------------------
 	void WarpBilinear::rotateClockwise()
 	{
@@ -685,7 +813,7 @@ namespace ofxWarp
 			}
 		}
 		this->controlPoints = flippedPoints;
-		this->dirty = true;
+		this->markDirty();
 
 		// Find new closest control point.
 		float distance;
@@ -705,7 +833,7 @@ namespace ofxWarp
 			}
 		}
 		this->controlPoints = flippedPoints;
-		this->dirty = true;
+		this->markDirty();
 
 		// Find new closest control point.
 		float distance;
@@ -3,7 +3,11 @@
 #include "ofFbo.h"
 #include "ofVbo.h"
 
+#include <functional>
+#include <future>
+
 #include "WarpBase.h"
+#include "Geometry/ControlGrid.h"
 
 namespace ofxWarp
 {
@@ -14,8 +18,11 @@ namespace ofxWarp
 		WarpBilinear(const ofFbo::Settings & fboSettings = ofFbo::Settings());
 		virtual ~WarpBilinear();
 
-		virtual void serialize(nlohmann::json & json) override;
-		virtual void deserialize(const nlohmann::json & json) override;
+		using WarpBase::serialize;
+		using WarpBase::deserialize;
+
+		virtual void serialize(WarpData & data) const override;
+		virtual void deserialize(const WarpData & data) override;
 
 		virtual void setSize(float width, float height) override;
 
@@ -26,11 +33,22 @@ namespace ofxWarp
 		//! return whether the mesh is linear (or curved)
 		bool getLinear() const;
 
-		//! set whether the mesh resolution is adaptive to the window size
+		//! set whether the mesh is only refined where the warp curves, instead of being evenly spaced
 		void setAdaptive(bool adaptive);
-		//! return whether the mesh resolution is adaptive to the window size
+		//! return whether the mesh is only refined where the warp curves, instead of being evenly spaced
 		bool getAdaptive() const;
 
+		//! set whether the mesh is evaluated on a worker thread, the previous mesh is drawn until the new one is ready
+		void setAsyncMesh(bool asyncMesh);
+		//! return whether the mesh is evaluated on a worker thread
+		bool getAsyncMesh() const;
+
+		//! set the minimum spacing in pixels between the control points drawn while editing
+		//! denser points are thinned out, except around the cursor and the selected point
+		void setControlPointSpacing(float spacing);
+		//! return the minimum spacing in pixels between the control points drawn while editing
+		float getControlPointSpacing() const;
+
 		//! increase the mesh resolution
 		void increaseResolution();
 		//! decrease the mesh resolution
@@ -52,31 +70,72 @@ namespace ofxWarp
 
 		void setCorners(float left, float top, float right, float bottom);
 
+		//! return a view of the control points as a grid, for evaluating the warp on the CPU
+		ControlGrid getControlGrid() const;
+
 		virtual void rotateClockwise() override;
 		virtual void rotateCounterclockwise() override;
 
 		virtual void flipHorizontal() override;
 		virtual void flipVertical() override;
 
+		//! return whether the warp fully covers the specified area in pixels, only 2x2 grids can tell
+		virtual bool covers(const ofRectangle & screenBounds) const override;
+
+		//! fill the mesh as it is drawn, sampled like the vbo mesh for the current settings
+		virtual bool getMesh(WarpMesh & mesh) const override;
+
 	protected:
+		//! fills the vertex positions of a column-major mesh sampled at the specified grid coordinates
+		typedef std::function<void(const std::vector<float> & samplesU, const std::vector<float> & samplesV, glm::vec4 * positions)> MeshEvaluator;
+
 		//! draw a specific area of a warped texture to a specific region
 		virtual void drawTexture(const ofTexture & texture, const ofRectangle & srcBounds, const ofRectangle & dstBounds) override;
 		//! draw the warp's controls interface
 		virtual void drawControls() override;
 
+		//! curved meshes can bulge out between control points, by up to half the distance between neighbors
+		virtual float getScreenBoundsMargin(const std::vector<glm::vec2> & screenPoints) const override;
+
+		//! return how many columns and rows to step over so that the drawn control points are spaced apart
+		glm::ivec2 getControlPointStride(const std::vector<glm::vec2> & screenPoints) const;
+
 		//! set up the frame buffer
 		void setupFbo();
+		virtual void setupShader() override;
 		//! set up the shader and vertex buffer
 		void setupVbo();
-		//! set up the vbo mesh
-		void setupMesh(int resolutionX = 36, int resolutionY = 36);
+		//! upload the mesh evaluated on a worker thread, and start a new evaluation if the warp changed
+		void setupVboAsync();
+		//! fill the grid coordinates the mesh should be sampled at for the current settings
+		//! adaptive meshes are only refined where the curved surface needs it, otherwise the samples are evenly spaced
+		void getMeshSamples(std::vector<float> & samplesU, std::vector<float> & samplesV) const;
+		//! return whether the mesh samples are refined by the curvature of the control grid
+		virtual bool usesAdaptiveMesh() const;
+		//! return a function that evaluates the mesh for the current state of the warp
+		//! it works on copies of that state, so it can run on a worker thread while the warp keeps changing
+		virtual MeshEvaluator getMeshEvaluator() const;
+		//! return a function that evaluates the control grid, optionally followed by a projective transform
+		MeshEvaluator getGridEvaluator(bool transformed, const glm::mat4 & transform) const;
+		//! fill the mesh with the positions returned by the evaluator, sampled for the current settings
+		void buildMesh(const MeshEvaluator & evaluator, WarpMesh & mesh) const;
+		//! return the largest distance in pixels between an adaptive mesh and the curved surface
+		float getMeshTolerance() const;
+		//! return the most steps a patch between control points is split into by an adaptive mesh
+		int getMaxMeshSubdivisions() const;
+		//! set up the vbo mesh sampled at the specified grid coordinates, keeping the buffers if the layout is unchanged
+		void setupMesh(const std::vector<float> & samplesU, const std::vector<float> & samplesV);
 		//! update the vbo mesh based on the control points
 		void updateMesh();
-		//!	return the specified control point, values for col and row are clamped to prevent errors.
-		glm::vec2 getPoint(int col, int row) const;
-		//! perform fast Catmull-Rom interpolation, and return the interpolated value at t
-		glm::vec2 cubicInterpolate(const std::vector<glm::vec2> & knots, float t) const;
-		//!
+		//! evaluate the control points into resolutionX * resolutionY vertex positions, without touching any GL resources
+		void evaluateMesh(glm::vec4 * positions) const;
+		//! set a projective transform applied to the mesh positions when they are evaluated, the mesh is rebuilt if it changed
+		void setMeshTransform(const glm::mat4 & transform);
+		//! stop transforming the mesh positions, the mesh is rebuilt if they were transformed
+		void clearMeshTransform();
+		//! apply a projective transform to homogeneous positions, keeping w so that the GPU interpolates them correctly
+		static void transformMesh(const glm::mat4 & transform, glm::vec4 * positions, size_t numPositions);
+		//! return the bounds of the control points in pixels, cached until the control points change
 		ofRectangle getMeshBounds() const;
 
 	protected:
@@ -92,14 +151,39 @@ namespace ofxWarp
 
 		//! texture coordinates of corners
 		glm::vec4 corners;
+		//! texture coordinates of corners the mesh was built with
+		glm::vec4 meshCorners;
+
+		//! minimum spacing in pixels between drawn control points
+		float controlPointSpacing;
 
 		//! detail of the generated mesh (multiples of 5 seem to work best)
+		//! adaptive meshes stay within resolution / 32 pixels of the curved surface
 		int resolution;
 
-		//! number of horizontal quads
+		//! number of horizontal vertices
 		int resolutionX;
-		//! number of vertical quads
+		//! number of vertical vertices
 		int resolutionY;
+		//! grid coordinates the mesh is sampled at, in [0..numControls - 1]
+		std::vector<float> meshSamplesU;
+		std::vector<float> meshSamplesV;
+
+		//! transform applied to the evaluated positions
+		bool meshTransformed;
+		glm::mat4 meshTransform;
+
+		//! evaluate the mesh on a worker thread
+		bool asyncMesh;
+		//! pending worker job, it writes to the staging buffer
+		std::future<void> meshJob;
+		std::vector<glm::vec4> stagingPositions;
+		std::vector<float> stagingSamplesU;
+		std::vector<float> stagingSamplesV;
+
+		//! bounds of the mesh in pixels, a render thread cache like the screen bounds in WarpBase
+		mutable ofRectangle meshBounds;
+		mutable uint64_t meshBoundsRevision;
 
 	private:
 		//! greatest common divisor using Euclidian algorithm (from: http://en.wikipedia.org/wiki/Greatest_common_divisor)
@@ -0,0 +1,239 @@
+#include "WarpChain.h"
+
+namespace ofxWarp
+{
+	//--------------------------------------------------------------
+	WarpChain::WarpChain(const ofFbo::Settings & fboSettings)
+		: WarpBilinear(fboSettings)
+	{
+		this->type = TYPE_CHAIN;
+	}
+
+	//--------------------------------------------------------------
+	WarpChain::~WarpChain()
+	{}
+
+	//--------------------------------------------------------------
+	void WarpChain::serialize(WarpData & data) const
+	{
+		WarpBilinear::serialize(data);
+
+		data.parameters = this->getStageParameters();
+		if (data.parameters.front() != this->stages.size())
+		{
+			ofLogWarning("WarpChain::serialize") << "Skipping " << (this->stages.size() - data.parameters.front()) << " stages that can't be saved";
+		}
+	}
+
+	//--------------------------------------------------------------
+	void WarpChain::deserialize(const WarpData & data)
+	{
+		WarpBilinear::deserialize(data);
+
+		// Leave the stages alone if they didn't change, so the mesh isn't rebuilt needlessly.
+		if (data.parameters.empty() || data.parameters == this->getStageParameters()) return;
+
+		std::vector<std::shared_ptr<const WarpStage>> stages;
+		auto numStages = (size_t)data.parameters[0];
+		size_t offset = 1;
+		for (size_t i = 0; i < numStages; ++i)
+		{
+			if (offset + 2 > data.parameters.size())
+			{
+				ofLogWarning("WarpChain::deserialize") << "Stage " << i << " is truncated, ignoring the remaining stages";
+				break;
+			}
+
+			auto type = (WarpStage::Type)(int)data.parameters[offset];
+			auto numParameters = (size_t)data.parameters[offset + 1];
+			offset += 2;
+			if (offset + numParameters > data.parameters.size())
+			{
+				ofLogWarning("WarpChain::deserialize") << "Stage " << i << " is truncated, ignoring the remaining stages";
+				break;
+			}
+
+			auto stage = WarpStage::create(type);
+			if (stage && stage->deserialize(data.parameters.data() + offset, numParameters))
+			{
+				stages.push_back(stage);
+			}
+			else
+			{
+				ofLogWarning("WarpChain::deserialize") << "Unrecognized stage type " << type << ", skipping it";
+			}
+			offset += numParameters;
+		}
+
+		this->stages = stages;
+		this->markDirty();
+	}
+
+	//--------------------------------------------------------------
+	void WarpChain::addStage(std::shared_ptr<const WarpStage> stage)
+	{
+		if (!stage) return;
+
+		this->stages.push_back(stage);
+		this->markDirty();
+	}
+
+	//--------------------------------------------------------------
+	void WarpChain::setStage(size_t index, std::shared_ptr<const WarpStage> stage)
+	{
+		if (index >= this->stages.size() || !stage) return;
+
+		this->stages[index] = stage;
+		this->markDirty();
+	}
+
+	//--------------------------------------------------------------
+	void WarpChain::removeStage(size_t index)
+	{
+		if (index >= this->stages.size()) return;
+
+		this->stages.erase(this->stages.begin() + index);
+		this->markDirty();
+	}
+
+	//--------------------------------------------------------------
+	void WarpChain::clearStages()
+	{
+		if (this->stages.empty()) return;
+
+		this->stages.clear();
+		this->markDirty();
+	}
+
+	//--------------------------------------------------------------
+	size_t WarpChain::getNumStages() const
+	{
+		return this->stages.size();
+	}
+
+	//--------------------------------------------------------------
+	std::shared_ptr<const WarpStage> WarpChain::getStage(size_t index) const
+	{
+		if (index >= this->stages.size()) return nullptr;
+
+		return this->stages[index];
+	}
+
+	//--------------------------------------------------------------
+	bool WarpChain::covers(const ofRectangle & screenBounds) const
+	{
+		// The stages can shrink the content within the grid, so only a plain grid can tell.
+		if (!this->stages.empty()) return false;
+
+		return WarpBilinear::covers(screenBounds);
+	}
+
+	//--------------------------------------------------------------
+	bool WarpChain::usesAdaptiveMesh() const
+	{
+		return (this->adaptive && this->stages.empty());
+	}
+
+	//--------------------------------------------------------------
+	WarpBilinear::MeshEvaluator WarpChain::getMeshEvaluator() const
+	{
+		if (this->stages.empty())
+		{
+			return WarpBilinear::getMeshEvaluator();
+		}
+
+		auto controlPoints = this->controlPoints;
+		auto numControlsX = this->numControlsX;
+		auto numControlsY = this->numControlsY;
+		auto linear = this->linear;
+		auto windowSize = this->windowSize;
+		auto stages = this->stages;
+
+		return [=](const std::vector<float> & samplesU, const std::vector<float> & samplesV, glm::vec4 * positions)
+		{
+			ControlGrid grid(controlPoints, numControlsX, numControlsY);
+			auto lastControl = glm::vec2(numControlsX - 1, numControlsY - 1);
+
+			// Map one column at a time, so each stage gets a batch of points.
+			std::vector<glm::vec2> column(samplesV.size());
+			for (size_t x = 0; x < samplesU.size(); ++x)
+			{
+				// Start from normalized content coordinates.
+				for (size_t y = 0; y < samplesV.size(); ++y)
+				{
+					column[y] = glm::vec2(samplesU[x], samplesV[y]) / lastControl;
+				}
+
+				for (const auto & stage : stages)
+				{
+					stage->map(column.data(), column.size());
+				}
+
+				// The control grid takes the output of the last stage to the screen.
+				auto output = positions + (x * samplesV.size());
+				for (size_t y = 0; y < samplesV.size(); ++y)
+				{
+					auto gridPos = column[y] * lastControl;
+					auto pt = grid.evaluate(gridPos.x, gridPos.y, linear) * windowSize;
+					output[y] = glm::vec4(pt.x, pt.y, 0.0f, 1.0f);
+				}
+			}
+		};
+	}
+
+	//--------------------------------------------------------------
+	float WarpChain::getScreenBoundsMargin(const std::vector<glm::vec2> & screenPoints) const
+	{
+		auto margin = WarpBilinear::getScreenBoundsMargin(screenPoints);
+		if (this->stages.empty() || screenPoints.empty()) return margin;
+
+		// Evaluate the chain on a coarse grid, and see how far it reaches past the control points.
+		static const int numSamples = 9;
+		std::vector<float> samplesU(numSamples);
+		std::vector<float> samplesV(numSamples);
+		for (auto i = 0; i < numSamples; ++i)
+		{
+			samplesU[i] = i * (this->numControlsX - 1) / (float)(numSamples - 1);
+			samplesV[i] = i * (this->numControlsY - 1) / (float)(numSamples - 1);
+		}
+		std::vector<glm::vec4> positions(numSamples * numSamples);
+		this->getMeshEvaluator()(samplesU, samplesV, positions.data());
+
+		auto min = screenPoints.front();
+		auto max = screenPoints.front();
+		for (const auto & pt : screenPoints)
+		{
+			min = glm::min(min, pt);
+			max = glm::max(max, pt);
+		}
+
+		auto overshoot = 0.0f;
+		for (const auto & pos : positions)
+		{
+			auto pt = glm::vec2(pos);
+			auto outside = glm::max(min - pt, pt - max);
+			overshoot = MAX(overshoot, MAX(outside.x, outside.y));
+		}
+
+		return (margin + overshoot);
+	}
+
+	//--------------------------------------------------------------
+	std::vector<float> WarpChain::getStageParameters() const
+	{
+		std::vector<float> parameters(1, 0.0f);
+		std::vector<float> stageParameters;
+		for (const auto & stage : this->stages)
+		{
+			// Stages that can't be saved are left out.
+			stageParameters.clear();
+			if (!stage->serialize(stageParameters)) continue;
+
+			parameters.push_back(stage->getType());
+			parameters.push_back(stageParameters.size());
+			parameters.insert(parameters.end(), stageParameters.begin(), stageParameters.end());
+			parameters[0] += 1.0f;
+		}
+		return parameters;
+	}
+}
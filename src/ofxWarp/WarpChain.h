@@ -0,0 +1,57 @@
+#pragma once
+
+#include "WarpBilinear.h"
+#include "Geometry/WarpStage.h"
+
+namespace ofxWarp
+{
+	//! Bilinear warp that passes its content through a chain of stages first, e.g. lens distortion followed by a perspective transform.
+	//! The stages map normalized content coordinates in order, and the control grid maps the result to the screen, so it can be used to
+	//! fine-tune the whole chain. Everything is evaluated into the vertices of a single mesh, so any chain is still drawn in one pass.
+	class WarpChain
+		: public WarpBilinear
+	{
+	public:
+		WarpChain(const ofFbo::Settings & fboSettings = ofFbo::Settings());
+		virtual ~WarpChain();
+
+		using WarpBase::serialize;
+		using WarpBase::deserialize;
+
+		virtual void serialize(WarpData & data) const override;
+		virtual void deserialize(const WarpData & data) override;
+
+		//! append a stage, it is applied after the current stages and before the control grid
+		void addStage(std::shared_ptr<const WarpStage> stage);
+		//! replace the stage at the specified index
+		void setStage(size_t index, std::shared_ptr<const WarpStage> stage);
+		//! remove the stage at the specified index
+		void removeStage(size_t index);
+		//! remove all stages, leaving a plain bilinear warp
+		void clearStages();
+
+		//! return the number of stages
+		size_t getNumStages() const;
+		//! return the stage at the specified index, or nullptr if there is no such stage
+		std::shared_ptr<const WarpStage> getStage(size_t index) const;
+
+		//! return whether the warp fully covers the specified area in pixels, only plain 2x2 grids can tell
+		virtual bool covers(const ofRectangle & screenBounds) const override;
+
+	protected:
+		//! the curvature of the control grid says nothing about the stages, so chains use evenly spaced samples
+		virtual bool usesAdaptiveMesh() const override;
+		//! return a function that passes the samples through the stages and the control grid
+		virtual MeshEvaluator getMeshEvaluator() const override;
+
+		//! the stages can move content past the control points, where the grid is extrapolated
+		virtual float getScreenBoundsMargin(const std::vector<glm::vec2> & screenPoints) const override;
+
+		//! return the stage settings packed into a flat list: the number of stages, then the type,
+		//! number of parameters and parameters of each stage
+		std::vector<float> getStageParameters() const;
+
+	protected:
+		std::vector<std::shared_ptr<const WarpStage>> stages;
+	};
+}
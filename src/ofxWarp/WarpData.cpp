@@ -0,0 +1,407 @@
+#include "WarpData.h"
+
+#include <iomanip>
+#if __has_include(<charconv>)
+#include <charconv>
+#endif
+
+namespace ofxWarp
+{
+	namespace
+	{
+		//--------------------------------------------------------------
+		template<typename Type>
+		std::string toString(const Type & value)
+		{
+			// Write enough digits for the value to survive a round trip.
+			std::ostringstream oss;
+			oss << std::setprecision(std::numeric_limits<float>::max_digits10) << value;
+			return oss.str();
+		}
+
+		//--------------------------------------------------------------
+		const char * parseFloat(const char * first, const char * last, float & value)
+		{
+#if defined(__cpp_lib_to_chars)
+			auto result = std::from_chars(first, last, value);
+			return (result.ec == std::errc()) ? result.ptr : nullptr;
+#else
+			// The string is null-terminated, so strtof can't run past the end.
+			char * end;
+			value = std::strtof(first, &end);
+			return (end != first) ? end : nullptr;
+#endif
+		}
+
+		//--------------------------------------------------------------
+		bool fromString(const std::string & str, float * values, size_t count)
+		{
+			// Legacy values are written as "x, y, z", skip any separator between the numbers.
+			auto first = str.data();
+			auto last = str.data() + str.size();
+			for (size_t i = 0; i < count; ++i)
+			{
+				while (first < last && (*first == ',' || *first == ' ' || *first == '\t'))
+				{
+					++first;
+				}
+				first = parseFloat(first, last, values[i]);
+				if (first == nullptr)
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+		//--------------------------------------------------------------
+		const nlohmann::json * findKey(const nlohmann::json & json, const char * key)
+		{
+			// operator[] on a const object is undefined for missing keys, so every lookup goes through find().
+			if (!json.is_object()) return nullptr;
+
+			auto it = json.find(key);
+			return (it != json.end()) ? &*it : nullptr;
+		}
+
+		//--------------------------------------------------------------
+		bool readValue(const nlohmann::json & json, const char * key, float & value)
+		{
+			auto found = findKey(json, key);
+			if (found == nullptr || !found->is_number()) return false;
+
+			value = found->get<float>();
+			return true;
+		}
+
+		//--------------------------------------------------------------
+		bool readValue(const nlohmann::json & json, const char * key, int & value)
+		{
+			auto found = findKey(json, key);
+			if (found == nullptr || !found->is_number_integer()) return false;
+
+			value = found->get<int>();
+			return true;
+		}
+
+		//--------------------------------------------------------------
+		bool readValue(const nlohmann::json & json, const char * key, size_t & value)
+		{
+			auto found = findKey(json, key);
+			if (found == nullptr || !found->is_number_unsigned()) return false;
+
+			value = found->get<size_t>();
+			return true;
+		}
+
+		//--------------------------------------------------------------
+		bool readValue(const nlohmann::json & json, const char * key, bool & value)
+		{
+			auto found = findKey(json, key);
+			if (found == nullptr || !found->is_boolean()) return false;
+
+			value = found->get<bool>();
+			return true;
+		}
+
+		//--------------------------------------------------------------
+		bool readValue(const nlohmann::json & json, const char * key, std::string & value)
+		{
+			auto found = findKey(json, key);
+			if (found == nullptr || !found->is_string()) return false;
+
+			value = found->get<std::string>();
+			return true;
+		}
+
+		//--------------------------------------------------------------
+		bool readValue(const nlohmann::json & json, const char * key, std::vector<float> & values)
+		{
+			auto found = findKey(json, key);
+			if (found == nullptr || !found->is_array()) return false;
+
+			values.clear();
+			values.reserve(found->size());
+			for (const auto & value : *found)
+			{
+				if (!value.is_number()) return false;
+
+				values.push_back(value.get<float>());
+			}
+			return true;
+		}
+
+		//--------------------------------------------------------------
+		template<typename Type>
+		bool fromJson(const nlohmann::json & json, Type & value)
+		{
+			if (json.is_string())
+			{
+				return fromString(json.get_ref<const std::string &>(), &value[0], value.length());
+			}
+
+			if (!json.is_array() || json.size() != (size_t)value.length()) return false;
+
+			for (auto i = 0; i < value.length(); ++i)
+			{
+				if (!json[i].is_number()) return false;
+
+				value[i] = json[i].get<float>();
+			}
+			return true;
+		}
+
+		//--------------------------------------------------------------
+		template<typename Type>
+		nlohmann::json toJson(const Type & value)
+		{
+			std::vector<float> values(value.length());
+			for (auto i = 0; i < value.length(); ++i)
+			{
+				values[i] = value[i];
+			}
+			return values;
+		}
+
+		//--------------------------------------------------------------
+		void pointsToJson(const std::vector<glm::vec2> & points, int version, nlohmann::json & json)
+		{
+			if (version < 2)
+			{
+				std::vector<std::string> strings;
+				for (auto & point : points)
+				{
+					strings.push_back(toString(point));
+				}
+				json = strings;
+			}
+			else
+			{
+				// Flat array of x, y pairs.
+				std::vector<float> values;
+				values.reserve(points.size() * 2);
+				for (auto & point : points)
+				{
+					values.push_back(point.x);
+					values.push_back(point.y);
+				}
+				json = values;
+			}
+		}
+
+		//--------------------------------------------------------------
+		bool pointsFromJson(const nlohmann::json & json, std::vector<glm::vec2> & points)
+		{
+			points.clear();
+			if (json.empty()) return true;
+			if (!json.is_array()) return false;
+
+			if (json[0].is_string())
+			{
+				points.resize(json.size());
+				for (size_t i = 0; i < json.size(); ++i)
+				{
+					if (!json[i].is_string() || !fromString(json[i].get_ref<const std::string &>(), &points[i][0], 2)) return false;
+				}
+			}
+			else
+			{
+				// Flat array of x, y pairs, a missing coordinate means the record is cut short.
+				if (json.size() % 2 != 0) return false;
+
+				points.resize(json.size() / 2);
+				for (size_t i = 0; i < json.size(); ++i)
+				{
+					if (!json[i].is_number()) return false;
+
+					points[i / 2][i % 2] = json[i].get<float>();
+				}
+			}
+			return true;
+		}
+	}
+
+	//--------------------------------------------------------------
+	WarpData::WarpData()
+		: type(0)
+		, brightness(1.0f)
+		, numControlsX(2)
+		, numControlsY(2)
+		, exponent(2.0f)
+		, edges(0.0f)
+		, gamma(1.0f)
+		, luminance(0.5f)
+		, hasMesh(false)
+		, resolution(16)
+		, linear(false)
+		, adaptive(true)
+	{}
+
+	//--------------------------------------------------------------
+	void WarpData::serialize(nlohmann::json & json, int version) const
+	{
+		// Main parameters.
+		json["type"] = this->type;
+		json["brightness"] = this->brightness;
+
+		// Warp parameters.
+		{
+			auto & jsonWarp = json["warp"];
+
+			jsonWarp["columns"] = this->numControlsX;
+			jsonWarp["rows"] = this->numControlsY;
+
+			pointsToJson(this->controlPoints, version, jsonWarp["control points"]);
+		}
+
+		// Blend parameters.
+		{
+			auto & jsonBlend = json["blend"];
+
+			jsonBlend["exponent"] = this->exponent;
+			if (version < 2)
+			{
+				jsonBlend["edges"] = toString(this->edges);
+				jsonBlend["gamma"] = toString(this->gamma);
+				jsonBlend["luminance"] = toString(this->luminance);
+			}
+			else
+			{
+				jsonBlend["edges"] = toJson(this->edges);
+				jsonBlend["gamma"] = toJson(this->gamma);
+				jsonBlend["luminance"] = toJson(this->luminance);
+			}
+		}
+
+		// Mesh parameters.
+		if (this->hasMesh)
+		{
+			json["resolution"] = this->resolution;
+			json["linear"] = this->linear;
+			json["adaptive"] = this->adaptive;
+		}
+
+		// Perspective corners.
+		if (!this->corners.empty())
+		{
+			pointsToJson(this->corners, version, json["corners"]);
+		}
+
+		// Map file.
+		if (!this->mapPath.empty())
+		{
+			json["map"] = this->mapPath;
+		}
+
+		// Additional parameters.
+		if (!this->parameters.empty())
+		{
+			json["parameters"] = this->parameters;
+		}
+	}
+
+	//--------------------------------------------------------------
+	bool WarpData::deserialize(const nlohmann::json & json)
+	{
+		// Main parameters.
+		if (!readValue(json, "type", this->type) || !readValue(json, "brightness", this->brightness)) return false;
+
+		// Warp parameters.
+		{
+			auto jsonWarp = findKey(json, "warp");
+			if (jsonWarp == nullptr) return false;
+
+			if (!readValue(*jsonWarp, "columns", this->numControlsX) || !readValue(*jsonWarp, "rows", this->numControlsY)) return false;
+
+			auto jsonPoints = findKey(*jsonWarp, "control points");
+			if (jsonPoints == nullptr || !pointsFromJson(*jsonPoints, this->controlPoints)) return false;
+		}
+
+		// Blend parameters.
+		{
+			auto jsonBlend = findKey(json, "blend");
+			if (jsonBlend == nullptr || !readValue(*jsonBlend, "exponent", this->exponent)) return false;
+
+			auto jsonEdges = findKey(*jsonBlend, "edges");
+			auto jsonGamma = findKey(*jsonBlend, "gamma");
+			auto jsonLuminance = findKey(*jsonBlend, "luminance");
+			if (jsonEdges == nullptr || jsonGamma == nullptr || jsonLuminance == nullptr
+				|| !fromJson(*jsonEdges, this->edges) || !fromJson(*jsonGamma, this->gamma) || !fromJson(*jsonLuminance, this->luminance))
+			{
+				return false;
+			}
+		}
+
+		// Mesh parameters.
+		this->hasMesh = (findKey(json, "resolution") != nullptr);
+		if (this->hasMesh)
+		{
+			if (!readValue(json, "resolution", this->resolution) || !readValue(json, "linear", this->linear) || !readValue(json, "adaptive", this->adaptive))
+			{
+				return false;
+			}
+		}
+
+		// Perspective corners.
+		this->corners.clear();
+		auto jsonCorners = findKey(json, "corners");
+		if (jsonCorners != nullptr && !pointsFromJson(*jsonCorners, this->corners))
+		{
+			return false;
+		}
+
+		// Map file.
+		this->mapPath.clear();
+		if (findKey(json, "map") != nullptr && !readValue(json, "map", this->mapPath))
+		{
+			return false;
+		}
+
+		// Additional parameters.
+		this->parameters.clear();
+		if (findKey(json, "parameters") != nullptr && !readValue(json, "parameters", this->parameters))
+		{
+			return false;
+		}
+
+		return true;
+	}
+
+	//--------------------------------------------------------------
+	bool WarpData::operator==(const WarpData & other) const
+	{
+		return (this->type == other.type
+			&& this->brightness == other.brightness
+			&& this->numControlsX == other.numControlsX
+			&& this->numControlsY == other.numControlsY
+			&& this->controlPoints == other.controlPoints
+			&& this->exponent == other.exponent
+			&& this->edges == other.edges
+			&& this->gamma == other.gamma
+			&& this->luminance == other.luminance
+			&& this->hasMesh == other.hasMesh
+			&& this->resolution == other.resolution
+			&& this->linear == other.linear
+			&& this->adaptive == other.adaptive
+			&& this->corners == other.corners
+			&& this->mapPath == other.mapPath
+			&& this->parameters == other.parameters);
+	}
+
+	//--------------------------------------------------------------
+	bool WarpData::operator!=(const WarpData & other) const
+	{
+		return !(*this == other);
+	}
+
+	//--------------------------------------------------------------
+	WarpParameters::WarpParameters()
+		: brightness(1.0f)
+		, numControlsX(0)
+		, numControlsY(0)
+		, exponent(2.0f)
+		, edges(0.0f)
+		, gamma(1.0f)
+		, luminance(0.5f)
+	{}
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "ofJson.h"
+#include "ofVectorMath.h"
+
+namespace ofxWarp
+{
+	//! Plain copy of the persistent state of a warp.
+	//! All settings formats go through this, so they can be converted into each other without creating any warps.
+	struct WarpData
+	{
+		//! json schema written by default
+		//! version 1 stores points and colors as strings, version 2 stores them as flat numeric arrays
+		static const int JSON_VERSION = 2;
+
+		WarpData();
+
+		//! write the state to a warp json object using the specified schema version
+		void serialize(nlohmann::json & json, int version = JSON_VERSION) const;
+		//! read the state from a warp json object, any schema version up to JSON_VERSION is accepted
+		//! return false if a field is missing, has the wrong type or is malformed, the record is then incomplete and
+		//! shouldn't be used
+		bool deserialize(const nlohmann::json & json);
+
+		bool operator==(const WarpData & other) const;
+		bool operator!=(const WarpData & other) const;
+
+		// Main parameters.
+		int type;
+		float brightness;
+
+		// Warp parameters.
+		size_t numControlsX;
+		size_t numControlsY;
+		std::vector<glm::vec2> controlPoints;
+
+		// Blend parameters.
+		float exponent;
+		glm::vec4 edges;
+		glm::vec3 gamma;
+		glm::vec3 luminance;
+
+		// Mesh parameters, only used by bilinear warps.
+		bool hasMesh;
+		int resolution;
+		bool linear;
+		bool adaptive;
+
+		// Perspective corners, only used by perspective bilinear warps.
+		std::vector<glm::vec2> corners;
+
+		// Pfm file holding the map, only used by map warps.
+		std::string mapPath;
+
+		// Additional parameters, their meaning depends on the warp type.
+		std::vector<float> parameters;
+	};
+
+	//! Parameters of a warp that can be driven from another thread, see WarpBase::publishParameters().
+	struct WarpParameters
+	{
+		WarpParameters();
+
+		float brightness;
+
+		// Control grid, the number of points has to match the number of controls.
+		size_t numControlsX;
+		size_t numControlsY;
+		std::vector<glm::vec2> controlPoints;
+
+		// Blend parameters.
+		float exponent;
+		glm::vec4 edges;
+		glm::vec3 gamma;
+		glm::vec3 luminance;
+	};
+}
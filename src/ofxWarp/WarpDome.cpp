@@ -0,0 +1,131 @@
+#include "WarpDome.h"
+
+#include "ThreadPool.h"
+
+namespace ofxWarp
+{
+	//--------------------------------------------------------------
+	WarpDome::WarpDome(const ofFbo::Settings & fboSettings)
+		: WarpBilinear(fboSettings)
+	{
+		this->type = TYPE_DOME;
+
+		this->setProjection(this->projection);
+	}
+
+	//--------------------------------------------------------------
+	WarpDome::~WarpDome()
+	{}
+
+	//--------------------------------------------------------------
+	void WarpDome::serialize(WarpData & data) const
+	{
+		WarpBilinear::serialize(data);
+
+		data.parameters.clear();
+		this->projection.serialize(data.parameters);
+	}
+
+	//--------------------------------------------------------------
+	void WarpDome::deserialize(const WarpData & data)
+	{
+		WarpBilinear::deserialize(data);
+
+		DomeProjection projection;
+		if (!projection.deserialize(data.parameters.data(), data.parameters.size()))
+		{
+			ofLogWarning("WarpDome::deserialize") << "Expected " << DomeProjection::NUM_PARAMETERS << " parameters but got " << data.parameters.size() << ", keeping the current projection";
+			return;
+		}
+		this->setProjection(projection);
+	}
+
+	//--------------------------------------------------------------
+	void WarpDome::setProjection(const DomeProjection & projection)
+	{
+		// The projector is assumed square until the window has a size.
+		auto aspectRatio = (this->windowSize.x > 0.0f && this->windowSize.y > 0.0f) ? (this->windowSize.x / this->windowSize.y) : 1.0f;
+
+		auto synced = projection;
+		synced.projectorAspectRatio = aspectRatio;
+		synced.projectorLens.aspectRatio = aspectRatio;
+
+		// Leave the mesh alone if nothing changed, it is expensive to rebuild.
+		if (synced == this->projection) return;
+
+		this->projection = synced;
+		this->markDirty();
+	}
+
+	//--------------------------------------------------------------
+	const DomeProjection & WarpDome::getProjection() const
+	{
+		return this->projection;
+	}
+
+	//--------------------------------------------------------------
+	bool WarpDome::covers(const ofRectangle & screenBounds) const
+	{
+		return false;
+	}
+
+	//--------------------------------------------------------------
+	bool WarpDome::handleWindowResize(int width, int height)
+	{
+		auto handled = WarpBilinear::handleWindowResize(width, height);
+
+		// Keep the projector aspect ratio in sync.
+		this->setProjection(this->projection);
+
+		return handled;
+	}
+
+	//--------------------------------------------------------------
+	bool WarpDome::usesAdaptiveMesh() const
+	{
+		return false;
+	}
+
+	//--------------------------------------------------------------
+	WarpBilinear::MeshEvaluator WarpDome::getMeshEvaluator() const
+	{
+		auto controlPoints = this->controlPoints;
+		auto numControlsX = this->numControlsX;
+		auto numControlsY = this->numControlsY;
+		auto linear = this->linear;
+		auto windowSize = this->windowSize;
+		auto projection = this->projection;
+
+		return [=](const std::vector<float> & samplesU, const std::vector<float> & samplesV, glm::vec4 * positions)
+		{
+			ControlGrid grid(controlPoints, numControlsX, numControlsY);
+			auto lastControl = glm::vec2(numControlsX - 1, numControlsY - 1);
+			auto numRows = samplesV.size();
+
+			// Every vertex is independent, so columns are spread over all cores.
+			ThreadPool::getShared().parallelFor(samplesU.size(), 8, [&](size_t begin, size_t end)
+			{
+				for (auto x = begin; x < end; ++x)
+				{
+					auto column = positions + (x * numRows);
+					for (size_t y = 0; y < numRows; ++y)
+					{
+						auto projected = projection.project(glm::vec2(samplesU[x], samplesV[y]) / lastControl);
+						if (projected.z > 0.0f)
+						{
+							// Keep the depth as w, so the texture is interpolated across each triangle as it lies on the dome.
+							auto gridPos = glm::vec2(projected) / projected.z * lastControl;
+							auto pt = grid.evaluate(gridPos.x, gridPos.y, linear) * windowSize;
+							column[y] = glm::vec4(pt * projected.z, 0.0f, projected.z);
+						}
+						else
+						{
+							// Behind the projector, the vertex is clipped so the control grid doesn't apply.
+							column[y] = glm::vec4(glm::vec2(projected) * windowSize, 0.0f, projected.z);
+						}
+					}
+				}
+			});
+		};
+	}
+}
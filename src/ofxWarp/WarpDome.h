@@ -0,0 +1,43 @@
+#pragma once
+
+#include "WarpBilinear.h"
+#include "Geometry/DomeProjection.h"
+
+namespace ofxWarp
+{
+	//! Warp that maps domemaster content onto a hemisphere, as seen by a projector with a known pose and lens.
+	//! The dense mesh this needs is generated from the projection on all cores and only rebuilt when the projection changes.
+	//! It is drawn like a bilinear warp, with the same blend parameters, and the control grid fine-tunes the projector image.
+	class WarpDome
+		: public WarpBilinear
+	{
+	public:
+		WarpDome(const ofFbo::Settings & fboSettings = ofFbo::Settings());
+		virtual ~WarpDome();
+
+		using WarpBase::serialize;
+		using WarpBase::deserialize;
+
+		virtual void serialize(WarpData & data) const override;
+		virtual void deserialize(const WarpData & data) override;
+
+		//! set the dome and projector parameters, the projector aspect ratio is kept in sync with the window
+		void setProjection(const DomeProjection & projection);
+		//! return the dome and projector parameters
+		const DomeProjection & getProjection() const;
+
+		//! parts of the dome can be behind the projector, so the warp never tells it covers an area
+		virtual bool covers(const ofRectangle & screenBounds) const override;
+
+		virtual bool handleWindowResize(int width, int height) override;
+
+	protected:
+		//! the mesh follows the projection, not the curvature of the control grid, so samples are evenly spaced
+		virtual bool usesAdaptiveMesh() const override;
+		//! return a function that projects the samples onto the dome and through the control grid, in parallel
+		virtual MeshEvaluator getMeshEvaluator() const override;
+
+	protected:
+		DomeProjection projection;
+	};
+}
@@ -0,0 +1,94 @@
+#include "WarpLens.h"
+
+namespace ofxWarp
+{
+	//--------------------------------------------------------------
+	WarpLens::WarpLens(const ofFbo::Settings & fboSettings)
+		: WarpChain(fboSettings)
+	{
+		this->type = TYPE_LENS;
+
+		this->setLensStage(LensModel(), true);
+	}
+
+	//--------------------------------------------------------------
+	WarpLens::~WarpLens()
+	{}
+
+	//--------------------------------------------------------------
+	void WarpLens::deserialize(const WarpData & data)
+	{
+		WarpChain::deserialize(data);
+
+		// The settings may have been saved for a different window, or without a lens.
+		this->setLensStage(this->getLens(), this->getPrecompensate());
+	}
+
+	//--------------------------------------------------------------
+	void WarpLens::setLens(const LensModel & lens)
+	{
+		this->setLensStage(lens, this->getPrecompensate());
+	}
+
+	//--------------------------------------------------------------
+	LensModel WarpLens::getLens() const
+	{
+		auto stage = this->getLensStage();
+		return stage ? stage->getLens() : LensModel();
+	}
+
+	//--------------------------------------------------------------
+	void WarpLens::setPrecompensate(bool precompensate)
+	{
+		this->setLensStage(this->getLens(), precompensate);
+	}
+
+	//--------------------------------------------------------------
+	bool WarpLens::getPrecompensate() const
+	{
+		auto stage = this->getLensStage();
+		return stage ? stage->getPrecompensate() : true;
+	}
+
+	//--------------------------------------------------------------
+	bool WarpLens::handleWindowResize(int width, int height)
+	{
+		auto handled = WarpChain::handleWindowResize(width, height);
+
+		// Keep the distortion circular in pixels.
+		this->setLensStage(this->getLens(), this->getPrecompensate());
+
+		return handled;
+	}
+
+	//--------------------------------------------------------------
+	std::shared_ptr<const LensStage> WarpLens::getLensStage() const
+	{
+		if (this->stages.empty()) return nullptr;
+
+		return std::dynamic_pointer_cast<const LensStage>(this->stages.front());
+	}
+
+	//--------------------------------------------------------------
+	void WarpLens::setLensStage(const LensModel & lens, bool precompensate)
+	{
+		auto model = lens;
+		// Windows that aren't set up yet have no shape, treat them as square.
+		model.aspectRatio = (this->windowSize.x > 0.0f && this->windowSize.y > 0.0f) ? (this->windowSize.x / this->windowSize.y) : 1.0f;
+
+		// Stages can't be changed once they are in the chain, so the lens is always replaced.
+		auto current = this->getLensStage();
+		if (current && current->getLens() == model && current->getPrecompensate() == precompensate) return;
+
+		auto stage = std::make_shared<LensStage>(model, precompensate);
+		if (current)
+		{
+			this->setStage(0, stage);
+		}
+		else
+		{
+			this->stages.insert(this->stages.begin(), stage);
+			this->markDirty();
+		}
+	}
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "WarpChain.h"
+
+namespace ofxWarp
+{
+	//! Warp that pre-compensates for the distortion of a projection lens, given its radial and tangential coefficients
+	//! and principal point. The mesh is generated from the lens model, so a handful of parameters replace a dense control grid.
+	//! The lens is the first stage of a chain: more stages can be added after it, and the control grid still fine-tunes the result.
+	class WarpLens
+		: public WarpChain
+	{
+	public:
+		WarpLens(const ofFbo::Settings & fboSettings = ofFbo::Settings());
+		virtual ~WarpLens();
+
+		using WarpBase::serialize;
+		using WarpBase::deserialize;
+
+		virtual void deserialize(const WarpData & data) override;
+
+		//! set the lens model, its aspect ratio is kept in sync with the window
+		void setLens(const LensModel & lens);
+		//! return the lens model
+		LensModel getLens() const;
+
+		//! set whether the distortion is pre-compensated (the default), or applied as is to preview what the lens does
+		void setPrecompensate(bool precompensate);
+		//! return whether the distortion is pre-compensated
+		bool getPrecompensate() const;
+
+		virtual bool handleWindowResize(int width, int height) override;
+
+	protected:
+		//! return the lens stage at the start of the chain, or nullptr if it was removed
+		std::shared_ptr<const LensStage> getLensStage() const;
+		//! replace the lens stage, or put one back at the start of the chain
+		void setLensStage(const LensModel & lens, bool precompensate);
+	};
+}
@@ -0,0 +1,517 @@
+#include "WarpMap.h"
+
+#include "ofGraphics.h"
+
+#include <filesystem>
+
+#include "Geometry/Sampling.h"
+#include "ThreadPool.h"
+
+namespace ofxWarp
+{
+	//--------------------------------------------------------------
+	WarpMap::WarpMap()
+		: WarpPerspective()
+		, mapData(nullptr)
+		, mapStride(2)
+		, mapWidth(0)
+		, mapHeight(0)
+		, mapBottomUp(false)
+		, mapComplete(false)
+		, mapTextureDirty(false)
+		, blendTextureDirty(false)
+	{
+		this->type = TYPE_MAP;
+	}
+
+	//--------------------------------------------------------------
+	WarpMap::~WarpMap()
+	{}
+
+	//--------------------------------------------------------------
+	void WarpMap::serialize(WarpData & data) const
+	{
+		WarpPerspective::serialize(data);
+
+		// The map is referred to by its file, and the inline map that precedes the blend map is left empty.
+		data.mapPath = this->mapPath;
+
+		// The inline map size, followed by the blend map size, channels and factors.
+		data.parameters.clear();
+		data.parameters.reserve(5 + this->blendMap.size());
+		data.parameters.push_back(0.0f);
+		data.parameters.push_back(0.0f);
+		data.parameters.push_back(this->blendMap.getWidth());
+		data.parameters.push_back(this->blendMap.getHeight());
+		data.parameters.push_back(this->blendMap.getNumChannels());
+		data.parameters.insert(data.parameters.end(), this->blendMap.getData(), this->blendMap.getData() + this->blendMap.size());
+	}
+
+	//--------------------------------------------------------------
+	void WarpMap::deserialize(const WarpData & data)
+	{
+		WarpPerspective::deserialize(data);
+
+		const auto & parameters = data.parameters;
+		if (parameters.size() < 2)
+		{
+			ofLogWarning("WarpMap::deserialize") << "Missing map size, keeping the current map";
+			return;
+		}
+
+		// Settings written before maps were kept in files store the map size and coordinates inline.
+		auto width = (size_t)parameters[0];
+		auto height = (size_t)parameters[1];
+		auto numMapParameters = 2 + width * height * 2;
+		if (parameters.size() < numMapParameters)
+		{
+			ofLogWarning("WarpMap::deserialize") << "Expected " << numMapParameters << " parameters for a " << width << "x" << height << " map but got " << parameters.size() << ", keeping the current map";
+			return;
+		}
+
+		if (!data.mapPath.empty())
+		{
+			// Leave a map that is already loaded alone, so it isn't mapped and uploaded again.
+			if (data.mapPath != this->mapPath && !this->loadMap(data.mapPath))
+			{
+				ofLogWarning("WarpMap::deserialize") << "Could not load the map from " << data.mapPath << ", keeping the current map";
+			}
+		}
+		else
+		{
+			std::vector<glm::vec2> map(width * height);
+			for (size_t i = 0; i < map.size(); ++i)
+			{
+				map[i] = glm::vec2(parameters[2 + i * 2], parameters[3 + i * 2]);
+			}
+			this->setMap(width, height, map);
+		}
+
+		// Settings written before blend maps were supported end here.
+		if (parameters.size() < numMapParameters + 3)
+		{
+			this->clearBlendMap();
+			return;
+		}
+
+		auto blendWidth = (size_t)parameters[numMapParameters];
+		auto blendHeight = (size_t)parameters[numMapParameters + 1];
+		auto blendChannels = (size_t)parameters[numMapParameters + 2];
+		auto numBlendValues = blendWidth * blendHeight * blendChannels;
+		if (parameters.size() != numMapParameters + 3 + numBlendValues)
+		{
+			ofLogWarning("WarpMap::deserialize") << "Expected " << numBlendValues << " values for a " << blendWidth << "x" << blendHeight << " blend map, ignoring it";
+			this->clearBlendMap();
+			return;
+		}
+
+		if (numBlendValues == 0)
+		{
+			this->clearBlendMap();
+			return;
+		}
+
+		ofFloatPixels blendMap;
+		blendMap.setFromPixels(parameters.data() + numMapParameters + 3, blendWidth, blendHeight, blendChannels);
+		this->setBlendMap(blendMap);
+	}
+
+	//--------------------------------------------------------------
+	bool WarpMap::setMap(size_t width, size_t height, const std::vector<glm::vec2> & map)
+	{
+		if (map.size() != width * height)
+		{
+			ofLogWarning("WarpMap::setMap") << "Expected " << (width * height) << " coordinates for a " << width << "x" << height << " map but got " << map.size();
+			return false;
+		}
+
+		this->map = map;
+		this->mapFile.reset();
+		this->mapPath.clear();
+		this->mapData = this->map.empty() ? nullptr : &this->map[0].x;
+		this->mapStride = 2;
+		this->mapWidth = width;
+		this->mapHeight = height;
+		this->mapBottomUp = false;
+
+		this->updateMapComplete();
+		this->mapTextureDirty = true;
+		this->markDirty();
+		return true;
+	}
+
+	//--------------------------------------------------------------
+	bool WarpMap::loadMap(const std::string & filePath)
+	{
+		auto file = std::make_shared<PfmFile>();
+		if (!file->open(filePath))
+		{
+			ofLogWarning("WarpMap::loadMap") << "Invalid pfm file at path " << filePath;
+			return false;
+		}
+		if (file->getNumChannels() < 2)
+		{
+			ofLogWarning("WarpMap::loadMap") << "Expected a color pfm file with coordinates in two channels at path " << filePath;
+			return false;
+		}
+
+		// Read the coordinates in place, the file stays mapped as long as the warp uses it.
+		this->map.clear();
+		this->mapFile = file;
+		this->mapPath = std::filesystem::absolute(filePath).string();
+		this->mapData = file->getPixels();
+		this->mapStride = file->getNumChannels();
+		this->mapWidth = file->getWidth();
+		this->mapHeight = file->getHeight();
+		this->mapBottomUp = true;
+
+		this->updateMapComplete();
+		this->mapTextureDirty = true;
+		this->markDirty();
+		return true;
+	}
+
+	//--------------------------------------------------------------
+	const std::string & WarpMap::getMapPath() const
+	{
+		return this->mapPath;
+	}
+
+	//--------------------------------------------------------------
+	bool WarpMap::saveMap(const std::string & filePath) const
+	{
+		if (this->mapData == nullptr) return false;
+
+		std::vector<float> pixels(this->mapWidth * this->mapHeight * 3, 0.0f);
+		for (size_t y = 0; y < this->mapHeight; ++y)
+		{
+			// Rows are written from the bottom up.
+			auto row = pixels.data() + ((this->mapHeight - 1 - y) * this->mapWidth * 3);
+			for (size_t x = 0; x < this->mapWidth; ++x)
+			{
+				auto uv = this->getMapCoord(x, y);
+				row[x * 3 + 0] = uv.x;
+				row[x * 3 + 1] = uv.y;
+			}
+		}
+
+		return PfmFile::save(filePath, this->mapWidth, this->mapHeight, 3, pixels.data());
+	}
+
+	//--------------------------------------------------------------
+	void WarpMap::getMap(std::vector<glm::vec2> & map) const
+	{
+		map.resize(this->mapWidth * this->mapHeight);
+		for (size_t y = 0; y < this->mapHeight; ++y)
+		{
+			for (size_t x = 0; x < this->mapWidth; ++x)
+			{
+				map[y * this->mapWidth + x] = this->getMapCoord(x, y);
+			}
+		}
+	}
+
+	//--------------------------------------------------------------
+	glm::vec2 WarpMap::getMapCoord(size_t x, size_t y) const
+	{
+		if (x >= this->mapWidth || y >= this->mapHeight) return glm::vec2(-1.0f);
+
+		auto row = this->mapBottomUp ? (this->mapHeight - 1 - y) : y;
+		auto uv = this->mapData + ((row * this->mapWidth + x) * this->mapStride);
+		return glm::vec2(uv[0], uv[1]);
+	}
+
+	//--------------------------------------------------------------
+	size_t WarpMap::getMapWidth() const
+	{
+		return this->mapWidth;
+	}
+
+	//--------------------------------------------------------------
+	size_t WarpMap::getMapHeight() const
+	{
+		return this->mapHeight;
+	}
+
+	//--------------------------------------------------------------
+	glm::vec2 WarpMap::sampleMap(const glm::vec2 & quadPoint) const
+	{
+		if (this->mapData == nullptr) return glm::vec2(-1.0f);
+
+		// Pfm files hold a third channel, which is filtered along and dropped.
+		float uv[3];
+		sampleBilinear(this->mapData, this->mapWidth, this->mapHeight, this->mapStride, quadPoint, uv, this->mapBottomUp);
+		return glm::vec2(uv[0], uv[1]);
+	}
+
+	//--------------------------------------------------------------
+	void WarpMap::setBlendMap(const ofFloatPixels & blendMap)
+	{
+		// The shader reads the factors from the color channels, so gray maps are expanded.
+		this->blendMap = blendMap;
+		if (this->blendMap.getNumChannels() != 3)
+		{
+			this->blendMap.setImageType(OF_IMAGE_COLOR);
+		}
+		this->blendTextureDirty = true;
+		this->markDirty();
+	}
+
+	//--------------------------------------------------------------
+	void WarpMap::clearBlendMap()
+	{
+		if (!this->blendMap.isAllocated()) return;
+
+		this->blendMap.clear();
+		this->blendTextureDirty = true;
+		this->markDirty();
+	}
+
+	//--------------------------------------------------------------
+	const ofFloatPixels & WarpMap::getBlendMap() const
+	{
+		return this->blendMap;
+	}
+
+	//--------------------------------------------------------------
+	glm::vec3 WarpMap::sampleBlendMap(const glm::vec2 & quadPoint) const
+	{
+		if (!this->blendMap.isAllocated()) return glm::vec3(1.0f);
+
+		glm::vec3 factors;
+		sampleBilinear(this->blendMap.getData(), this->blendMap.getWidth(), this->blendMap.getHeight(), 3, quadPoint, &factors[0]);
+		return factors;
+	}
+
+	//--------------------------------------------------------------
+	bool WarpMap::bake(const WarpBase & warp, size_t width, size_t height)
+	{
+		if (width == 0 || height == 0)
+		{
+			ofLogWarning("WarpMap::bake") << "Invalid map size " << width << "x" << height;
+			return false;
+		}
+
+		WarpMesh mesh;
+		if (!warp.getMesh(mesh))
+		{
+			ofLogWarning("WarpMap::bake") << "Warp of type " << warp.getType() << " isn't drawn as a mesh and can't be baked";
+			return false;
+		}
+
+		// Rows are independent, so they are rasterized on all cores. The mesh is in the pixels of the other warp's
+		// window, which is the one the map then covers.
+		std::vector<glm::vec2> map(width * height, glm::vec2(-1.0f));
+		auto screenSize = warp.getWindowSize();
+		ThreadPool::getShared().parallelFor(height, 16, [&](size_t begin, size_t end)
+		{
+			mesh.bakeMap(width, height, screenSize, map.data() + (begin * width), begin, end);
+		});
+
+		// Draw like the source warp, with the map covering the window.
+		this->setSize(warp.getSize());
+		this->setBrightness(warp.getBrightness());
+		this->setLuminance(warp.getLuminance());
+		this->setGamma(warp.getGamma());
+		this->setExponent(warp.getExponent());
+		this->setEdges(warp.getEdges());
+		this->clearBlendMap();
+		this->reset();
+
+		return this->setMap(width, height, map);
+	}
+
+	//--------------------------------------------------------------
+	bool WarpMap::covers(const ofRectangle & screenBounds) const
+	{
+		return (this->mapComplete && WarpPerspective::covers(screenBounds));
+	}
+
+	//--------------------------------------------------------------
+	bool WarpMap::getMesh(WarpMesh & mesh) const
+	{
+		mesh.clear();
+		return false;
+	}
+
+	//--------------------------------------------------------------
+	void WarpMap::drawTexture(const ofTexture & texture, const ofRectangle & srcBounds, const ofRectangle & dstBounds)
+	{
+		this->setupMapTextures();
+		if (!this->mapTexture.isAllocated()) return;
+
+		// Clip against bounds.
+		auto srcClip = srcBounds;
+		auto dstClip = dstBounds;
+		this->clip(srcClip, dstClip);
+
+		// Set corner texture coordinates.
+		glm::vec4 corners;
+		if (texture.getTextureData().textureTarget == GL_TEXTURE_RECTANGLE_ARB)
+		{
+			if (texture.getTextureData().bFlipTexture)
+			{
+				corners = glm::vec4(srcClip.getMinX(), srcClip.getMaxY(), srcClip.getMaxX(), srcClip.getMinY());
+			}
+			else
+			{
+				corners = glm::vec4(srcClip.getMinX(), srcClip.getMinY(), srcClip.getMaxX(), srcClip.getMaxY());
+			}
+		}
+		else
+		{
+			if (texture.getTextureData().bFlipTexture)
+			{
+				corners = glm::vec4(srcClip.getMinX() / texture.getWidth(), srcClip.getMaxY() / texture.getHeight(), srcClip.getMaxX() / texture.getWidth(), srcClip.getMinY() / texture.getHeight());
+			}
+			else
+			{
+				corners = glm::vec4(srcClip.getMinX() / texture.getWidth(), srcClip.getMinY() / texture.getHeight(), srcClip.getMaxX() / texture.getWidth(), srcClip.getMaxY() / texture.getHeight());
+			}
+		}
+
+		// The map spans the whole quad, whatever area of the content is drawn.
+		ofMesh quad;
+		quad.setMode(OF_PRIMITIVE_TRIANGLE_FAN);
+		quad.addVertex(glm::vec3(0.0f, 0.0f, 0.0f));
+		quad.addTexCoord(glm::vec2(0.0f, 0.0f));
+		quad.addVertex(glm::vec3(this->width, 0.0f, 0.0f));
+		quad.addTexCoord(glm::vec2(1.0f, 0.0f));
+		quad.addVertex(glm::vec3(this->width, this->height, 0.0f));
+		quad.addTexCoord(glm::vec2(1.0f, 1.0f));
+		quad.addVertex(glm::vec3(0.0f, this->height, 0.0f));
+		quad.addTexCoord(glm::vec2(0.0f, 1.0f));
+
+		ofPushMatrix();
+		{
+			ofMultMatrix(this->getTransform());
+
+			auto currentColor = ofGetStyle().color;
+			ofPushStyle();
+			{
+				// Adjust brightness.
+				if (this->brightness < 1.0f)
+				{
+					currentColor *= this->brightness;
+					ofSetColor(currentColor);
+				}
+
+				// Draw texture.
+				this->setupShader();
+				this->shader.begin();
+				{
+					this->shader.setUniformTexture("uTexture", texture, 1);
+					this->shader.setUniformTexture("uMap", this->mapTexture, 2);
+					this->shader.setUniform1i("uFlipMap", this->mapBottomUp);
+					this->shader.setUniform1i("uHasBlendMap", this->blendTexture.isAllocated());
+					if (this->blendTexture.isAllocated())
+					{
+						this->shader.setUniformTexture("uBlendMap", this->blendTexture, 3);
+					}
+					this->shader.setUniform3f("uLuminance", this->luminance);
+					this->shader.setUniform3f("uGamma", this->gamma);
+					this->shader.setUniform4f("uEdges", this->edges);
+					this->shader.setUniform4f("uCorners", corners);
+					this->shader.setUniform1f("uExponent", this->exponent);
+
+					quad.draw();
+				}
+				this->shader.end();
+			}
+			ofPopStyle();
+
+			if (this->editing)
+			{
+				// Draw the outline of the quad.
+				ofPushStyle();
+				{
+					glHint(GL_LINE_SMOOTH_HINT, GL_NICEST);
+
+					ofSetColor(ofColor::white);
+					ofNoFill();
+					ofDrawRectangle(0.0f, 0.0f, this->width, this->height);
+				}
+				ofPopStyle();
+			}
+		}
+		ofPopMatrix();
+	}
+
+	//--------------------------------------------------------------
+	bool WarpMap::getLocatorMesh(WarpMesh & mesh) const
+	{
+		return WarpPerspective::getMesh(mesh);
+	}
+
+	//--------------------------------------------------------------
+	bool WarpMap::resolveContentCoord(glm::vec2 & coord) const
+	{
+		coord = this->sampleMap(coord);
+		return (coord.x >= 0.0f && coord.y >= 0.0f);
+	}
+
+	//--------------------------------------------------------------
+	void WarpMap::setupShader()
+	{
+		if (!this->shader.isLoaded())
+		{
+			this->shader.load(WarpBase::shaderPath / "WarpMap");
+		}
+	}
+
+	//--------------------------------------------------------------
+	void WarpMap::setupMapTextures()
+	{
+		if (this->mapTextureDirty)
+		{
+			if (this->mapData == nullptr)
+			{
+				this->mapTexture.clear();
+			}
+			else
+			{
+				// Normalized coordinates are needed for the lookup, so rectangle textures are not used.
+				// Coordinates are uploaded straight from where they are stored, extra channels of pfm files included.
+				auto internalFormat = (this->mapStride == 2) ? GL_RG32F : GL_RGB32F;
+				if (!this->mapTexture.isAllocated() || this->mapTexture.getWidth() != this->mapWidth || this->mapTexture.getHeight() != this->mapHeight || this->mapTexture.getTextureData().glInternalFormat != internalFormat)
+				{
+					this->mapTexture.allocate(this->mapWidth, this->mapHeight, internalFormat, false);
+					this->mapTexture.setTextureMinMagFilter(GL_LINEAR, GL_LINEAR);
+					this->mapTexture.setTextureWrap(GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE);
+				}
+				this->mapTexture.loadData(this->mapData, this->mapWidth, this->mapHeight, (this->mapStride == 2) ? GL_RG : GL_RGB);
+			}
+
+			this->mapTextureDirty = false;
+		}
+
+		if (this->blendTextureDirty)
+		{
+			if (this->blendMap.isAllocated())
+			{
+				this->blendTexture.allocate(this->blendMap, false);
+				this->blendTexture.setTextureMinMagFilter(GL_LINEAR, GL_LINEAR);
+				this->blendTexture.setTextureWrap(GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE);
+				this->blendTexture.loadData(this->blendMap);
+			}
+			else
+			{
+				this->blendTexture.clear();
+			}
+
+			this->blendTextureDirty = false;
+		}
+	}
+
+	//--------------------------------------------------------------
+	void WarpMap::updateMapComplete()
+	{
+		// Coordinates that aren't numbers count as missing too.
+		this->mapComplete = (this->mapData != nullptr && this->mapWidth > 0 && this->mapHeight > 0);
+		for (size_t i = 0; i < this->mapWidth * this->mapHeight && this->mapComplete; ++i)
+		{
+			auto uv = this->mapData + (i * this->mapStride);
+			this->mapComplete = (uv[0] >= 0.0f && uv[1] >= 0.0f);
+		}
+	}
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "ofPixels.h"
+
+#include <memory>
+
+#include "PfmFile.h"
+#include "WarpPerspective.h"
+
+namespace ofxWarp
+{
+	//! Warp that looks up the content coordinates of every output pixel in a map, so any calibration can be drawn
+	//! with a single quad, at the same cost however complex the mapping is.
+	//! The map is spread over the quad between the four corners, which covers the window until they are moved.
+	//! It is drawn with the same blend parameters as the other warps, applied in content coordinates, and an optional
+	//! blend map that scales the color of every output pixel.
+	class WarpMap
+		: public WarpPerspective
+	{
+	public:
+		WarpMap();
+		virtual ~WarpMap();
+
+		using WarpBase::serialize;
+		using WarpBase::deserialize;
+
+		//! the map is saved as the path of its pfm file, and the blend map with the parameters
+		//! maps set in memory have no file until Controller::saveSettings() writes one next to the settings
+		virtual void serialize(WarpData & data) const override;
+		virtual void deserialize(const WarpData & data) override;
+
+		//! set the map of normalized content coordinates, one per pixel, row by row starting at the top left
+		//! pixels with a negative coordinate have no content, return false if the size doesn't match
+		bool setMap(size_t width, size_t height, const std::vector<glm::vec2> & map);
+		//! read the map from a pfm file, whose first two channels hold the content coordinates
+		//! the file is memory mapped and uploaded from there, it stays mapped until the map is replaced
+		bool loadMap(const std::string & filePath);
+		//! return the absolute path of the pfm file the map was loaded from, or an empty string if it was set in memory
+		const std::string & getMapPath() const;
+		//! write the map to a pfm file, with the content coordinates in the first two channels
+		bool saveMap(const std::string & filePath) const;
+		//! copy the map, row by row starting at the top left
+		void getMap(std::vector<glm::vec2> & map) const;
+		//! return the content coordinates of a map pixel, rows start at the top
+		glm::vec2 getMapCoord(size_t x, size_t y) const;
+		//! return the number of map columns
+		size_t getMapWidth() const;
+		//! return the number of map rows
+		size_t getMapHeight() const;
+		//! return the content coordinates at a point of the quad in normalized coordinates, filtered like the shader does
+		glm::vec2 sampleMap(const glm::vec2 & quadPoint) const;
+
+		//! set a map of factors the color of each output pixel is multiplied by, spread over the quad like the map
+		//! the edge blending parameters still apply on top of it
+		void setBlendMap(const ofFloatPixels & blendMap);
+		//! remove the blend map
+		void clearBlendMap();
+		//! return the blend map, which isn't allocated if there is none
+		const ofFloatPixels & getBlendMap() const;
+		//! return the blend map factors at a point of the quad in normalized coordinates, or 1 if there is no blend map
+		glm::vec3 sampleBlendMap(const glm::vec2 & quadPoint) const;
+
+		//! replace the map with what another warp draws in the same window, sampled at width * height pixels
+		//! the blend parameters and content size are copied and the corners are reset, so the result draws the same way
+		//! return false if the warp isn't drawn as a mesh
+		bool bake(const WarpBase & warp, size_t width, size_t height);
+
+		//! return whether the map is complete and the quad fully covers the specified area in pixels
+		virtual bool covers(const ofRectangle & screenBounds) const override;
+
+		//! a map isn't drawn as a mesh
+		virtual bool getMesh(WarpMesh & mesh) const override;
+
+	protected:
+		//! draw a specific area of a warped texture to a specific region
+		virtual void drawTexture(const ofTexture & texture, const ofRectangle & srcBounds, const ofRectangle & dstBounds) override;
+
+		//! screen points are located on the quad, then looked up in the map
+		virtual bool getLocatorMesh(WarpMesh & mesh) const override;
+		virtual bool resolveContentCoord(glm::vec2 & coord) const override;
+
+		virtual void setupShader() override;
+		//! upload the maps to their textures if they changed
+		void setupMapTextures();
+
+		//! check whether every pixel of the map has content, after it changed
+		void updateMapComplete();
+
+	protected:
+		//! coordinates owned by the warp
+		std::vector<glm::vec2> map;
+		//! memory mapped file the coordinates are read from instead, and its absolute path
+		std::shared_ptr<PfmFile> mapFile;
+		std::string mapPath;
+		//! first coordinate, with mapStride floats per pixel
+		const float * mapData;
+		size_t mapStride;
+		size_t mapWidth;
+		size_t mapHeight;
+		//! rows are stored from the bottom up, as in pfm files
+		bool mapBottomUp;
+		//! whether every pixel of the map has content
+		bool mapComplete;
+
+		ofFloatPixels blendMap;
+
+		ofTexture mapTexture;
+		ofTexture blendTexture;
+		bool mapTextureDirty;
+		bool blendTextureDirty;
+	};
+}
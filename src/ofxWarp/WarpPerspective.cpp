@@ -2,20 +2,15 @@
 
 #include "ofGraphics.h"
 
+#include "Geometry/Clip.h"
+
 namespace ofxWarp
 {
 	//--------------------------------------------------------------
 	WarpPerspective::WarpPerspective()
 		: WarpBase(TYPE_PERSPECTIVE)
 	{
-		this->srcPoints[0] = glm::vec2(0.0f, 0.0f);
-		this->srcPoints[1] = glm::vec2(this->width, 0.0f);
-		this->srcPoints[2] = glm::vec2(this->width, this->height);
-		this->srcPoints[3] = glm::vec2(0.0f, this->height);
-
 		this->reset();
-
-		this->shader.load(WarpBase::shaderPath / "WarpPerspective");
 	}
 
 	//--------------------------------------------------------------
@@ -27,37 +22,36 @@ namespace ofxWarp
 	{
 		// Calculate warp matrix.
 		if (this->dirty) {
-			// Update source size.
-			this->srcPoints[1].x = this->width;
-			this->srcPoints[2].x = this->width;
-			this->srcPoints[2].y = this->height;
-			this->srcPoints[3].y = this->height;
-
-			// Convert corners to actual destination pixels.
+			// Update source size and destination corners.
+			this->homography.setSourceSize(this->getSize());
+			this->homography.setDestinationSize(this->windowSize);
+			this->homography.setCorners(this->controlPoints.data());
 			for (int i = 0; i < 4; ++i)
 			{
+				// Convert corners to actual destination pixels.
 				this->dstPoints[i] = this->controlPoints[i] * this->windowSize;
 			}
 
-			// Calculate warp matrix.
-			this->transform = getPerspectiveTransform(this->srcPoints, this->dstPoints);
-			this->transformInverted = glm::inverse(this->transform);
-
 			this->dirty = false;
 		}
 
-		return this->transform;
+		return this->homography.getTransform();
 	}
 
 	//--------------------------------------------------------------
 	const glm::mat4 & WarpPerspective::getTransformInverted()
 	{
-		if (this->dirty)
-		{
-			this->getTransform();
-		}
+		this->getTransform();
+
+		return this->homography.getTransformInverted();
+	}
+
+	//--------------------------------------------------------------
+	const Homography & WarpPerspective::getHomography()
+	{
+		this->getTransform();
 
-		return this->transformInverted;
+		return this->homography;
 	}
 
 	//--------------------------------------------------------------
@@ -70,7 +64,7 @@ namespace ofxWarp
 		this->controlPoints.push_back(glm::vec2(1.0f, 1.0f) * scale + offset);
 		this->controlPoints.push_back(glm::vec2(0.0f, 1.0f) * scale + offset);
 
-		this->dirty = true;
+		this->markDirty();
 	}
 
 	//--------------------------------------------------------------
@@ -136,6 +130,7 @@ namespace ofxWarp
 				}
 
 				// Draw texture.
+				this->setupShader();
 				this->shader.begin();
 				{
 					this->shader.setUniformTexture("uTexture", texture, 1);
@@ -182,97 +177,33 @@ namespace ofxWarp
 	{
 		if (this->editing && this->selectedIndex < this->controlPoints.size())
 		{
-			// Draw control points.
+			// Queue control points.
 			for (auto i = 0; i < 4; ++i)
 			{
 				this->queueControlPoint(dstPoints[i], i == this->selectedIndex);
 			}
-
-			this->drawControlPoints();
 		}
 	}
 
 	//--------------------------------------------------------------
-	// Adapted from: http://forum.openframeworks.cc/t/quad-warping-homography-without-opencv/3121/19
-	glm::mat4 WarpPerspective::getPerspectiveTransform(const glm::vec2 src[4], const glm::vec2 dst[4]) const
+	bool WarpPerspective::isValidGrid(size_t numControlsX, size_t numControlsY) const
 	{
-		float p[8][9] = 
-		{
-			{ -src[0][0], -src[0][1], -1, 0, 0, 0, src[0][0] * dst[0][0], src[0][1] * dst[0][0], -dst[0][0] }, // h11
-			{ 0, 0, 0, -src[0][0], -src[0][1], -1, src[0][0] * dst[0][1], src[0][1] * dst[0][1], -dst[0][1] }, // h12
-			{ -src[1][0], -src[1][1], -1, 0, 0, 0, src[1][0] * dst[1][0], src[1][1] * dst[1][0], -dst[1][0] }, // h13
-			{ 0, 0, 0, -src[1][0], -src[1][1], -1, src[1][0] * dst[1][1], src[1][1] * dst[1][1], -dst[1][1] }, // h21
-			{ -src[2][0], -src[2][1], -1, 0, 0, 0, src[2][0] * dst[2][0], src[2][1] * dst[2][0], -dst[2][0] }, // h22
-			{ 0, 0, 0, -src[2][0], -src[2][1], -1, src[2][0] * dst[2][1], src[2][1] * dst[2][1], -dst[2][1] }, // h23
-			{ -src[3][0], -src[3][1], -1, 0, 0, 0, src[3][0] * dst[3][0], src[3][1] * dst[3][0], -dst[3][0] }, // h31
-			{ 0, 0, 0, -src[3][0], -src[3][1], -1, src[3][0] * dst[3][1], src[3][1] * dst[3][1], -dst[3][1] }, // h32
-		};
-
-		this->gaussianElimination(&p[0][0], 9);
-
-		return glm::mat4(p[0][8], p[3][8], 0, p[6][8], 
-						 p[1][8], p[4][8], 0, p[7][8], 
-						 0, 0, 1, 0, 
-						 p[2][8], p[5][8], 0, 1);
+		return (numControlsX == 2 && numControlsY == 2);
 	}
-	
+
 	//--------------------------------------------------------------
-	void WarpPerspective::gaussianElimination(float * input, int n) const
+	void WarpPerspective::setupShader()
 	{
-		auto i = 0;
-		auto j = 0;
-		auto m = n - 1;
-
-		while (i < m && j < n) 
+		if (!this->shader.isLoaded())
 		{
-			auto iMax = i;
-			for (auto k = i + 1; k < m; ++k)
-			{
-				if (fabs(input[k * n + j]) > fabs(input[iMax * n + j])) 
-				{
-					iMax = k;
-				}
-			}
-
-			if (input[iMax * n + j] != 0) 
-			{
-				if (i != iMax)
-				{
-					for (auto k = 0; k < n; ++k)
-					{
-						auto ikIn = input[i * n + k];
-						input[i * n + k] = input[iMax * n + k];
-						input[iMax * n + k] = ikIn;
-					}
-				}
-
-				float ijIn = input[i * n + j];
-				for (auto k = 0; k < n; ++k)
-				{
-					input[i * n + k] /= ijIn;
-				}
-
-				for (auto u = i + 1; u < m; ++u)
-				{
-					auto ujIn = input[u * n + j];
-					for (auto k = 0; k < n; ++k)
-					{
-						input[u * n + k] -= ujIn * input[i * n + k];
-					}
-				}
-
-				++i;
-			}
-			++j;
+			this->shader.load(WarpBase::shaderPath / "WarpPerspective");
 		}
+	}
 
-		for (auto i = m - 2; i >= 0; --i)
-		{
-			for (auto j = i + 1; j < n - 1; ++j)
-			{
-				input[i * n + m] -= input[i * n + j] * input[j * n + m];
-			}
-		}
+	//--------------------------------------------------------------
+	glm::mat4 WarpPerspective::getPerspectiveTransform(const glm::vec2 src[4], const glm::vec2 dst[4]) const
+	{
+		return Homography::solve(src, dst);
 	}
 
 	//--------------------------------------------------------------
@@ -282,7 +213,7 @@ namespace ofxWarp
 		std::swap(this->controlPoints[0], this->controlPoints[1]);
 		std::swap(this->controlPoints[1], this->controlPoints[2]);
 		this->selectedIndex = (this->selectedIndex + 3) % 4;
-		this->dirty = true; 
+		this->markDirty();
 	}
 
 	//--------------------------------------------------------------
@@ -292,7 +223,7 @@ namespace ofxWarp
 		std::swap(this->controlPoints[0], this->controlPoints[1]);
 		std::swap(this->controlPoints[3], this->controlPoints[0]);
 		this->selectedIndex = (this->selectedIndex + 1) % 4;
-		this->dirty = true;
+		this->markDirty();
 	}
 
 	//--------------------------------------------------------------
@@ -308,7 +239,7 @@ namespace ofxWarp
 		{
 			++this->selectedIndex;
 		}
-		this->dirty = true;
+		this->markDirty();
 	}
 
 	//--------------------------------------------------------------
@@ -317,6 +248,46 @@ namespace ofxWarp
 		std::swap(this->controlPoints[0], this->controlPoints[3]);
 		std::swap(this->controlPoints[1], this->controlPoints[2]);
 		this->selectedIndex = (this->controlPoints.size() - 1) - this->selectedIndex;
-		this->dirty = true;
+		this->markDirty();
+	}
+
+	//--------------------------------------------------------------
+	bool WarpPerspective::covers(const ofRectangle & screenBounds) const
+	{
+		// The control points go around the quad, starting at the top left.
+		const auto & points = this->getScreenControlPoints();
+		if (points.size() != 4) return false;
+
+		return quadContainsRect(points.data(), glm::vec4(screenBounds.x, screenBounds.y, screenBounds.width, screenBounds.height));
+	}
+
+	//--------------------------------------------------------------
+	bool WarpPerspective::getMesh(WarpMesh & mesh) const
+	{
+		// Solve the transform from the current control points, the cached one is only updated when the warp is drawn.
+		Homography homography;
+		homography.setSourceSize(this->getSize());
+		homography.setDestinationSize(this->windowSize);
+		homography.setCorners(this->controlPoints.data());
+
+		static const glm::vec2 unitSquare[4] =
+		{
+			{ 0.0f, 0.0f },
+			{ 1.0f, 0.0f },
+			{ 1.0f, 1.0f },
+			{ 0.0f, 1.0f }
+		};
+
+		// Keep w, so the quad is interpolated with perspective.
+		mesh.clear();
+		for (int i = 0; i < 4; ++i)
+		{
+			auto pt = unitSquare[i] * this->getSize();
+			mesh.positions.push_back(homography.getTransform() * glm::vec4(pt.x, pt.y, 0.0f, 1.0f));
+			mesh.texCoords.push_back(unitSquare[i]);
+		}
+		mesh.indices = { 0, 1, 2, 0, 2, 3 };
+
+		return true;
 	}
 }
\ No newline at end of file
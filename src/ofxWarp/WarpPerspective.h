@@ -1,6 +1,7 @@
 #pragma once
 
 #include "WarpBase.h"
+#include "Geometry/Homography.h"
 
 namespace ofxWarp
 {
@@ -14,6 +15,9 @@ namespace ofxWarp
 		const glm::mat4 & getTransform();
 		const glm::mat4 & getTransformInverted();
 
+		//! return the up-to-date perspective transform, for mapping points on the CPU
+		const Homography & getHomography();
+
 		//! reset control points to undistorted image
 		virtual void reset(const glm::vec2 & scale = glm::vec2(1.0f), const glm::vec2 & offset = glm::vec2(0.0f)) override;
 		//! setup the warp before drawing its contents
@@ -27,22 +31,29 @@ namespace ofxWarp
 		virtual void flipHorizontal() override;
 		virtual void flipVertical() override;
 
+		//! return whether the quad the warp draws to fully covers the specified area in pixels
+		virtual bool covers(const ofRectangle & screenBounds) const override;
+
+		//! fill the two triangles of the quad, with the perspective transform applied to the positions
+		virtual bool getMesh(WarpMesh & mesh) const override;
+
 	protected:
 		//! draw a specific area of a warped texture to a specific region
 		virtual void drawTexture(const ofTexture & texture, const ofRectangle & srcBounds, const ofRectangle & dstBounds) override;
 		//! draw the warp's controls interface
 		virtual void drawControls() override;
 
+		//! only the four corners are supported
+		virtual bool isValidGrid(size_t numControlsX, size_t numControlsY) const override;
+
+		virtual void setupShader() override;
+
 		glm::mat4 getPerspectiveTransform(const glm::vec2 src[4], const glm::vec2 dst[4]) const;
-		void gaussianElimination(float * input, int n) const;
 
 	protected:
-		glm::vec2 srcPoints[4];
+		Homography homography;
 		glm::vec2 dstPoints[4];
 
-		glm::mat4 transform;
-		glm::mat4 transformInverted;
-
 		ofShader shader;
 		ofVboMesh quadMesh;
 	};
@@ -7,11 +7,14 @@ namespace ofxWarp
 	//--------------------------------------------------------------
 	WarpPerspectiveBilinear::WarpPerspectiveBilinear(const ofFbo::Settings & fboSettings)
 		: WarpBilinear(fboSettings)
+		, perspectiveRevision(0)
+		, bakePerspective(false)
 	{
 		this->type = TYPE_PERSPECTIVE_BILINEAR;
 
-		// Create child WarpPerspective.
-		this->warpPerspective = std::make_shared<WarpPerspective>();
+		// The bilinear grid spans the whole window before the perspective transform is applied.
+		this->homography.setSourceSize(this->windowSize);
+		this->homography.setDestinationSize(this->windowSize);
 	}
 	
 	//--------------------------------------------------------------
@@ -19,51 +22,55 @@ namespace ofxWarp
 	{}
 
 	//--------------------------------------------------------------
-	void WarpPerspectiveBilinear::serialize(nlohmann::json & json)
+	void WarpPerspectiveBilinear::serialize(WarpData & data) const
 	{
-		WarpBilinear::serialize(json);
+		WarpBilinear::serialize(data);
 		
-		std::vector<std::string> corners;
+		data.corners.resize(4);
 		for (auto i = 0; i < 4; ++i)
 		{
-			const auto corner = this->warpPerspective->getControlPoint(i);
-			std::ostringstream oss;
-			oss << corner;
-			corners.push_back(oss.str());
+			data.corners[i] = this->homography.getCorner(i);
 		}
-		json["corners"] = corners;
 	}
 	
 	//--------------------------------------------------------------
-	void WarpPerspectiveBilinear::deserialize(const nlohmann::json & json)
+	void WarpPerspectiveBilinear::deserialize(const WarpData & data)
 	{
-		WarpBilinear::deserialize(json);
+		WarpBilinear::deserialize(data);
 
-		auto i = 0;
-		for (const auto & jsonPoint : json["corners"])
+		for (size_t i = 0; i < MIN(data.corners.size(), 4); ++i)
 		{
-			glm::vec2 corner;
-			std::istringstream iss;
-			iss.str(jsonPoint);
-			iss >> corner;
-			this->warpPerspective->setControlPoint(i, corner);
-
-			++i;
+			// Leave unchanged corners alone, so the perspective transform isn't recalculated needlessly.
+			if (this->homography.getCorner(i) != data.corners[i])
+			{
+				this->setCorner(i, data.corners[i]);
+			}
 		}
 	}
 
 	//--------------------------------------------------------------
-	void WarpPerspectiveBilinear::setEditing(bool editing)
+	const Homography & WarpPerspectiveBilinear::getHomography() const
+	{
+		return this->homography;
+	}
+
+	//--------------------------------------------------------------
+	void WarpPerspectiveBilinear::setBakePerspective(bool bakePerspective)
+	{
+		this->bakePerspective = bakePerspective;
+	}
+
+	//--------------------------------------------------------------
+	bool WarpPerspectiveBilinear::getBakePerspective() const
 	{
-		WarpBase::setEditing(editing);
-		this->warpPerspective->setEditing(this->editing);
+		return this->bakePerspective;
 	}
 
 	//--------------------------------------------------------------
 	void WarpPerspectiveBilinear::setSize(float width, float height)
 	{
 		// Make content size compatible with WarpBilinear's windowSize.
-		this->warpPerspective->setSize(this->windowSize);
+		this->homography.setSourceSize(this->windowSize);
 
 		WarpBilinear::setSize(width, height);
 	}
@@ -71,7 +78,10 @@ namespace ofxWarp
 	//--------------------------------------------------------------
 	void WarpPerspectiveBilinear::reset(const glm::vec2 & scale, const glm::vec2 & offset)
 	{
-		this->warpPerspective->reset(scale, offset);
+		this->setCorner(0, glm::vec2(0.0f, 0.0f) * scale + offset);
+		this->setCorner(1, glm::vec2(1.0f, 0.0f) * scale + offset);
+		this->setCorner(2, glm::vec2(1.0f, 1.0f) * scale + offset);
+		this->setCorner(3, glm::vec2(0.0f, 1.0f) * scale + offset);
 
 		WarpBilinear::reset();
 	}
@@ -83,18 +93,15 @@ namespace ofxWarp
 		if (this->isCorner(index)) 
 		{
 			// Perspective: simply return one of the corners.
-			return this->warpPerspective->getControlPoint(this->convertIndex(index));
+			return this->homography.getCorner(this->convertIndex(index));
 		}
 		else 
 		{
 			// Bilinear: transform control point from warped space to normalized screen space.
-			auto cp = WarpBase::getControlPoint(index) * this->warpPerspective->getSize();
-			auto pt = this->warpPerspective->getTransform() * glm::vec4(cp.x, cp.y, 0.0f, 1.0f);
+			auto cp = WarpBase::getControlPoint(index) * this->homography.getSourceSize();
+			auto pt = this->homography.map(cp);
 
-			if (pt.w != 0) pt.w = 1.0f / pt.w;
-			pt *= pt.w;
-
-			return glm::vec2(pt.x, pt.y) / this->windowSize;
+			return pt / this->windowSize;
 		}
 	}
 
@@ -105,18 +112,15 @@ namespace ofxWarp
 		if (this->isCorner(index)) 
 		{
 			// Perspective: simply set the control point.
-			this->warpPerspective->setControlPoint(this->convertIndex(index), pos);
+			this->setCorner(this->convertIndex(index), pos);
 		}
 		else 
 		{
 			// Bilinear:: transform control point from normalized screen space to warped space.
 			auto cp = pos * this->windowSize;
-			auto pt = this->warpPerspective->getTransformInverted() * glm::vec4(cp.x, cp.y, 0.0f, 1.0f);
-
-			if (pt.w != 0) pt.w = 1.0f / pt.w;
-			pt *= pt.w;
+			auto pt = this->homography.unmap(cp);
 
-			WarpBase::setControlPoint(index, glm::vec2(pt.x, pt.y) / this->warpPerspective->getSize());
+			WarpBase::setControlPoint(index, pt / this->homography.getSourceSize());
 		}
 	}
 
@@ -127,7 +131,8 @@ namespace ofxWarp
 		if (this->isCorner(index)) 
 		{
 			// Perspective: simply move the control point.
-			this->warpPerspective->moveControlPoint(this->convertIndex(index), shift);
+			auto corner = this->convertIndex(index);
+			this->setCorner(corner, this->homography.getCorner(corner) + shift);
 		}
 		else {
 			// Bilinear: transform control point from normalized screen space to warped space.
@@ -137,63 +142,119 @@ namespace ofxWarp
 	}
 
 	//--------------------------------------------------------------
-	void WarpPerspectiveBilinear::selectControlPoint(size_t index)
+	void WarpPerspectiveBilinear::getControlPoints(glm::vec2 * points, size_t numPoints) const
 	{
-		// Depending on index, select perspective or bilinear control point.
-		if (this->isCorner(index)) 
+		numPoints = MIN(numPoints, this->controlPoints.size());
+
+		// Bilinear: transform control points from warped space to normalized screen space.
+		const auto & transform = this->homography.getTransform();
+		auto scale = this->homography.getSourceSize();
+		auto invWindowSize = 1.0f / this->windowSize;
+		for (size_t i = 0; i < numPoints; ++i)
 		{
-			this->warpPerspective->selectControlPoint(this->convertIndex(index));
+			points[i] = Homography::transform(transform, this->controlPoints[i] * scale) * invWindowSize;
 		}
-		else 
+
+		// Perspective: simply return the corners.
+		for (size_t i = 0; i < 4; ++i)
 		{
-			this->warpPerspective->deselectControlPoint();
+			auto index = this->getCornerIndex(i);
+			if (index < numPoints)
+			{
+				points[index] = this->homography.getCorner(i);
+			}
 		}
+	}
 
-		// Always select bilinear control point, which we use to keep track of editing.
-		WarpBase::selectControlPoint(index);
+	//--------------------------------------------------------------
+	void WarpPerspectiveBilinear::setControlPoints(const glm::vec2 * points, size_t numPoints)
+	{
+		numPoints = MIN(numPoints, this->controlPoints.size());
+
+		std::vector<size_t> indices(numPoints);
+		for (size_t i = 0; i < numPoints; ++i)
+		{
+			indices[i] = i;
+		}
+		this->setControlPoints(indices.data(), points, numPoints);
 	}
 
 	//--------------------------------------------------------------
-	void WarpPerspectiveBilinear::deselectControlPoint()
+	void WarpPerspectiveBilinear::transformControlPoints(const size_t * indices, size_t numIndices, const glm::mat3 & transform)
 	{
-		this->warpPerspective->deselectControlPoint();
-		WarpBase::deselectControlPoint();
+		std::vector<glm::vec2> screenPoints(this->controlPoints.size());
+		this->getControlPoints(screenPoints.data(), screenPoints.size());
+
+		std::vector<size_t> validIndices;
+		std::vector<glm::vec2> points;
+		validIndices.reserve(numIndices);
+		points.reserve(numIndices);
+		for (size_t i = 0; i < numIndices; ++i)
+		{
+			if (indices[i] >= screenPoints.size()) continue;
+
+			validIndices.push_back(indices[i]);
+			points.push_back(glm::vec2(transform * glm::vec3(screenPoints[indices[i]], 1.0f)));
+		}
+
+		this->setControlPoints(validIndices.data(), points.data(), points.size());
 	}
 
 	//--------------------------------------------------------------
-	void WarpPerspectiveBilinear::rotateClockwise()
+	void WarpPerspectiveBilinear::setControlPoints(const size_t * indices, const glm::vec2 * points, size_t numPoints)
 	{
-		this->warpPerspective->rotateClockwise();
+		// Perspective: set the corners first, they define the transform for all other points.
+		for (size_t i = 0; i < numPoints; ++i)
+		{
+			if (this->isCorner(indices[i]))
+			{
+				this->setCorner(this->convertIndex(indices[i]), points[i]);
+			}
+		}
+
+		// Bilinear: transform control points from normalized screen space to warped space.
+		const auto & transform = this->homography.getTransformInverted();
+		auto invScale = 1.0f / this->homography.getSourceSize();
+		for (size_t i = 0; i < numPoints; ++i)
+		{
+			if (this->isCorner(indices[i])) continue;
+
+			this->controlPoints[indices[i]] = Homography::transform(transform, points[i] * this->windowSize) * invScale;
+		}
+		this->markDirty();
 	}
 
 	//--------------------------------------------------------------
-	void WarpPerspectiveBilinear::rotateCounterclockwise()
+	uint64_t WarpPerspectiveBilinear::getRevision() const
 	{
-		this->warpPerspective->rotateCounterclockwise();
+		// Both counters only ever increase, so the sum changes whenever either of them does.
+		return WarpBase::getRevision() + this->perspectiveRevision;
 	}
 
 	//--------------------------------------------------------------
-	bool WarpPerspectiveBilinear::handleCursorDown(const glm::vec2 & pos)
+	void WarpPerspectiveBilinear::rotateClockwise()
 	{
-		if (!this->editing || this->selectedIndex >= this->controlPoints.size()) return false;
+		this->rotateCorners(1);
+	}
 
-		// Depending on selected control point, let perspective or bilinear warp handle it.
-		if (this->isCorner(this->selectedIndex)) 
-		{
-			return this->warpPerspective->handleCursorDown(pos);
-		}
-		return WarpBase::handleCursorDown(pos);
+	//--------------------------------------------------------------
+	void WarpPerspectiveBilinear::rotateCounterclockwise()
+	{
+		this->rotateCorners(3);
 	}
-			
+
 	//--------------------------------------------------------------
 	bool WarpPerspectiveBilinear::handleCursorDrag(const glm::vec2 & pos)
 	{
 		if (!this->editing || this->selectedIndex >= this->controlPoints.size()) return false;
 
-		// Depending on selected control point, let perspective or bilinear warp handle it.
+		// Dragging a corner only changes the perspective transform, the bilinear mesh stays the same.
 		if (this->isCorner(this->selectedIndex))
 		{
-			return this->warpPerspective->handleCursorDrag(pos);
+			auto screenPoint = pos - this->selectedOffset;
+			this->setCorner(this->convertIndex(this->selectedIndex), screenPoint / this->windowSize);
+
+			return true;
 		}
 		return WarpBase::handleCursorDrag(pos);
 	}
@@ -202,21 +263,38 @@ namespace ofxWarp
 	bool WarpPerspectiveBilinear::handleWindowResize(int width, int height)
 	{
 		// Make content size compatible with WarpBilinear's windowSize.
-		this->warpPerspective->setSize(width, height);
+		this->homography.setSourceSize(glm::vec2(width, height));
+		this->homography.setDestinationSize(glm::vec2(width, height));
+		++this->perspectiveRevision;
 
-		auto handled = this->warpPerspective->handleWindowResize(width, height);
-		handled |= WarpBilinear::handleWindowResize(width, height);
+		return WarpBilinear::handleWindowResize(width, height);
+	}
 
-		return handled;
+	//--------------------------------------------------------------
+	bool WarpPerspectiveBilinear::getMesh(WarpMesh & mesh) const
+	{
+		// Always use the current corners, the baked mesh transform is only updated when the warp is drawn.
+		this->buildMesh(this->getGridEvaluator(true, this->homography.getTransform()), mesh);
+		return true;
 	}
 
 	//--------------------------------------------------------------
 	void WarpPerspectiveBilinear::drawTexture(const ofTexture & texture, const ofRectangle & srcBounds, const ofRectangle & dstBounds)
 	{
+		if (this->bakePerspective)
+		{
+			// Project the mesh positions instead, this only rebuilds the mesh if the corners moved.
+			this->setMeshTransform(this->homography.getTransform());
+			WarpBilinear::drawTexture(texture, srcBounds, dstBounds);
+			return;
+		}
+
+		this->clearMeshTransform();
+
 		ofPushMatrix();
 		{
 			// Apply Perspective transform.
-			ofMultMatrix(this->warpPerspective->getTransform());
+			ofMultMatrix(this->homography.getTransform());
 
 			// Draw Bilinear warp.
 			WarpBilinear::drawTexture(texture, srcBounds, dstBounds);
@@ -224,6 +302,25 @@ namespace ofxWarp
 		ofPopMatrix();
 	}
 
+	//--------------------------------------------------------------
+	void WarpPerspectiveBilinear::setCorner(size_t corner, const glm::vec2 & pos)
+	{
+		this->homography.setCorner(corner, pos);
+		++this->perspectiveRevision;
+	}
+
+	//--------------------------------------------------------------
+	void WarpPerspectiveBilinear::rotateCorners(size_t shift)
+	{
+		glm::vec2 corners[4];
+		for (size_t i = 0; i < 4; ++i)
+		{
+			corners[i] = this->homography.getCorner((i + shift) % 4);
+		}
+		this->homography.setCorners(corners);
+		++this->perspectiveRevision;
+	}
+
 	//--------------------------------------------------------------
 	bool WarpPerspectiveBilinear::isCorner(size_t index) const
 	{
@@ -232,6 +329,24 @@ namespace ofxWarp
 		return (index == 0 || index == (numControls - this->numControlsY) || index == (numControls - 1) || index == (this->numControlsY - 1));
 	}
 
+	//--------------------------------------------------------------
+	size_t WarpPerspectiveBilinear::getCornerIndex(size_t corner) const
+	{
+		auto numControls = (this->numControlsX * this->numControlsY);
+
+		switch (corner)
+		{
+		case 0:
+			return 0;
+		case 1:
+			return (this->numControlsY - 1);
+		case 2:
+			return (numControls - this->numControlsY);
+		default:
+			return (numControls - 1);
+		}
+	}
+
 	//--------------------------------------------------------------
 	size_t WarpPerspectiveBilinear::convertIndex(size_t index) const
 	{
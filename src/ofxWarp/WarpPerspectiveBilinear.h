@@ -1,7 +1,7 @@
 #pragma once
 
 #include "WarpBilinear.h"
-#include "WarpPerspective.h"
+#include "Geometry/Homography.h"
 
 namespace ofxWarp
 {
@@ -12,13 +12,24 @@ namespace ofxWarp
 		WarpPerspectiveBilinear(const ofFbo::Settings & fboSettings = ofFbo::Settings());
 		virtual ~WarpPerspectiveBilinear();
 
-		virtual void serialize(nlohmann::json & json) override;
-		virtual void deserialize(const nlohmann::json & json) override;
+		using WarpBase::serialize;
+		using WarpBase::deserialize;
+		using WarpBase::setControlPoints;
 
-		virtual void setEditing(bool editing) override;
+		virtual void serialize(WarpData & data) const override;
+		virtual void deserialize(const WarpData & data) override;
 
 		virtual void setSize(float width, float height) override;
 
+		//! return the perspective transform applied on top of the bilinear grid, for mapping points on the CPU
+		const Homography & getHomography() const;
+
+		//! set whether the perspective transform is baked into the mesh positions, instead of being applied to the matrix stack when drawing
+		//! the mesh is then in final screen space like a plain bilinear warp, but it has to be rebuilt whenever the corners move
+		void setBakePerspective(bool bakePerspective);
+		//! return whether the perspective transform is baked into the mesh positions
+		bool getBakePerspective() const;
+
 		//! reset control points to undistorted image
 		virtual void reset(const glm::vec2 & scale = glm::vec2(1.0f), const glm::vec2 & offset = glm::vec2(0.0f)) override;
 		
@@ -28,19 +39,27 @@ namespace ofxWarp
 		virtual void setControlPoint(size_t index, const glm::vec2 & pos) override;
 		//! move the specified control point
 		virtual void moveControlPoint(size_t index, const glm::vec2 & shift) override;
-		//! select one of the control points
-		virtual void selectControlPoint(size_t index) override;
-		//! deselect the selected control point
-		virtual void deselectControlPoint() override;
+		//! copy the coordinates of the first numPoints control points, using a single perspective transform
+		virtual void getControlPoints(glm::vec2 * points, size_t numPoints) const override;
+		//! set the coordinates of the first numPoints control points
+		//! the corners are set first, then the other points are converted with the resulting inverse transform
+		virtual void setControlPoints(const glm::vec2 * points, size_t numPoints) override;
+		//! apply an affine transform to the specified control points, in normalized screen coordinates
+		virtual void transformControlPoints(const size_t * indices, size_t numIndices, const glm::mat3 & transform) override;
+
+		//! return a counter that changes whenever the control points or the perspective corners change
+		virtual uint64_t getRevision() const override;
 
 		virtual void rotateClockwise() override;
 		virtual void rotateCounterclockwise() override;
 
-		virtual bool handleCursorDown(const glm::vec2 & pos) override;
 		virtual bool handleCursorDrag(const glm::vec2 & pos) override;
 
 		virtual bool handleWindowResize(int width, int height) override;
 
+		//! fill the mesh as it appears on screen, with the perspective transform applied to the positions
+		virtual bool getMesh(WarpMesh & mesh) const override;
+
 	protected:
 		//! draw a specific area of a warped texture to a specific region
 		virtual void drawTexture(const ofTexture & texture, const ofRectangle & srcBounds, const ofRectangle & dstBounds) override;
@@ -49,8 +68,23 @@ namespace ofxWarp
 		bool isCorner(size_t index) const;
 		//! convert the control point index to the appropriate perspective warp index
 		size_t convertIndex(size_t index) const;
+		//! convert a perspective warp index to the matching control point index
+		size_t getCornerIndex(size_t corner) const;
+
+		//! set the specified control points from normalized screen coordinates, corners first
+		void setControlPoints(const size_t * indices, const glm::vec2 * points, size_t numPoints);
+
+		//! set one of the perspective corners, in normalized screen coordinates
+		void setCorner(size_t corner, const glm::vec2 & pos);
+		//! shift the perspective corners around the quad, so that corner i takes the position of corner i + shift
+		void rotateCorners(size_t shift);
 
 	protected:
-		std::shared_ptr<WarpPerspective> warpPerspective;
+		//! perspective transform from the bilinear grid to the four corners, both scaled to the window
+		Homography homography;
+		//! counter that changes whenever the perspective transform does
+		uint64_t perspectiveRevision;
+
+		bool bakePerspective;
 	};
 }
\ No newline at end of file
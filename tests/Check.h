@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cmath>
+#include <iostream>
+
+//! Minimal assertions for the geometry tests, so they build with nothing but glm.
+//! Failed checks are printed and counted, and the test returns the count from main() through checkResult().
+namespace check
+{
+	inline int & getNumFailures()
+	{
+		static int numFailures = 0;
+		return numFailures;
+	}
+
+	inline void fail(const char * file, int line, const char * expression)
+	{
+		std::cerr << file << ":" << line << ": check failed: " << expression << std::endl;
+		++getNumFailures();
+	}
+
+	inline int checkResult()
+	{
+		if (getNumFailures() > 0)
+		{
+			std::cerr << getNumFailures() << " check(s) failed" << std::endl;
+		}
+		return (getNumFailures() > 0) ? 1 : 0;
+	}
+}
+
+#define CHECK(expression) \
+	do { if (!(expression)) check::fail(__FILE__, __LINE__, #expression); } while (false)
+
+#define CHECK_NEAR(a, b, tolerance) \
+	do { if (!(std::abs((a) - (b)) <= (tolerance))) check::fail(__FILE__, __LINE__, #a " == " #b " within " #tolerance); } while (false)
+
+#define CHECK_NEAR_VEC2(a, b, tolerance) \
+	do { CHECK_NEAR((a).x, (b).x, tolerance); CHECK_NEAR((a).y, (b).y, tolerance); } while (false)
@@ -0,0 +1,84 @@
+#include "Geometry/Clip.h"
+
+#include "Check.h"
+
+namespace
+{
+	//--------------------------------------------------------------
+	void testClipBoundsInside()
+	{
+		auto src = glm::vec4(0.0f, 0.0f, 100.0f, 50.0f);
+		auto dst = glm::vec4(10.0f, 10.0f, 100.0f, 50.0f);
+		CHECK(!ofxWarp::clipBounds(src, dst, glm::vec2(200.0f, 100.0f)));
+		CHECK(src == glm::vec4(0.0f, 0.0f, 100.0f, 50.0f));
+		CHECK(dst == glm::vec4(10.0f, 10.0f, 100.0f, 50.0f));
+	}
+
+	//--------------------------------------------------------------
+	void testClipBoundsLeftAndTop()
+	{
+		auto src = glm::vec4(0.0f, 0.0f, 100.0f, 100.0f);
+		auto dst = glm::vec4(-100.0f, -50.0f, 200.0f, 100.0f);
+		CHECK(ofxWarp::clipBounds(src, dst, glm::vec2(100.0f, 100.0f)));
+		CHECK_NEAR(dst.x, 0.0f, 1.0e-5f);
+		CHECK_NEAR(dst.y, 0.0f, 1.0e-5f);
+		CHECK_NEAR(dst.z, 100.0f, 1.0e-5f);
+		CHECK_NEAR(dst.w, 50.0f, 1.0e-5f);
+		CHECK(src.x > 0.0f);
+		CHECK(src.y > 0.0f);
+	}
+
+	//--------------------------------------------------------------
+	void testClipBoundsRightAndBottom()
+	{
+		auto src = glm::vec4(0.0f, 0.0f, 100.0f, 100.0f);
+		auto dst = glm::vec4(0.0f, 0.0f, 200.0f, 200.0f);
+		CHECK(ofxWarp::clipBounds(src, dst, glm::vec2(100.0f, 100.0f)));
+		CHECK(dst == glm::vec4(0.0f, 0.0f, 100.0f, 100.0f));
+		CHECK_NEAR(src.z, 50.0f, 1.0e-4f);
+		CHECK_NEAR(src.w, 50.0f, 1.0e-4f);
+	}
+
+	//--------------------------------------------------------------
+	void testQuadContainsRect()
+	{
+		const glm::vec2 square[4] = { { 0.0f, 0.0f }, { 100.0f, 0.0f }, { 100.0f, 100.0f }, { 0.0f, 100.0f } };
+		CHECK(ofxWarp::quadContainsRect(square, glm::vec4(10.0f, 10.0f, 50.0f, 50.0f)));
+		CHECK(ofxWarp::quadContainsRect(square, glm::vec4(0.0f, 0.0f, 100.0f, 100.0f)));
+		CHECK(!ofxWarp::quadContainsRect(square, glm::vec4(60.0f, 60.0f, 50.0f, 50.0f)));
+
+		// The winding doesn't matter.
+		const glm::vec2 reversed[4] = { square[3], square[2], square[1], square[0] };
+		CHECK(ofxWarp::quadContainsRect(reversed, glm::vec4(10.0f, 10.0f, 50.0f, 50.0f)));
+
+		// The rectangle corners are inside the bounds of this trapezoid, but not inside the quad.
+		const glm::vec2 trapezoid[4] = { { 40.0f, 0.0f }, { 60.0f, 0.0f }, { 100.0f, 100.0f }, { 0.0f, 100.0f } };
+		CHECK(!ofxWarp::quadContainsRect(trapezoid, glm::vec4(10.0f, 10.0f, 80.0f, 80.0f)));
+		CHECK(ofxWarp::quadContainsRect(trapezoid, glm::vec4(40.0f, 60.0f, 20.0f, 20.0f)));
+	}
+
+	//--------------------------------------------------------------
+	void testQuadContainsRectRejectsBadQuads()
+	{
+		const glm::vec2 concave[4] = { { 0.0f, 0.0f }, { 100.0f, 0.0f }, { 20.0f, 20.0f }, { 0.0f, 100.0f } };
+		CHECK(!ofxWarp::quadContainsRect(concave, glm::vec4(1.0f, 1.0f, 2.0f, 2.0f)));
+
+		const glm::vec2 bowtie[4] = { { 0.0f, 0.0f }, { 100.0f, 100.0f }, { 100.0f, 0.0f }, { 0.0f, 100.0f } };
+		CHECK(!ofxWarp::quadContainsRect(bowtie, glm::vec4(45.0f, 45.0f, 10.0f, 10.0f)));
+
+		const glm::vec2 degenerate[4] = { { 0.0f, 0.0f }, { 50.0f, 0.0f }, { 100.0f, 0.0f }, { 0.0f, 100.0f } };
+		CHECK(!ofxWarp::quadContainsRect(degenerate, glm::vec4(1.0f, 1.0f, 2.0f, 2.0f)));
+	}
+}
+
+//--------------------------------------------------------------
+int main()
+{
+	testClipBoundsInside();
+	testClipBoundsLeftAndTop();
+	testClipBoundsRightAndBottom();
+	testQuadContainsRect();
+	testQuadContainsRectRejectsBadQuads();
+
+	return check::checkResult();
+}
@@ -0,0 +1,296 @@
+#include "Geometry/ControlGrid.h"
+
+#include "glm/geometric.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+
+#include "Check.h"
+
+namespace
+{
+	//! Transcription of the parts of ofPolyline the warps used to resample their control points with.
+	class ReferencePolyline
+	{
+	public:
+		void lineTo(const glm::vec2 & pt)
+		{
+			this->curveVertices.clear();
+			this->points.push_back(pt);
+		}
+
+		void curveTo(const glm::vec2 & pt)
+		{
+			static const int curveResolution = 20;
+
+			this->curveVertices.push_back(pt);
+			if (this->curveVertices.size() == 4)
+			{
+				auto p0 = this->curveVertices[0];
+				auto p1 = this->curveVertices[1];
+				auto p2 = this->curveVertices[2];
+				auto p3 = this->curveVertices[3];
+				for (auto i = 0; i < curveResolution; ++i)
+				{
+					auto t = i / (float)(curveResolution - 1);
+					auto t2 = t * t;
+					auto t3 = t2 * t;
+					this->points.push_back(0.5f * ((2.0f * p1) + (-p0 + p2) * t + (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3) * t2 + (-p0 + 3.0f * p1 - 3.0f * p2 + p3) * t3));
+				}
+				this->curveVertices.pop_front();
+			}
+		}
+
+		glm::vec2 getPointAtPercent(float percent) const
+		{
+			std::vector<float> lengths(1, 0.0f);
+			for (size_t i = 1; i < this->points.size(); ++i)
+			{
+				lengths.push_back(lengths.back() + glm::distance(this->points[i - 1], this->points[i]));
+			}
+
+			// ofPolyline::getIndexAtLength() followed by getPointAtIndexInterpolated().
+			auto length = std::min(std::max(percent * lengths.back(), 0.0f), lengths.back());
+			for (size_t i = 0; i + 1 < lengths.size(); ++i)
+			{
+				if (lengths[i] <= length && lengths[i + 1] > length)
+				{
+					auto t = (length - lengths[i]) / (lengths[i + 1] - lengths[i]);
+					return glm::mix(this->points[i], this->points[i + 1], t);
+				}
+			}
+			return this->points.back();
+		}
+
+	protected:
+		std::vector<glm::vec2> points;
+		std::deque<glm::vec2> curveVertices;
+	};
+
+	//--------------------------------------------------------------
+	std::vector<glm::vec2> resampleReference(const ofxWarp::ControlGrid & grid, size_t n, bool alongX)
+	{
+		// Same loops as WarpBilinear::setNumControlsX() and setNumControlsY() used to run.
+		auto numLines = alongX ? grid.getNumControlsY() : grid.getNumControlsX();
+		auto numControls = (int)(alongX ? grid.getNumControlsX() : grid.getNumControlsY());
+		auto getPoint = [&](size_t line, int i)
+		{
+			return alongX ? grid.getPoint(i, (int)line) : grid.getPoint((int)line, i);
+		};
+
+		std::vector<glm::vec2> result(n * numLines);
+		for (size_t line = 0; line < numLines; ++line)
+		{
+			ReferencePolyline polyline;
+			for (auto i = 0; i < numControls; ++i)
+			{
+				auto p0 = getPoint(line, i - 1);
+				auto p1 = getPoint(line, i);
+				auto p2 = getPoint(line, i + 1);
+				auto p3 = getPoint(line, i + 2);
+
+				auto b1 = p1 + (p2 - p0) / 6.0f;
+				auto b2 = p2 - (p3 - p1) / 6.0f;
+
+				if (i == 0)
+				{
+					polyline.lineTo(p1);
+				}
+
+				polyline.curveTo(p1);
+
+				if (i < numControls - 1)
+				{
+					polyline.curveTo(b1);
+					polyline.curveTo(b2);
+				}
+				else
+				{
+					polyline.lineTo(p1);
+				}
+			}
+
+			auto step = 1.0f / (n - 1);
+			for (size_t i = 0; i < n; ++i)
+			{
+				auto idx = alongX ? (i * numLines + line) : (line * n + i);
+				result[idx] = polyline.getPointAtPercent(i * step);
+			}
+		}
+		return result;
+	}
+
+	//--------------------------------------------------------------
+	std::vector<glm::vec2> makeGrid(size_t numControlsX, size_t numControlsY)
+	{
+		// A regular grid with a bump in the middle, stored column-major like the warps do.
+		std::vector<glm::vec2> points;
+		for (size_t x = 0; x < numControlsX; ++x)
+		{
+			for (size_t y = 0; y < numControlsY; ++y)
+			{
+				auto pt = glm::vec2(x / (float)(numControlsX - 1), y / (float)(numControlsY - 1));
+				if (x == numControlsX / 2 && y == numControlsY / 2)
+				{
+					pt += glm::vec2(0.1f, -0.05f);
+				}
+				points.push_back(pt);
+			}
+		}
+		return points;
+	}
+
+	//--------------------------------------------------------------
+	void testGetPoint()
+	{
+		auto points = makeGrid(3, 3);
+		ofxWarp::ControlGrid grid(points, 3, 3);
+		CHECK(grid.getNumControlPoints() == 9);
+		CHECK(grid.getPoint(1, 2) == points[1 * 3 + 2]);
+
+		// Points beyond the edges are mirrored through the edge.
+		CHECK_NEAR_VEC2(grid.getPoint(-1, 0), 2.0f * points[0] - points[3], 1.0e-6f);
+		CHECK_NEAR_VEC2(grid.getPoint(0, 3), 2.0f * points[2] - points[1], 1.0e-6f);
+	}
+
+	//--------------------------------------------------------------
+	void testEvaluate()
+	{
+		auto points = makeGrid(3, 3);
+		ofxWarp::ControlGrid grid(points, 3, 3);
+
+		// Both interpolations pass through the control points.
+		for (auto linear : { true, false })
+		{
+			for (size_t x = 0; x < 3; ++x)
+			{
+				for (size_t y = 0; y < 3; ++y)
+				{
+					CHECK_NEAR_VEC2(grid.evaluate((float)x, (float)y, linear), points[x * 3 + y], 1.0e-6f);
+				}
+			}
+		}
+
+		auto expected = 0.25f * (points[0] + points[3] + points[1] + points[4]);
+		CHECK_NEAR_VEC2(grid.evaluate(0.5f, 0.5f, true), expected, 1.0e-6f);
+
+		// A regular grid is reproduced exactly by the cubic too.
+		auto regular = makeGrid(4, 4);
+		regular[2 * 4 + 2] -= glm::vec2(0.1f, -0.05f);
+		ofxWarp::ControlGrid regularGrid(regular, 4, 4);
+		CHECK_NEAR_VEC2(regularGrid.evaluate(0.25f, 1.75f, false), glm::vec2(0.25f / 3.0f, 1.75f / 3.0f), 1.0e-6f);
+	}
+
+	//--------------------------------------------------------------
+	void testEvaluateRange()
+	{
+		auto points = makeGrid(4, 3);
+		ofxWarp::ControlGrid grid(points, 4, 3);
+
+		static const int resolutionX = 7;
+		static const int resolutionY = 5;
+		std::vector<glm::vec3> whole(resolutionX * resolutionY);
+		std::vector<glm::vec3> split(resolutionX * resolutionY);
+		grid.evaluate(resolutionX, resolutionY, false, glm::vec2(640.0f, 480.0f), whole.data());
+		grid.evaluate(resolutionX, resolutionY, false, glm::vec2(640.0f, 480.0f), split.data(), 0, 3);
+		grid.evaluate(resolutionX, resolutionY, false, glm::vec2(640.0f, 480.0f), split.data(), 3);
+		CHECK(whole == split);
+		CHECK_NEAR(whole.back().x, 640.0f, 1.0e-3f);
+		CHECK_NEAR(whole.back().y, 480.0f, 1.0e-3f);
+	}
+
+	//--------------------------------------------------------------
+	void testResampleLinear()
+	{
+		auto points = makeGrid(3, 2);
+		ofxWarp::ControlGrid grid(points, 3, 2);
+
+		// Resampling to the same count keeps the points, except the bump which is respaced along the row.
+		auto resampled = grid.resampleX(3, true);
+		CHECK(resampled.size() == 6);
+		for (size_t i = 0; i < resampled.size(); ++i)
+		{
+			if (i == 3) continue;
+			CHECK_NEAR_VEC2(resampled[i], points[i], 1.0e-5f);
+		}
+
+		// Doubling the rows of a straight column places the new points halfway.
+		resampled = grid.resampleY(3, true);
+		CHECK(resampled.size() == 9);
+		CHECK_NEAR_VEC2(resampled[0], points[0], 1.0e-5f);
+		CHECK_NEAR_VEC2(resampled[1], 0.5f * (points[0] + points[1]), 1.0e-5f);
+		CHECK_NEAR_VEC2(resampled[2], points[1], 1.0e-5f);
+		CHECK_NEAR_VEC2(resampled[8], points[5], 1.0e-5f);
+
+		// The minimum is two points.
+		CHECK(grid.resampleX(1, true).size() == 2 * 2);
+	}
+
+	//--------------------------------------------------------------
+	void testResampleEndpoints()
+	{
+		auto points = makeGrid(5, 5);
+		ofxWarp::ControlGrid grid(points, 5, 5);
+
+		// The curved fit still starts and ends at the outer control points.
+		auto resampled = grid.resampleX(9, false);
+		CHECK(resampled.size() == 9 * 5);
+		for (size_t row = 0; row < 5; ++row)
+		{
+			CHECK_NEAR_VEC2(resampled[row], points[row], 1.0e-5f);
+			CHECK_NEAR_VEC2(resampled[8 * 5 + row], points[4 * 5 + row], 1.0e-5f);
+		}
+	}
+
+	//--------------------------------------------------------------
+	void testResampleMatchesPolyline()
+	{
+		// A warped grid with uneven spacing, so the arc length lookup matters.
+		static const size_t numControlsX = 4;
+		static const size_t numControlsY = 5;
+		std::vector<glm::vec2> points;
+		for (size_t x = 0; x < numControlsX; ++x)
+		{
+			for (size_t y = 0; y < numControlsY; ++y)
+			{
+				auto u = std::pow(x / (float)(numControlsX - 1), 1.5f);
+				auto v = y / (float)(numControlsY - 1);
+				points.push_back(glm::vec2(u + 0.1f * std::sin(v * 3.0f), v + 0.15f * std::sin(u * 4.0f + v)));
+			}
+		}
+		ofxWarp::ControlGrid grid(points, numControlsX, numControlsY);
+
+		for (auto n : { 2, 3, 4, 7, 12 })
+		{
+			auto resampledX = grid.resampleX(n, false);
+			auto expectedX = resampleReference(grid, n, true);
+			CHECK(resampledX.size() == expectedX.size());
+			for (size_t i = 0; i < resampledX.size(); ++i)
+			{
+				CHECK_NEAR_VEC2(resampledX[i], expectedX[i], 1.0e-5f);
+			}
+
+			auto resampledY = grid.resampleY(n, false);
+			auto expectedY = resampleReference(grid, n, false);
+			CHECK(resampledY.size() == expectedY.size());
+			for (size_t i = 0; i < resampledY.size(); ++i)
+			{
+				CHECK_NEAR_VEC2(resampledY[i], expectedY[i], 1.0e-5f);
+			}
+		}
+	}
+}
+
+//--------------------------------------------------------------
+int main()
+{
+	testGetPoint();
+	testEvaluate();
+	testEvaluateRange();
+	testResampleLinear();
+	testResampleEndpoints();
+	testResampleMatchesPolyline();
+
+	return check::checkResult();
+}
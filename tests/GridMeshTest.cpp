@@ -0,0 +1,81 @@
+#include "Geometry/GridMesh.h"
+
+#include <cstdint>
+#include <set>
+
+#include "Check.h"
+
+namespace
+{
+	//--------------------------------------------------------------
+	void testIndices()
+	{
+		static const int resolutionX = 4;
+		static const int resolutionY = 3;
+
+		std::vector<uint32_t> indices;
+		ofxWarp::GridMesh::getIndices(resolutionX, resolutionY, indices);
+		CHECK(indices.size() == 2 * 3 * (resolutionX - 1) * (resolutionY - 1));
+
+		// The first quad of the column-major grid is split along its diagonal.
+		CHECK(indices[0] == 0);
+		CHECK(indices[1] == resolutionY);
+		CHECK(indices[2] == resolutionY + 1);
+		CHECK(indices[3] == 0);
+		CHECK(indices[4] == resolutionY + 1);
+		CHECK(indices[5] == 1);
+
+		// Every vertex is used, none is out of range, and every triangle winds the same way.
+		std::set<uint32_t> used(indices.begin(), indices.end());
+		CHECK(used.size() == resolutionX * resolutionY);
+		CHECK(*used.rbegin() == resolutionX * resolutionY - 1);
+
+		auto position = [](uint32_t index)
+		{
+			return glm::vec2(index / resolutionY, index % resolutionY);
+		};
+		for (size_t i = 0; i < indices.size(); i += 3)
+		{
+			auto a = position(indices[i + 0]);
+			auto b = position(indices[i + 1]);
+			auto c = position(indices[i + 2]);
+			auto area = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+			CHECK_NEAR(area, 1.0f, 1.0e-6f);
+		}
+	}
+
+	//--------------------------------------------------------------
+	void testResolution()
+	{
+		// The number of vertices is rounded so that every patch gets the same number of quads.
+		auto resolution = ofxWarp::GridMesh::getResolution(5, 3, 10, 10);
+		CHECK((resolution.x - 1) % 4 == 0);
+		CHECK((resolution.y - 1) % 2 == 0);
+
+		// Grids coarser than the controls use one vertex per control.
+		resolution = ofxWarp::GridMesh::getResolution(8, 8, 4, 4);
+		CHECK(resolution == glm::ivec2(8, 8));
+	}
+
+	//--------------------------------------------------------------
+	void testTexCoords()
+	{
+		std::vector<glm::vec2> texCoords;
+		ofxWarp::GridMesh::getTexCoords(3, 2, glm::vec4(0.0f, 0.0f, 1.0f, 1.0f), texCoords);
+		CHECK(texCoords.size() == 6);
+		CHECK_NEAR_VEC2(texCoords[0], glm::vec2(0.0f, 0.0f), 1.0e-6f);
+		CHECK_NEAR_VEC2(texCoords[1], glm::vec2(0.0f, 1.0f), 1.0e-6f);
+		CHECK_NEAR_VEC2(texCoords[2], glm::vec2(0.5f, 0.0f), 1.0e-6f);
+		CHECK_NEAR_VEC2(texCoords[5], glm::vec2(1.0f, 1.0f), 1.0e-6f);
+	}
+}
+
+//--------------------------------------------------------------
+int main()
+{
+	testIndices();
+	testResolution();
+	testTexCoords();
+
+	return check::checkResult();
+}
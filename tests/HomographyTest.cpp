@@ -0,0 +1,92 @@
+#include "Geometry/Homography.h"
+
+#include "Check.h"
+
+namespace
+{
+	//--------------------------------------------------------------
+	void testSolve()
+	{
+		const glm::vec2 src[4] = { { 0.0f, 0.0f }, { 640.0f, 0.0f }, { 640.0f, 480.0f }, { 0.0f, 480.0f } };
+		const glm::vec2 dst[4] = { { 10.0f, 20.0f }, { 600.0f, 40.0f }, { 630.0f, 470.0f }, { 30.0f, 400.0f } };
+
+		auto matrix = ofxWarp::Homography::solve(src, dst);
+		for (auto i = 0; i < 4; ++i)
+		{
+			CHECK_NEAR_VEC2(ofxWarp::Homography::transform(matrix, src[i]), dst[i], 1.0e-2f);
+		}
+
+		// The identity quad solves to the identity.
+		auto identity = ofxWarp::Homography::solve(src, src);
+		CHECK_NEAR_VEC2(ofxWarp::Homography::transform(identity, glm::vec2(123.0f, 45.0f)), glm::vec2(123.0f, 45.0f), 1.0e-3f);
+	}
+
+	//--------------------------------------------------------------
+	void testMapUnmap()
+	{
+		ofxWarp::Homography homography;
+		homography.setSourceSize(glm::vec2(1920.0f, 1080.0f));
+		homography.setDestinationSize(glm::vec2(1280.0f, 720.0f));
+		homography.setCorner(0, glm::vec2(0.1f, 0.05f));
+		homography.setCorner(1, glm::vec2(0.95f, 0.0f));
+		homography.setCorner(2, glm::vec2(0.9f, 1.0f));
+		homography.setCorner(3, glm::vec2(0.0f, 0.8f));
+
+		// The source corners land on the scaled destination corners.
+		CHECK_NEAR_VEC2(homography.map(glm::vec2(0.0f, 0.0f)), glm::vec2(128.0f, 36.0f), 1.0e-2f);
+		CHECK_NEAR_VEC2(homography.map(glm::vec2(1920.0f, 1080.0f)), glm::vec2(1152.0f, 720.0f), 1.0e-2f);
+
+		for (auto pt : { glm::vec2(0.0f, 0.0f), glm::vec2(960.0f, 540.0f), glm::vec2(100.0f, 900.0f), glm::vec2(1900.0f, 20.0f) })
+		{
+			CHECK_NEAR_VEC2(homography.unmap(homography.map(pt)), pt, 1.0e-2f);
+		}
+	}
+
+	//--------------------------------------------------------------
+	void testInverse()
+	{
+		ofxWarp::Homography homography;
+		homography.setSourceSize(glm::vec2(800.0f, 600.0f));
+		homography.setDestinationSize(glm::vec2(800.0f, 600.0f));
+		homography.setCorner(1, glm::vec2(0.9f, 0.1f));
+		homography.setCorner(3, glm::vec2(0.05f, 0.95f));
+
+		auto product = homography.getTransformInverted() * homography.getTransform();
+		for (auto c = 0; c < 4; ++c)
+		{
+			for (auto r = 0; r < 4; ++r)
+			{
+				CHECK_NEAR(product[c][r], (c == r) ? 1.0f : 0.0f, 1.0e-4f);
+			}
+		}
+
+		// Changing a corner after reading the transform updates it.
+		auto before = homography.map(glm::vec2(800.0f, 0.0f));
+		homography.setCorner(1, glm::vec2(1.0f, 0.0f));
+		auto after = homography.map(glm::vec2(800.0f, 0.0f));
+		CHECK_NEAR_VEC2(before, glm::vec2(720.0f, 60.0f), 1.0e-2f);
+		CHECK_NEAR_VEC2(after, glm::vec2(800.0f, 0.0f), 1.0e-2f);
+
+		// Setting all corners at once matches setting them one by one.
+		const glm::vec2 corners[4] = { { 0.1f, 0.0f }, { 1.0f, 0.2f }, { 0.8f, 0.9f }, { 0.0f, 1.0f } };
+		ofxWarp::Homography other;
+		other.setSourceSize(glm::vec2(800.0f, 600.0f));
+		other.setDestinationSize(glm::vec2(800.0f, 600.0f));
+		other.setCorners(corners);
+		for (auto i = 0; i < 4; ++i)
+		{
+			homography.setCorner(i, corners[i]);
+		}
+		CHECK_NEAR_VEC2(other.map(glm::vec2(400.0f, 300.0f)), homography.map(glm::vec2(400.0f, 300.0f)), 1.0e-3f);
+	}
+}
+
+//--------------------------------------------------------------
+int main()
+{
+	testSolve();
+	testMapUnmap();
+	testInverse();
+
+	return check::checkResult();
+}
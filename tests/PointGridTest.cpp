@@ -0,0 +1,119 @@
+#include "Geometry/PointGrid.h"
+
+#include "glm/geometric.hpp"
+
+#include <limits>
+#include <random>
+
+#include "Check.h"
+
+namespace
+{
+	//--------------------------------------------------------------
+	size_t findClosestLinear(const std::vector<glm::vec2> & points, const glm::vec2 & pos, float * distance)
+	{
+		auto closest = std::numeric_limits<size_t>::max();
+		auto minDistance = std::numeric_limits<float>::max();
+		for (size_t i = 0; i < points.size(); ++i)
+		{
+			auto d = glm::distance(points[i], pos);
+			if (d < minDistance)
+			{
+				minDistance = d;
+				closest = i;
+			}
+		}
+		*distance = minDistance;
+		return closest;
+	}
+
+	//--------------------------------------------------------------
+	void checkAgainstLinearSearch(const std::vector<glm::vec2> & points, std::mt19937 & random)
+	{
+		ofxWarp::PointGrid grid;
+		grid.build(points.data(), points.size());
+		CHECK(grid.getNumPoints() == points.size());
+
+		// Query inside and well outside the bounds of the points.
+		std::uniform_real_distribution<float> query(-500.0f, 2500.0f);
+		for (auto i = 0; i < 2000; ++i)
+		{
+			auto pos = glm::vec2(query(random), query(random));
+
+			float expectedDistance, distance;
+			auto expected = findClosestLinear(points, pos, &expectedDistance);
+			auto closest = grid.findClosest(pos, &distance);
+			CHECK(closest == expected);
+			CHECK_NEAR(distance, expectedDistance, 1.0e-3f);
+		}
+	}
+
+	//--------------------------------------------------------------
+	void testRandomPoints()
+	{
+		std::mt19937 random(1234);
+		std::uniform_real_distribution<float> coord(0.0f, 2000.0f);
+
+		std::vector<glm::vec2> points(500);
+		for (auto & pt : points)
+		{
+			pt = glm::vec2(coord(random), coord(random));
+		}
+		checkAgainstLinearSearch(points, random);
+
+		// Clustered points leave most cells empty.
+		std::normal_distribution<float> cluster(1000.0f, 5.0f);
+		for (auto & pt : points)
+		{
+			pt = glm::vec2(cluster(random), cluster(random));
+		}
+		points.push_back(glm::vec2(0.0f, 2000.0f));
+		checkAgainstLinearSearch(points, random);
+	}
+
+	//--------------------------------------------------------------
+	void testDegenerateLayouts()
+	{
+		std::mt19937 random(5678);
+
+		// All points on a line, so the bounds have no area.
+		std::vector<glm::vec2> points;
+		for (auto i = 0; i < 50; ++i)
+		{
+			points.push_back(glm::vec2(i * 40.0f, 300.0f));
+		}
+		checkAgainstLinearSearch(points, random);
+
+		// Duplicate points resolve to the lowest index, like the linear search.
+		points.assign(10, glm::vec2(100.0f, 100.0f));
+		checkAgainstLinearSearch(points, random);
+
+		points.assign(1, glm::vec2(5.0f, 5.0f));
+		checkAgainstLinearSearch(points, random);
+	}
+
+	//--------------------------------------------------------------
+	void testEmpty()
+	{
+		ofxWarp::PointGrid grid;
+		float distance;
+		CHECK(grid.findClosest(glm::vec2(0.0f), &distance) == (size_t)-1);
+
+		const glm::vec2 pt(1.0f, 2.0f);
+		grid.build(&pt, 1);
+		CHECK(grid.findClosest(glm::vec2(0.0f), &distance) == 0);
+		grid.clear();
+		CHECK(grid.getNumPoints() == 0);
+		CHECK(grid.findClosest(glm::vec2(0.0f), &distance) == (size_t)-1);
+	}
+}
+
+//--------------------------------------------------------------
+int main()
+{
+	testRandomPoints();
+	testDegenerateLayouts();
+	testEmpty();
+
+	return check::checkResult();
+}
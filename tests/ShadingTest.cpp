@@ -0,0 +1,70 @@
+#include "Geometry/Shading.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "Check.h"
+
+namespace
+{
+	//--------------------------------------------------------------
+	std::vector<float> getColors(size_t numPixels)
+	{
+		std::vector<float> colors(numPixels * 4);
+		for (size_t i = 0; i < colors.size(); ++i)
+		{
+			colors[i] = (i % 7) * 0.2f - 0.1f;
+		}
+		return colors;
+	}
+
+	//--------------------------------------------------------------
+	void testShadePixels()
+	{
+		// An odd number of pixels also runs the scalar tail of the vectorized loop.
+		static const size_t numPixels = 13;
+
+		auto colors = getColors(numPixels);
+		std::vector<float> factors(numPixels * 4, 2.0f);
+		auto expected = colors;
+		ofxWarp::shadePixels(colors.data(), factors.data(), numPixels);
+		for (size_t i = 0; i < colors.size(); ++i)
+		{
+			CHECK_NEAR(colors[i], std::min(std::max(expected[i] * 2.0f, 0.0f), 1.0f), 1.0e-6f);
+		}
+	}
+
+	//--------------------------------------------------------------
+	void testBlendPixels(size_t numChannels)
+	{
+		static const size_t numPixels = 13;
+
+		auto colors = getColors(numPixels);
+		ofxWarp::shadePixels(colors.data(), std::vector<float>(numPixels * 4, 1.0f).data(), numPixels);
+
+		std::vector<float> destination(numPixels * numChannels, 0.25f);
+		CHECK(ofxWarp::blendPixels(colors.data(), destination.data(), numPixels, numChannels));
+		for (size_t x = 0; x < numPixels; ++x)
+		{
+			auto alpha = colors[x * 4 + 3];
+			for (size_t c = 0; c < numChannels; ++c)
+			{
+				CHECK_NEAR(destination[x * numChannels + c], colors[x * 4 + c] * alpha + 0.25f * (1.0f - alpha), 1.0e-6f);
+			}
+		}
+	}
+}
+
+//--------------------------------------------------------------
+int main()
+{
+	testShadePixels();
+	testBlendPixels(3);
+	testBlendPixels(4);
+
+	// Only 3 and 4 channels are supported.
+	float pixel[4] = {};
+	CHECK(!ofxWarp::blendPixels(pixel, pixel, 1, 2));
+
+	return check::checkResult();
+}
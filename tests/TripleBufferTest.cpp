@@ -0,0 +1,101 @@
+#include "TripleBuffer.h"
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+#include "Check.h"
+
+namespace
+{
+	//! Value that is only consistent if all of its fields were written by the same publish.
+	struct Frame
+	{
+		uint64_t sequence;
+		uint64_t values[16];
+	};
+
+	//--------------------------------------------------------------
+	void testSingleThread()
+	{
+		ofxWarp::TripleBuffer<int> buffer;
+		CHECK(!buffer.update());
+
+		buffer.getWriteBuffer() = 1;
+		buffer.publish();
+		buffer.getWriteBuffer() = 2;
+		buffer.publish();
+
+		// Only the latest value is picked up, and only once.
+		CHECK(buffer.update());
+		CHECK(buffer.getReadBuffer() == 2);
+		CHECK(!buffer.update());
+		CHECK(buffer.getReadBuffer() == 2);
+	}
+
+	//--------------------------------------------------------------
+	void testStress()
+	{
+		// One producer publishes as fast as it can while one consumer reads, run this under ThreadSanitizer
+		// (-DOFXWARP_SANITIZE_THREAD=ON) to check the buffer hands values over without data races.
+		static const uint64_t numFrames = 200000;
+
+		ofxWarp::TripleBuffer<Frame> buffer;
+		std::atomic<bool> done(false);
+
+		std::thread producer([&]
+		{
+			for (uint64_t sequence = 1; sequence <= numFrames; ++sequence)
+			{
+				auto & frame = buffer.getWriteBuffer();
+				frame.sequence = sequence;
+				for (auto & value : frame.values)
+				{
+					value = sequence;
+				}
+				buffer.publish();
+			}
+			done = true;
+		});
+
+		uint64_t lastSequence = 0;
+		size_t numTorn = 0;
+		size_t numBackwards = 0;
+		size_t numUpdates = 0;
+		while (true)
+		{
+			// Check done before updating, so the last frame is always picked up.
+			auto finished = done.load();
+			if (buffer.update())
+			{
+				++numUpdates;
+				const auto & frame = buffer.getReadBuffer();
+				for (auto value : frame.values)
+				{
+					if (value != frame.sequence) ++numTorn;
+				}
+				if (frame.sequence <= lastSequence) ++numBackwards;
+				lastSequence = frame.sequence;
+			}
+			else if (finished)
+			{
+				break;
+			}
+		}
+		producer.join();
+
+		CHECK(numTorn == 0);
+		CHECK(numBackwards == 0);
+		CHECK(numUpdates > 0);
+		CHECK(lastSequence == numFrames);
+	}
+}
+
+//--------------------------------------------------------------
+int main()
+{
+	testSingleThread();
+	testStress();
+
+	return check::checkResult();
+}
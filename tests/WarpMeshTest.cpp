@@ -0,0 +1,199 @@
+#include "Geometry/TriangleGrid.h"
+#include "Geometry/WarpMesh.h"
+
+#include "glm/geometric.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "Check.h"
+
+namespace
+{
+	//--------------------------------------------------------------
+	ofxWarp::WarpMesh getCrossingMesh()
+	{
+		// One triangle with a corner behind the viewer, whose visible part reaches to infinity down and to the right.
+		ofxWarp::WarpMesh mesh;
+		mesh.positions = { glm::vec4(10.0f, 10.0f, 0.0f, 1.0f), glm::vec4(50.0f, 10.0f, 0.0f, 1.0f), glm::vec4(10.0f, 50.0f, 0.0f, -1.0f) };
+		mesh.texCoords = { glm::vec2(0.0f, 0.0f), glm::vec2(1.0f, 0.0f), glm::vec2(0.0f, 1.0f) };
+		mesh.indices = { 0, 1, 2 };
+		return mesh;
+	}
+
+	//--------------------------------------------------------------
+	//! Solve for the homogeneous weights of the corners that project to a point, the point is drawn if they are all
+	//! positive, and the content coordinates are interpolated with the weights normalized.
+	bool getReference(const ofxWarp::WarpMesh & mesh, const glm::vec2 & pos, glm::vec2 & texCoord, float & margin)
+	{
+		auto c0 = glm::vec3(mesh.positions[0].x, mesh.positions[0].y, mesh.positions[0].w);
+		auto c1 = glm::vec3(mesh.positions[1].x, mesh.positions[1].y, mesh.positions[1].w);
+		auto c2 = glm::vec3(mesh.positions[2].x, mesh.positions[2].y, mesh.positions[2].w);
+		auto r = glm::vec3(pos.x, pos.y, 1.0f);
+
+		auto det = glm::dot(c0, glm::cross(c1, c2));
+		auto weights = glm::vec3(glm::dot(r, glm::cross(c1, c2)), glm::dot(c0, glm::cross(r, c2)), glm::dot(c0, glm::cross(c1, r))) / det;
+		auto sum = weights.x + weights.y + weights.z;
+
+		margin = std::min(weights.x, std::min(weights.y, weights.z)) / sum;
+		texCoord = (mesh.texCoords[0] * weights.x + mesh.texCoords[1] * weights.y + mesh.texCoords[2] * weights.z) / sum;
+		return (weights.x >= 0.0f && weights.y >= 0.0f && weights.z >= 0.0f);
+	}
+
+	//--------------------------------------------------------------
+	void testClipTriangle()
+	{
+		auto mesh = getCrossingMesh();
+
+		glm::vec4 positions[4];
+		glm::vec2 texCoords[4];
+		CHECK(mesh.clipTriangle(0, positions, texCoords) == 4);
+		CHECK(positions[0] == mesh.positions[0]);
+		CHECK(positions[1] == mesh.positions[1]);
+		CHECK_NEAR(positions[2].w, ofxWarp::WarpMesh::MIN_W, 1.0e-9f);
+		CHECK_NEAR(positions[3].w, ofxWarp::WarpMesh::MIN_W, 1.0e-9f);
+
+		// The added corners lie halfway along the edges, where w crosses zero.
+		CHECK_NEAR_VEC2(texCoords[2], glm::vec2(0.5f, 0.5f), 1.0e-4f);
+		CHECK_NEAR_VEC2(texCoords[3], glm::vec2(0.0f, 0.5f), 1.0e-4f);
+
+		// Triangles fully behind the viewer vanish, those fully in front are kept as they are.
+		for (auto & position : mesh.positions) position.w = -1.0f;
+		CHECK(mesh.clipTriangle(0, positions, texCoords) == 0);
+		for (auto & position : mesh.positions) position.w = 1.0f;
+		CHECK(mesh.clipTriangle(0, positions, texCoords) == 3);
+	}
+
+	//--------------------------------------------------------------
+	void testBakeMap()
+	{
+		static const size_t size = 96;
+
+		auto mesh = getCrossingMesh();
+		std::vector<glm::vec2> map(size * size, glm::vec2(-1.0f));
+		mesh.bakeMap(size, size, glm::vec2(size), map.data(), 0, size);
+
+		ofxWarp::TriangleGrid grid;
+		grid.build(mesh);
+		CHECK(grid.getNumTriangles() == 2);
+
+		// Pixels clearly inside or outside the visible part match the reference, edges may go either way.
+		size_t numInside = 0;
+		for (size_t y = 0; y < size; ++y)
+		{
+			for (size_t x = 0; x < size; ++x)
+			{
+				auto pos = glm::vec2(x + 0.5f, y + 0.5f);
+				glm::vec2 expected;
+				float margin;
+				auto inside = getReference(mesh, pos, expected, margin);
+				if (std::abs(margin) < 1.0e-3f) continue;
+
+				glm::vec2 found;
+				if (inside)
+				{
+					++numInside;
+					CHECK_NEAR_VEC2(map[y * size + x], expected, 1.0e-3f);
+					CHECK(grid.find(pos, found));
+					CHECK_NEAR_VEC2(found, expected, 1.0e-3f);
+				}
+				else
+				{
+					CHECK(map[y * size + x] == glm::vec2(-1.0f));
+					CHECK(!grid.find(pos, found));
+				}
+			}
+		}
+		CHECK(numInside > 1000);
+	}
+
+	//--------------------------------------------------------------
+	void testSharedEdges()
+	{
+		// A perspective quad split along its diagonal leaves no gaps, even with pixel centers on the diagonal.
+		static const size_t size = 64;
+
+		ofxWarp::WarpMesh mesh;
+		mesh.positions = { glm::vec4(-1.0f, -1.0f, 0.0f, 0.5f), glm::vec4(130.0f, -2.0f, 0.0f, 2.0f), glm::vec4(64.0f, 64.0f, 0.0f, 1.0f), glm::vec4(-2.0f, 66.0f, 0.0f, 1.0f) };
+		mesh.texCoords = { glm::vec2(0.0f, 0.0f), glm::vec2(1.0f, 0.0f), glm::vec2(1.0f, 1.0f), glm::vec2(0.0f, 1.0f) };
+		mesh.indices = { 0, 1, 2, 0, 2, 3 };
+
+		std::vector<glm::vec2> map(size * size, glm::vec2(-1.0f));
+		mesh.bakeMap(size, size, glm::vec2(size), map.data(), 0, size);
+		CHECK(std::none_of(map.begin(), map.end(), [](const glm::vec2 & coord) { return coord == glm::vec2(-1.0f); }));
+	}
+
+	//--------------------------------------------------------------
+	void testBands()
+	{
+		// A fan of thin triangles that overlap each other, baked band by band from their bins, matches the full bake.
+		static const size_t width = 80;
+		static const size_t height = 70;
+		static const size_t bandHeight = 8;
+
+		ofxWarp::WarpMesh mesh;
+		mesh.positions.push_back(glm::vec4(40.0f, 35.0f, 0.0f, 1.0f));
+		mesh.texCoords.push_back(glm::vec2(0.5f));
+		for (size_t i = 0; i <= 12; ++i)
+		{
+			auto angle = i * 0.6f;
+			mesh.positions.push_back(glm::vec4(40.0f + std::cos(angle) * 60.0f, 35.0f + std::sin(angle) * 30.0f, 0.0f, 1.0f + i * 0.1f));
+			mesh.texCoords.push_back(glm::vec2(i / 12.0f, 0.0f));
+		}
+		for (uint32_t i = 1; i <= 12; ++i)
+		{
+			mesh.indices.insert(mesh.indices.end(), { 0, i, i + 1 });
+		}
+
+		auto screenSize = glm::vec2(160.0f, 140.0f);
+		std::vector<glm::vec2> expected(width * height, glm::vec2(-1.0f));
+		mesh.bakeMap(width, height, screenSize, expected.data(), 0, height);
+
+		std::vector<uint32_t> bandStarts;
+		std::vector<uint32_t> bandTriangles;
+		mesh.getBands(width, height, screenSize, bandHeight, bandStarts, bandTriangles);
+		CHECK(bandStarts.size() == (height + bandHeight - 1) / bandHeight + 1);
+		CHECK(bandStarts.back() == bandTriangles.size());
+		CHECK(bandTriangles.size() < mesh.getNumTriangles() * (bandStarts.size() - 1));
+
+		std::vector<glm::vec2> map(width * height, glm::vec2(-1.0f));
+		for (size_t band = 0; band + 1 < bandStarts.size(); ++band)
+		{
+			auto begin = band * bandHeight;
+			CHECK(std::is_sorted(bandTriangles.begin() + bandStarts[band], bandTriangles.begin() + bandStarts[band + 1]));
+			mesh.bakeMap(width, height, screenSize, bandTriangles.data() + bandStarts[band], bandStarts[band + 1] - bandStarts[band], map.data() + (begin * width), begin, begin + bandHeight);
+		}
+		CHECK(map == expected);
+	}
+
+	//--------------------------------------------------------------
+	void testFindBeyondVertices()
+	{
+		// The grid only spans the vertices in front, points far beyond them are still found in its border cells.
+		auto mesh = getCrossingMesh();
+		ofxWarp::TriangleGrid grid;
+		grid.build(mesh);
+
+		auto pos = glm::vec2(1000.0f, 2000.0f);
+		glm::vec2 expected;
+		float margin;
+		CHECK(getReference(mesh, pos, expected, margin));
+
+		glm::vec2 found;
+		CHECK(grid.find(pos, found));
+		CHECK_NEAR_VEC2(found, expected, 1.0e-3f);
+		CHECK(!grid.find(glm::vec2(-1000.0f, 2000.0f), found));
+	}
+}
+
+//--------------------------------------------------------------
+int main()
+{
+	testClipTriangle();
+	testBakeMap();
+	testSharedEdges();
+	testBands();
+	testFindBeyondVertices();
+
+	return check::checkResult();
+}